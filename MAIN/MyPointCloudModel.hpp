@@ -10,6 +10,7 @@
 #include <string>
 #include <sstream>
 #include <Eigen\dense>
+#include <BGAL/PointCloudProcessing/IO/PointCloudIO.h>
 
 using namespace std;
 class MyPointCloudModel
@@ -35,48 +36,15 @@ public:
 
 void MyPointCloudModel::ReadXYZFile(const char* filename, bool WithNor)
 {
-	ifstream in(filename);
-	if (WithNor)
+	BGAL::_PointCloud_IO::read_(filename, m_verts, m_normals);
+	if (!WithNor)
 	{
-		Eigen::Vector3d Point, Normal;
-		while (in >> Point.x() >> Point.y() >> Point.z() >> Normal.x() >> Normal.y() >> Normal.z())
-		{
-			m_verts.push_back(Point);
-			m_normals.push_back(Normal);
-		}
-
-	}
-	else
-	{
-		Eigen::Vector3d Point;
-		while (in >> Point.x() >> Point.y() >> Point.z())
-		{
-			m_verts.push_back(Point);
-		}
+		m_normals.clear();
 	}
-	in.close();
-
 }
 void MyPointCloudModel::WriteXYZFile(const char* filename, bool WithNor) const
 {
-	ofstream out(filename);
-	if(WithNor)
-	{
-		int n = m_verts.size();
-		for (int i = 0; i < n; i++)
-		{
-			out << setiosflags(ios::fixed) << setprecision(9) << m_verts[i].transpose() <<" "<< m_normals[i].transpose() << endl;
-		}
-	}
-	else
-	{
-		int n = m_verts.size();
-		for (int i = 0; i < n; i++)
-		{
-			out << setiosflags(ios::fixed) << setprecision(9) << m_verts[i].transpose() << endl;
-		}
-	}
-	out.close();
+	BGAL::_PointCloud_IO::write_(filename, m_verts, WithNor ? m_normals : vector<Eigen::Vector3d>());
 }
 
 
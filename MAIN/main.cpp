@@ -5,6 +5,7 @@
 #include <random>
 #include <omp.h>
 #include <vector>
+#include <chrono>
 #include <BGAL/Optimization/LinearSystem/LinearSystem.h>
 #include <BGAL/Optimization/ALGLIB/optimization.h>
 #include <BGAL/Optimization/LBFGS/LBFGS.h>
@@ -19,6 +20,11 @@
 #include <BGAL/Tessellation3D/Tessellation3D.h>
 #include <BGAL/BaseShape/KDTree.h>
 #include <BGAL/PointCloudProcessing/Registration/ICP/ICP.h>
+#include <BGAL/PointCloudProcessing/FeatureDetection/FeatureDetection.h>
+#include <BGAL/PointCloudProcessing/FeatureProjection/FeatureProjection.h>
+#include <BGAL/PointCloudProcessing/Neighborhood/Neighborhood.h>
+#include <BGAL/PointCloudProcessing/Denoiser/Denoiser.h>
+#include <BGAL/PointCloudProcessing/IO/PointCloudIO.h>
 #include <BGAL/Reconstruction/MarchingTetrahedra/MarchingTetrahedra.h>
 #include <BGAL/Geodesic/Dijkstra/Dijkstra.h>
 #include <BGAL/CVTLike/CPD.h>
@@ -1559,67 +1565,16 @@ void CVTCPDTest(string modelName, std::vector<BGAL::_Point3> sites)
 	
 
 	auto Vs = RPD.get_sites_();
-	auto Edges = RPD.get_edges_();
-	set<pair<int, int>> RDT_Edges;
-	vector<set<int>> neibors;
-	neibors.resize(Vs.size());
-	for (int i = 0; i < Edges.size(); i++)
-	{
-		for (auto ee : Edges[i])
-		{
-			RDT_Edges.insert(make_pair(min(i, ee.first), max(i, ee.first)));
-			neibors[i].insert(ee.first);
-			neibors[ee.first].insert(i);
-			//cout << ee.first << endl;
-
-		}
-	}
+	const std::vector<int>& rdtFaces = RPD.get_rdt_faces_();
 	std::ofstream outRDT("..\\..\\data\\" + modelName + "RDT_v=" + to_string(num) + ".obj");
-
 	for (auto v : Vs)
 	{
 		outRDT << "v " << v << endl;
 	}
-	/*for (auto e : RDT_Edges)
-	{
-		outRDT << "l " << e.first+1 <<" "<< e.second+1  << endl;
-	}*/
-
-	set<MyFace> rdtFaces;
-
-	for (auto e : RDT_Edges)
-	{
-		for (int pid : neibors[e.first])
-		{
-			if (RDT_Edges.find(make_pair(min(pid, e.first), max(pid, e.first))) != RDT_Edges.end())
-			{
-				if (RDT_Edges.find(make_pair(min(pid, e.second), max(pid, e.second))) != RDT_Edges.end())
-				{
-					int f1 = pid, f2 = e.first, f3 = e.second;
-
-					int mid;
-					if (f1 != max(f1, max(f2, f3)) && f1 != min(f1, min(f2, f3)))
-					{
-						mid = f1;
-					}
-					if (f2 != max(f1, max(f2, f3)) && f2 != min(f1, min(f2, f3)))
-					{
-						mid = f2;
-					}
-					if (f3 != max(f1, max(f2, f3)) && f3 != min(f1, min(f2, f3)))
-					{
-						mid = f3;
-					}
-					rdtFaces.insert(MyFace(max(f1, max(f2, f3)), mid, min(f1, min(f2, f3))));
-				}
-			}
-		}
-	}
-	for (auto f : rdtFaces)
+	for (int f = 0; f < RPD.number_rdt_faces_(); ++f)
 	{
-		outRDT << "f " << f.p.x() + 1 << " " << f.p.y() + 1 << " " << f.p.z() + 1 << endl;
+		outRDT << "f " << rdtFaces[3 * f] + 1 << " " << rdtFaces[3 * f + 1] + 1 << " " << rdtFaces[3 * f + 2] + 1 << endl;
 	}
-
 	outRDT.close();
 	
 	
@@ -1658,6 +1613,7 @@ void CVT3DTest()
 {
 	string modelName = "bunny";
 	BGAL::_ManifoldModel model("..\\..\\data\\" + modelName + ".obj");
+	model.initialization_PQP_();
 	
 	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
 	{
@@ -1695,68 +1651,18 @@ void CVT3DTest()
 	
 	
 	auto Vs = RVD.get_sites_();
-	auto Edges = RVD.get_edges_();
-	set<pair<int, int>> RDT_Edges;
-	vector<set<int>> neibors;
-	neibors.resize(Vs.size());
-	for (int i = 0; i < Edges.size(); i++)
-	{
-		for (auto ee : Edges[i])
-		{
-			RDT_Edges.insert(make_pair(min(i, ee.first), max(i, ee.first)));
-			neibors[i].insert(ee.first);
-			neibors[ee.first].insert(i);
-			//cout << ee.first << endl;
-
-		}
-	}
+	const std::vector<int>& rdtFaces = RVD.get_rdt_faces_();
 	std::ofstream outRDT("..\\..\\data\\" + modelName + "RDT_v=" + to_string(num) + ".obj");
-
 	for (auto v : Vs)
 	{
 		outRDT << "v " << v << endl;
 	}
-	/*for (auto e : RDT_Edges)
-	{
-		outRDT << "l " << e.first+1 <<" "<< e.second+1  << endl;
-	}*/
-
-	set<MyFace> rdtFaces;
-
-	for (auto e : RDT_Edges)
+	for (int f = 0; f < RVD.number_rdt_faces_(); ++f)
 	{
-		for (int pid : neibors[e.first])
-		{
-			if (RDT_Edges.find(make_pair(min(pid, e.first), max(pid, e.first))) != RDT_Edges.end())
-			{
-				if (RDT_Edges.find(make_pair(min(pid, e.second), max(pid, e.second))) != RDT_Edges.end())
-				{
-					int f1 = pid, f2 = e.first, f3 = e.second;
-
-					int mid;
-					if (f1 != max(f1, max(f2, f3)) && f1 != min(f1, min(f2, f3)))
-					{
-						mid = f1;
-					}
-					if (f2 != max(f1, max(f2, f3)) && f2 != min(f1, min(f2, f3)))
-					{
-						mid = f2;
-					}
-					if (f3 != max(f1, max(f2, f3)) && f3 != min(f1, min(f2, f3)))
-					{
-						mid = f3;
-					}
-					rdtFaces.insert(MyFace(max(f1, max(f2, f3)), mid, min(f1, min(f2, f3))));
-				}
-			}
-		}
-	}
-	for (auto f : rdtFaces)
-	{
-		outRDT << "f " << f.p.x() + 1 << " " << f.p.y() + 1 << " " << f.p.z() + 1 << endl;
+		outRDT << "f " << rdtFaces[3 * f] + 1 << " " << rdtFaces[3 * f + 1] + 1 << " " << rdtFaces[3 * f + 2] + 1 << endl;
 	}
-
 	outRDT.close();
+	RVD.save_rdt_("..\\..\\data\\" + modelName + "RDT_v=" + to_string(num) + ".ply");
 
 
 
@@ -1864,67 +1770,16 @@ void CVT3DTest()
 
 
 	Vs = RVD_cap.get_sites_();
-	Edges = RVD_cap.get_edges_();
-	RDT_Edges.clear();
-	neibors.clear();
-	neibors.resize(Vs.size());
-	for (int i = 0; i < Edges.size(); i++)
-	{
-		for (auto ee : Edges[i])
-		{
-			RDT_Edges.insert(make_pair(min(i, ee.first), max(i, ee.first)));
-			neibors[i].insert(ee.first);
-			neibors[ee.first].insert(i);
-			//cout << ee.first << endl;
-
-		}
-	}
+	const std::vector<int>& capRdtFaces = RVD_cap.get_rdt_faces_();
 	outRDT.open("..\\..\\data\\" + modelName + "CapRDT_v=" + to_string(num) + ".obj");
-
 	for (auto v : Vs)
 	{
 		outRDT << "v " << v << endl;
 	}
-	/*for (auto e : RDT_Edges)
+	for (int f = 0; f < RVD_cap.number_rdt_faces_(); ++f)
 	{
-		outRDT << "l " << e.first+1 <<" "<< e.second+1  << endl;
-	}*/
-
-	rdtFaces.clear();
-
-	for (auto e : RDT_Edges)
-	{
-		for (int pid : neibors[e.first])
-		{
-			if (RDT_Edges.find(make_pair(min(pid, e.first), max(pid, e.first))) != RDT_Edges.end())
-			{
-				if (RDT_Edges.find(make_pair(min(pid, e.second), max(pid, e.second))) != RDT_Edges.end())
-				{
-					int f1 = pid, f2 = e.first, f3 = e.second;
-
-					int mid;
-					if (f1 != max(f1, max(f2, f3)) && f1 != min(f1, min(f2, f3)))
-					{
-						mid = f1;
-					}
-					if (f2 != max(f1, max(f2, f3)) && f2 != min(f1, min(f2, f3)))
-					{
-						mid = f2;
-					}
-					if (f3 != max(f1, max(f2, f3)) && f3 != min(f1, min(f2, f3)))
-					{
-						mid = f3;
-					}
-					rdtFaces.insert(MyFace(max(f1, max(f2, f3)), mid, min(f1, min(f2, f3))));
-				}
-			}
-		}
-	}
-	for (auto f : rdtFaces)
-	{
-		outRDT << "f " << f.p.x() + 1 << " " << f.p.y() + 1 << " " << f.p.z() + 1 << endl;
+		outRDT << "f " << capRdtFaces[3 * f] + 1 << " " << capRdtFaces[3 * f + 1] + 1 << " " << capRdtFaces[3 * f + 2] + 1 << endl;
 	}
-
 	outRDT.close();
 
 
@@ -1935,6 +1790,7 @@ void CapVT3DTest()
 	
 	string modelName = "bunny";
 	BGAL::_ManifoldModel model("..\\..\\data\\" + modelName + ".obj");
+	model.initialization_PQP_();
 
 	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
 	{
@@ -2028,67 +1884,16 @@ void CapVT3DTest()
 
 
 	auto Vs = RVD_cap.get_sites_();
-	auto Edges = RVD_cap.get_edges_();
-	set<pair<int, int>> RDT_Edges;
-	vector<set<int>> neibors;
-	neibors.resize(Vs.size());
-	for (int i = 0; i < Edges.size(); i++)
-	{
-		for (auto ee : Edges[i])
-		{
-			RDT_Edges.insert(make_pair(min(i, ee.first), max(i, ee.first)));
-			neibors[i].insert(ee.first);
-			neibors[ee.first].insert(i);
-			//cout << ee.first << endl;
-
-		}
-	}
+	const std::vector<int>& rdtFaces = RVD_cap.get_rdt_faces_();
 	std::ofstream outRDT("..\\..\\data\\" + modelName + "CapRDT_v=" + to_string(num) + ".obj");
-
 	for (auto v : Vs)
 	{
 		outRDT << "v " << v << endl;
 	}
-	/*for (auto e : RDT_Edges)
+	for (int f = 0; f < RVD_cap.number_rdt_faces_(); ++f)
 	{
-		outRDT << "l " << e.first+1 <<" "<< e.second+1  << endl;
-	}*/
-
-	set<MyFace> rdtFaces;
-
-	for (auto e : RDT_Edges)
-	{
-		for (int pid : neibors[e.first])
-		{
-			if (RDT_Edges.find(make_pair(min(pid, e.first), max(pid, e.first))) != RDT_Edges.end())
-			{
-				if (RDT_Edges.find(make_pair(min(pid, e.second), max(pid, e.second))) != RDT_Edges.end())
-				{
-					int f1 = pid, f2 = e.first, f3 = e.second;
-
-					int mid;
-					if (f1 != max(f1, max(f2, f3)) && f1 != min(f1, min(f2, f3)))
-					{
-						mid = f1;
-					}
-					if (f2 != max(f1, max(f2, f3)) && f2 != min(f1, min(f2, f3)))
-					{
-						mid = f2;
-					}
-					if (f3 != max(f1, max(f2, f3)) && f3 != min(f1, min(f2, f3)))
-					{
-						mid = f3;
-					}
-					rdtFaces.insert(MyFace(max(f1, max(f2, f3)), mid, min(f1, min(f2, f3))));
-				}
-			}
-		}
+		outRDT << "f " << rdtFaces[3 * f] + 1 << " " << rdtFaces[3 * f + 1] + 1 << " " << rdtFaces[3 * f + 2] + 1 << endl;
 	}
-	for (auto f : rdtFaces)
-	{
-		outRDT << "f " << f.p.x() + 1 << " " << f.p.y() + 1 << " " << f.p.z() + 1 << endl;
-	}
-
 	outRDT.close();
 
 
@@ -2169,6 +1974,22 @@ pair<double, double>  V3toV2(Eigen::Vector3d nor)
 
 
 
+// radis keeps its meaning, the global radius at which the densest point has its k nearest
+// points, found in steps of 0.001; the neighbourhoods are the points within radis and at
+// least the k nearest points
+std::function<double(const std::vector<double>&)> stepped_radius(double& radis)
+{
+	return [&radis](const std::vector<double>& radii)
+	{
+		const double densest = *min_element(radii.begin(), radii.end());
+		do
+		{
+			radis += 0.001;
+		} while (radis <= densest);
+		return radis;
+	};
+}
+
 void RFEPSTest(string model)
 {
 	clock_t start, end;
@@ -2189,15 +2010,7 @@ void RFEPSTest(string model)
 
 	//ifstream in("E:\\Dropbox\\MyProjects\\SIG-2022-Feature-preserving-recon\\data\\"+ outputFile +"\\" +model+"\\"+model+".xyz");
 	//ifstream in("E:\\Dropbox\\MyProjects\\SIG-2022-Feature-preserving-recon\\data\\" + outputFile + "\\" + model + "\\01_"+model+".xyz");
-	ifstream in("E:\\Dropbox\\MyProjects\\SIG-2022-Feature-preserving-recon\\data\\" + outputFile + "\\" + model + "\\DenoisePoints.xyz");
-
-	while (!in.eof())
-	{
-		Eigen::Vector3d p, n;
-		in >> p.x() >> p.y() >> p.z() >> n.x() >> n.y() >> n.z();
-		Vall.push_back(p);
-		Nall.push_back(n);
-	}
+	BGAL::_PointCloud_IO::read_("E:\\Dropbox\\MyProjects\\SIG-2022-Feature-preserving-recon\\data\\" + outputFile + "\\" + model + "\\DenoisePoints.xyz", Vall, Nall);
 	cout << "Read PointCloud. xyz File. \n";
 	int r = Vall.size();
 
@@ -2262,345 +2075,48 @@ void RFEPSTest(string model)
 	my_kd_tree_t   index(3 /*dim*/, cloud, KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
 	index.buildIndex();
 
-	do
 	{
-		radis += 0.001;
-		neighboor.clear();
-		mink = 99999; maxk = -99999;
-		for (int i = 0; i < r; i++)
-		{
-			vector<int> tmp;
-			neighboor.push_back(tmp);
-			double query_pt[3] = { Vall[i].x(), Vall[i].y(), Vall[i].z() };
-			const double search_radius = static_cast<double>((radis) * (radis));
-			std::vector<std::pair<uint32_t, double> >   ret_matches;
-			nanoflann::SearchParams params;
-			const size_t nMatches = index.radiusSearch(&query_pt[0], search_radius, ret_matches, params);
-			for (size_t j = 0; j < nMatches; j++)
-			{
-				neighboor[i].push_back(ret_matches[j].first);
-			}
-			maxk = max(maxk, int(nMatches));
-			mink = min(mink, int(nMatches));
-		}
-		mink = 99999; maxk = -99999;
-		auto neighboor_denoise = neighboor;
+		BGAL::_Neighborhood nbh;
+		nbh._parameter.k = rnnnum;
+		nbh._parameter.radius_rule = stepped_radius(radis);
+		nbh.build_(Vall);
+		neighboor.assign(r, vector<int>());
 		for (int i = 0; i < r; i++)
 		{
-			int k = neighboor[i].size();
-			neighboor_denoise[i].clear();
-			for (int j = 0; j < k; j++)
-			{
-				int pid = neighboor[i][j];
-				double dis = (Nall[i] - Nall[pid]).norm();
-				//if (dis < 1.5)
-				{
-					neighboor_denoise[i].push_back(pid);
-				}
-			}
-			maxk = max(maxk, int(neighboor_denoise[i].size()));
-			mink = min(mink, int(neighboor_denoise[i].size()));
+			neighboor[i].assign(nbh.neighbors_(i), nbh.neighbors_(i) + nbh.number_neighbors_(i));
 		}
-		neighboor = neighboor_denoise;
-		
-		cout << "maxk: " << maxk << "   mink:" << mink << endl;
-	}  while (maxk < rnnnum );
+		maxk = nbh.max_neighbors_();
+		mink = nbh.min_neighbors_();
+		cout << "maxk: " << maxk << "   mink:" << mink << "   meank: " << nbh.mean_neighbors_() << "   radius: " << radis << endl;
+	}
 
 	// add par later
 
 	start = clock();
 
-	map<int, double> R2, R3, S;
-	for (int iter = 0; iter < r; iter++)
+	// part 1: balanced two-normal clustering of every neighbourhood
+	std::vector<double> R2(r, 0.0), R3(r, 0.0), S(r, 0.0);
 	{
-		R2[iter] = 0.0; R3[iter] = 0; S[iter] = 0;
-	}
-
-	int omp_cnt = 0;
-	omp_set_num_threads(24);
-#pragma omp parallel for schedule(dynamic, 20)  //part 1
-	for (int iter = 0; iter < r; iter++) // part 1
-	{
-
-		omp_cnt++;
-		std::function<void(const alglib::real_1d_array& x, double& func, alglib::real_1d_array& grad, void* ptr)> fop_lambda
-			= [&](const alglib::real_1d_array& x, double& func, alglib::real_1d_array& grad, void* ptr) -> void
-		{
-			int k = neighboor[iter].size();
-			int r = Vall.size();
-			vector<double > w;
-			for (int i = 0; i < k; i++)
-			{
-				w.push_back(0);
-			}
-			double maxw = -99999999.0;
-			for (int i = 0; i < k; i++)
-			{
-				double dis = (Vall[iter] - Vall[neighboor[iter][i]]).norm();
-				if (dis < 0.0001)
-				{
-					w[i] = 0.0;
-				}
-				else
-				{
-					w[i] = 1.0 / (dis * dis);
-					maxw = max(maxw, w[i]);
-				}
-			}
-			for (int i = 0; i < k; i++)
-			{
-				w[i] = 1.0;
-				//w[i] = w[i] / maxw;
-			}
-
-			double u1 = x[k], v1 = x[k + 1], u2 = x[k + 2], v2 = x[k + 3];
-			Eigen::Vector3d n1(sin(u1) * cos(v1), sin(u1) * sin(v1), cos(u1));
-			Eigen::Vector3d n2(sin(u2) * cos(v2), sin(u2) * sin(v2), cos(u2));
-			n1.normalize();
-			n2.normalize();
-			func = 0;
-			for (int i = 0; i < k; i++)
-			{
-				auto Nj = Nall[neighboor[iter][i]];
-				func += x[i] * w[i] * (pow((Nj.x() - sin(u1) * cos(v1)), 2) + pow(Nj.y() - sin(u1) * sin(v1), 2) + pow(Nj.z() - cos(u1), 2))
-					+ (1.0 - x[i]) * w[i] * (pow((Nj.x() - sin(u2) * cos(v2)), 2) + pow(Nj.y() - sin(u2) * sin(v2), 2) + pow(Nj.z() - cos(u2), 2));
-				//func += x[i] * w[i] * (Nall[neighboor[iter][i]] - n1).squaredNorm()  + (1 - x[i]) * w[i] * (Nall[neighboor[iter][i]] - n2).squaredNorm();
-			}
-
-			for (int i = 0; i < k; i++)
-			{
-				//double a = abs(cos(x[k]))* abs(cos(x[k]));
-				auto Nj = Nall[neighboor[iter][i]];
-				grad[i] = w[i] * (pow((Nj.x() - sin(u1) * cos(v1)), 2) + pow(Nj.y() - sin(u1) * sin(v1), 2) + pow(Nj.z() - cos(u1), 2))
-					- w[i] * (pow((Nj.x() - sin(u2) * cos(v2)), 2) + pow(Nj.y() - sin(u2) * sin(v2), 2) + pow(Nj.z() - cos(u2), 2));
-			}
-
-			grad[k] = 0; grad[k + 1] = 0; grad[k + 2] = 0; grad[k + 3] = 0;
-
-			for (int i = 0; i < k; i++)
-			{
-				auto Nj = Nall[neighboor[iter][i]];
-				grad[k] += 2 * x[i] * sin(u1) * w[i] * (Nj.z() - cos(u1))
-					- (2 * x[i] * cos(v1) * cos(u1) * w[i] * (Nj.x() - sin(u1) * cos(v1))
-						+ 2 * x[i] * cos(u1) * w[i] * sin(v1) * (Nj.y() - sin(u1) * sin(v1)));
-
-				grad[k + 1] += 2 * x[i] * sin(u1) * sin(v1) * w[i] * (Nj.x() - sin(u1) * cos(v1))
-					- 2 * x[i] * sin(u1) * cos(v1) * w[i] * (Nj.y() - sin(u1) * sin(v1));
-
-				grad[k + 2] += 2 * w[i] * sin(u2) * (1 - x[i]) * (Nj.z() - cos(u2))
-					- (2 * w[i] * cos(u2) * cos(v2) * (1 - x[i]) * (Nj.x() - sin(u2) * cos(v2))
-						+ 2 * w[i] * cos(u2) * sin(v2) * (1 - x[i]) * (Nj.y() - sin(u2) * sin(v2)));
-
-				grad[k + 3] += 2 * sin(u2) * sin(v2) * (1 - x[i]) * w[i] * (Nj.x() - sin(u2) * cos(v2))
-					- 2 * sin(u2) * cos(v2) * (1 - x[i]) * w[i] * (Nj.y() - sin(u2) * sin(v2));
-			}
-		};
-
-
-		if (omp_cnt % 10000 == 0)
-		{
-			cout << "Part 1 --- Point iter: " << omp_cnt << " \n";
-		}
-
-
-		int k = neighboor[iter].size();
-		if (k < 5)
-		{
-			continue;
-		}
-		// kmeans
-
-		clusterizerstate s;
-		kmeansreport rep;
-		//real_2d_array xy = "[[1,1],[1,2],[4,1],[2,3],[4,1.5]]";
-		real_2d_array xy;
-		xy.setlength(k, 3);
-		for (int i = 0; i < k; i++)
-		{
-			xy[i][0] = Nall[neighboor[iter][i]].x();
-			xy[i][1] = Nall[neighboor[iter][i]].y();
-			xy[i][2] = Nall[neighboor[iter][i]].z();
-			if (debugOutput)
-				cout << xy[i][0] << " " << xy[i][1] << " " << xy[i][2] << endl;
-		}
-
-		alglib::clusterizercreate(s);
-		alglib::clusterizersetpoints(s, xy, 2);
-		alglib::clusterizersetkmeanslimits(s, 10, 0);
-		alglib::clusterizerrunkmeans(s, 2, rep);// ?
-		if (debugOutput)
-			printf("%d\n", int(rep.terminationtype)); // EXPECTED: 1
-		Eigen::Vector3d C1, C2;
-		if (int(rep.terminationtype) == -3)
-		{
-			C1 = Nall[neighboor[iter][0]];
-			C2 = Nall[neighboor[iter][0]];
-			//ʵֱӽ
-		}
-		else
-		{
-			C1.x() = rep.c[0][0];
-			C1.y() = rep.c[0][1];
-			C1.z() = rep.c[0][2];
-			C2.x() = rep.c[1][0];
-			C2.y() = rep.c[1][1];
-			C2.z() = rep.c[1][2];
-
-		}
-		if (debugOutput)
-		{
-			cout << rep.c[0][0] << " " << rep.c[0][1] << " " << rep.c[0][2] << endl;
-			cout << rep.c[1][0] << " " << rep.c[1][1] << " " << rep.c[1][2] << endl;
-		}
-
-
-		real_1d_array x0;
-		x0.setlength(k + 4);
-		real_1d_array s0;
-		s0.setlength(k + 4);
-		for (int i = 0; i < k; i++)
-		{
-			x0[i] = 0.5;
-			s0[i] = 1;
-		}
-		for (int i = k; i < k + 4; i++)
-		{
-			x0[i] = 0;
-			s0[i] = 1;
-		}
-
-		C2.normalize();
-		C1.normalize();
-
-		auto Q = V3toV2(C1);
-		x0[k] = Q.first;
-		x0[k + 1] = Q.second;
-		Q = V3toV2(C2);
-		x0[k + 2] = Q.first;
-		x0[k + 3] = Q.second;
-		//kmeans[iter] = make_pair(make_pair(x0[k], x0[k + 1]), make_pair(x0[k + 2], x0[k + 3]));
-
-		real_1d_array bndl;
-		real_1d_array bndu;
-		bndl.setlength(k + 4);
-		bndu.setlength(k + 4);
-
-		real_2d_array c;
-		c.setlength(1, neighboor[iter].size() + 5);
-		integer_1d_array ct = "[0]";
-		for (int i = 0; i < k; i++)
-		{
-			bndl[i] = 0;
-			bndu[i] = 1;
-			c[0][i] = 1;
-		}
-		for (int i = k; i < k + 4; i++)
-		{
-			bndl[i] = -99999999999;
-			bndu[i] = 99999999999;
-			c[0][i] = 0;
-		}
-		c[0][k + 4] = double(k) / 2.0;
-		minbleicstate state;
-		double epsg = 0;
-		double epsf = 0;
-		double epsx = 0;
-		ae_int_t maxits = 0.000001;
-		alglib::minbleiccreate(x0, state);
-		alglib::minbleicsetlc(state, c, ct);
-		alglib::minbleicsetbc(state, bndl, bndu);
-		alglib::minbleicsetscale(state, s0);
-		alglib::minbleicsetcond(state, epsg, epsf, epsx, maxits);
-
-		alglib::minbleicoptguardsmoothness(state);
-		alglib::minbleicoptguardgradient(state, 0.0001);
-
-		if (debugOutput)
-		{
-			for (int i = 0; i < k + 4; i++)
-			{
-				cout << x0[i] << " ";
-			}cout << endl;
-		}
-
-
-
-		minbleicreport rep2;
-		//minbleicoptimize(state, fop, nullptr, nullptr, alglib::parallel);
-		if (1)
-		{
-			alglib::minbleicoptimize(state, fop_lambda);
-			alglib::minbleicresults(state, x0, rep2);
-			//cout << rep2.debugff << endl;
-			double mn = 0;
-			real_1d_array G_tmp;
-			G_tmp.setlength(k + 4);
-			fop_lambda(x0, mn, G_tmp, nullptr);
-			if (debugOutput)
-				cout << mn << endl;
-			if (debugOutput)
-			{
-				printf("%d\n", int(rep2.terminationtype)); // EXPECTED: 4
-				printf("%s\n", x0.tostring(2).c_str()); // EXPECTED: [2,4]
-
-				optguardreport ogrep;
-				minbleicoptguardresults(state, ogrep);
-				printf("%s\n", ogrep.badgradsuspected ? "true" : "false"); // EXPECTED: false
-				printf("%s\n", ogrep.nonc0suspected ? "true" : "false"); // EXPECTED: false
-				printf("%s\n", ogrep.nonc1suspected ? "true" : "false"); // EXPECTED: false
-			}
-		}
-		
-		
-		
-
-
-		double u1 = x0[k], v1 = x0[k + 1], u2 = x0[k + 2], v2 = x0[k + 3];
-		Eigen::Vector3d n1(sin(u1) * cos(v1), sin(u1) * sin(v1), cos(u1));
-		Eigen::Vector3d n2(sin(u2) * cos(v2), sin(u2) * sin(v2), cos(u2));
-		/*n1.normalize();
-		n2.normalize();*/
-		if (debugOutput)
-		{
-			cout << n1 << endl;
-			cout << n2 << endl;
-		}
-		//n1 = C1;
-		//n2 = C2;
-
-		double dis = sqrt((n1.x() - n2.x()) * (n1.x() - n2.x()) + (n1.y() - n2.y()) * (n1.y() - n2.y()) + (n1.z() - n2.z()) * (n1.z() - n2.z()));
-		if (debugOutput)
-			cout << "dis " << dis << endl;
-
-		//compute angle between n1 n2
-		double angle = acos(n1.dot(n2));
-		// angel to drgee
-		angle = angle * 180 / 3.1415926535;
-		if (debugOutput)
-			cout << "angle " << angle << endl;
-		//if (angle > 60&&angle <120)
-		//{
-		//	R3[iter] = 1; // normal point
-		//}
-		//else
-		//{
-		//	R3[iter] = 0; 
-		//}
-		//
-		if (dis < 30 / 100.0) // importent
+		std::vector<int> offsets(r + 1, 0), indices;
+		for (int i = 0; i < r; i++)
 		{
-			R3[iter] = 1; // normal point
+			offsets[i + 1] = offsets[i] + neighboor[i].size();
 		}
-		else
+		indices.reserve(offsets[r]);
+		for (int i = 0; i < r; i++)
 		{
-			R3[iter] = 0;
+			indices.insert(indices.end(), neighboor[i].begin(), neighboor[i].end());
 		}
-		//if (mn < 0.25)
+		BGAL::_Feature_Detection detector;
+		detector.detect_(Nall, offsets, indices);
+		for (int iter = 0; iter < r; iter++)
 		{
-			R2[iter] = 1;
+			R2[iter] = detector.get_is_valid_()[iter];
+			R3[iter] = detector.get_is_smooth_()[iter]; // 1: normal point
 		}
 	}
 
+	int omp_cnt = 0;
 	end = clock();
 	double endtime = (double)(end - start) / CLOCKS_PER_SEC;
 	cout << "T2 Running Time: " << endtime << endl;
@@ -3447,130 +2963,39 @@ void RFEPSTest(string model)
 	start = clock();
 	//debugOutput = 1;
 	map<int, Eigen::Vector3d> NewPoints;
-//#pragma omp parallel for schedule(dynamic, 20) //part 3
 	cout << "Begin Part3 feature points...\n";
-	for (int iter = 0; iter < r; iter++)
 	{
-		if (flag3[iter])
-		{
-			continue;
-		}
-		int k = neighboor[iter].size();
-		if (k < 5)
+		vector<int> offsets(r + 1, 0), indices, candidates(r, 0);
+		vector<Eigen::Vector3d> Nvec(r);
+		for (int i = 0; i < r; i++)
 		{
-			continue;
+			offsets[i + 1] = offsets[i] + neighboor[i].size();
+			indices.insert(indices.end(), neighboor[i].begin(), neighboor[i].end());
+			Nvec[i] = Nall_new[i];
+			candidates[i] = (!flag3[i] && neighboor[i].size() >= 5) ? 1 : 0;
 		}
-	
-
-
-		omp_cnt++;
-
-		if (omp_cnt % 1000 == 0)
-			cout << "Part 3 --- Point iter: " << omp_cnt << " \n";
-
-		real_1d_array x0;
-		x0.setlength(3);
-		x0[0] = Vall[iter].x();
-		x0[1] = Vall[iter].y();
-		x0[2] = Vall[iter].z();
-		real_1d_array s0 = "[1,1,1]";
-
-
-
-		std::function<void(const alglib::real_1d_array& x, double& func, alglib::real_1d_array& grad, void* ptr)> fop_z_lambda
-			= [&](const alglib::real_1d_array& x, double& func, alglib::real_1d_array& grad, void* ptr) -> void
+		BGAL::_Feature_Projection projector;
+		projector._parameter.mu = 0.01;
+		projector._parameter.min_displacement = 0.0001;
+		projector.project_(Vall, Nvec, offsets, indices, candidates);
+		const auto& projected = projector.get_is_projected_();
+		for (int iter = 0; iter < r; iter++)
 		{
-			int k = neighboor[iter].size();
-			int r = Vall.size();
-
-
-			Eigen::Vector3d z(x[0], x[1], x[2]);
-			double mu = 0.01;
-			func = 0;
-			for (int i = 0; i < k; i++)
+			if (!candidates[iter])
 			{
-				auto zp = Vall[neighboor[iter][i]] - z;
-				func += pow(zp.dot(Nall_new[neighboor[iter][i]]), 2);
-				//func += x[i] * w[i] * (Nall[neighboor[iter][i]] - n1).squaredNorm()  + (1 - x[i]) * w[i] * (Nall[neighboor[iter][i]] - n2).squaredNorm();
+				continue;
 			}
-			func = func + mu * (Vall[iter] - z).squaredNorm();
-
-			Eigen::Vector3d g(0, 0, 0);
-			g = 2 * mu * (z - Vall[iter]);
-			for (int i = 0; i < k; i++)
+			omp_cnt++;
+			if (projected[iter])
 			{
-				//double a = abs(cos(x[k]))* abs(cos(x[k]));
-				auto Pj = Vall[neighboor[iter][i]];
-				auto nj = Nall_new[neighboor[iter][i]];
-				g = g + 2 * (z - Pj).dot(nj) * nj;
+				NewPoints[iter] = projector.get_points_()[iter];
 			}
-
-			grad[0] = g.x();
-			grad[1] = g.y();
-			grad[2] = g.z();
-
-
-		};
-
-		minbleicstate state;
-		double epsg = 0;
-		double epsf = 0;
-		double epsx = 0;
-		ae_int_t maxits = 0;
-		alglib::minbleiccreate(x0, state);
-		//alglib::minbleicsetlc(state, c, ct);
-		//alglib::minbleicsetbc(state, bndl, bndu);
-		alglib::minbleicsetscale(state, s0);
-		alglib::minbleicsetcond(state, epsg, epsf, epsx, maxits);
-
-		alglib::minbleicoptguardsmoothness(state);
-		alglib::minbleicoptguardgradient(state, 0.000001);
-
-		if (debugOutput)
-		{
-			for (int i = 0; i < 3; i++)
+			else
 			{
-				cout << x0[i] << " ";
-			}cout << endl;
-		}
-
-
-
-		minbleicreport rep2;
-		//minbleicoptimize(state, fop, nullptr, nullptr, alglib::parallel);
-		alglib::minbleicoptimize(state, fop_z_lambda);
-		alglib::minbleicresults(state, x0, rep2);
-		//cout << rep2.debugff << endl;
-		double mn = 0;
-		real_1d_array G_tmp;
-		G_tmp.setlength(3);
-		fop_z_lambda(x0, mn, G_tmp, nullptr);
-		if (debugOutput)
-			cout << mn << endl;
-		if (debugOutput)
-		{
-			printf("%d\n", int(rep2.terminationtype)); // EXPECTED: 4
-			printf("%s\n", x0.tostring(2).c_str()); // EXPECTED: [2,4]
-
-			optguardreport ogrep;
-			minbleicoptguardresults(state, ogrep);
-			printf("%s\n", ogrep.badgradsuspected ? "true" : "false"); // EXPECTED: false
-			printf("%s\n", ogrep.nonc0suspected ? "true" : "false"); // EXPECTED: false
-			printf("%s\n", ogrep.nonc1suspected ? "true" : "false"); // EXPECTED: false
-		}
-		double dis = (Vall[iter] - Eigen::Vector3d(x0[0], x0[1], x0[2])).norm();
-		if (dis > 0.0001)
-		{
-			NewPoints[iter] = Eigen::Vector3d(x0[0], x0[1], x0[2]);
-			
-		}
-		else
-		{
-			flag3[iter] = true;
+				flag3[iter] = true;
+			}
 		}
-		
-		
-		//NewPoints[iter] = Eigen::Vector3d(x0[0], x0[1], x0[2]);
+		cout << "Part 3 --- Points: " << omp_cnt << " degenerate: " << projector.number_degenerate_() << " \n";
 	}
 
 
@@ -3750,20 +3175,7 @@ void DenoiseTest(string model)
 
 	//ifstream in("E:\\Dropbox\\MyProjects\\SIG-2022-Feature-preserving-recon\\data\\Noise\\abc_chunk4\\0.0025\\" + model + ".xyz");
 
-	ifstream in(outputPath + outputFile + "\\" + model + "\\01_" + model + ".xyz");
-	int ppid = 0;
-	while (!in.eof())
-	{
-		Eigen::Vector3d p, n;
-		in >> p.x() >> p.y() >> p.z() >> n.x() >> n.y() >> n.z();
-		ppid++;
-		//if (ppid % 10 == 0)
-		{
-			Vall.push_back(p);
-			Nall.push_back(n);
-		}
-		
-	}
+	BGAL::_PointCloud_IO::read_(outputPath + outputFile + "\\" + model + "\\01_" + model + ".xyz", Vall, Nall);
 	//out Vall
 	ofstream outSample( outputPath + outputFile + "\\" + model + "\\" + model + "_sample.xyz");
 
@@ -3809,49 +3221,22 @@ void DenoiseTest(string model)
 
 	// rnn
 
-	PointCloud<double> cloud;
 	int mink = 9999999, maxk = -9999999;
 
-	cloud.pts.resize(r);
-	for (int i = 0; i < r; i++)
-	{
-		cloud.pts[i].x = Vall[i].x();
-		cloud.pts[i].y = Vall[i].y();
-		cloud.pts[i].z = Vall[i].z();
-	}
-	typedef KDTreeSingleIndexAdaptor<
-		L2_Simple_Adaptor<double, PointCloud<double> >,
-		PointCloud<double>,
-		3 /* dim */
-	> my_kd_tree_t;
-
-	my_kd_tree_t   index(3 /*dim*/, cloud, KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-	index.buildIndex();
-
-	do
 	{
-		radis += 0.001;
-		neighboor.clear();
-		mink = 99999; maxk = -99999;
+		BGAL::_Neighborhood nbh;
+		nbh._parameter.k = rnnnum;
+		nbh._parameter.radius_rule = stepped_radius(radis);
+		nbh.build_(Vall);
+		neighboor.assign(r, vector<int>());
 		for (int i = 0; i < r; i++)
 		{
-			vector<int> tmp;
-			neighboor.push_back(tmp);
-			double query_pt[3] = { Vall[i].x(), Vall[i].y(), Vall[i].z() };
-			const double search_radius = static_cast<double>((radis) * (radis));
-			std::vector<std::pair<uint32_t, double> >   ret_matches;
-			nanoflann::SearchParams params;
-			const size_t nMatches = index.radiusSearch(&query_pt[0], search_radius, ret_matches, params);
-			for (size_t j = 0; j < nMatches; j++)
-			{
-				neighboor[i].push_back(ret_matches[j].first);
-			}
-			maxk = max(maxk, int(nMatches));
-			mink = min(mink, int(nMatches));
+			neighboor[i].assign(nbh.neighbors_(i), nbh.neighbors_(i) + nbh.number_neighbors_(i));
 		}
-		cout << "maxk: " << maxk << "   mink:" << mink << endl;
-
-	}  while (maxk < rnnnum );
+		maxk = nbh.max_neighbors_();
+		mink = nbh.min_neighbors_();
+		cout << "maxk: " << maxk << "   mink:" << mink << "   meank: " << nbh.mean_neighbors_() << "   radius: " << radis << endl;
+	}
 
 	// smooth 
 	//for (int i = 0; i < r; i++)
@@ -4074,6 +3459,34 @@ void DenoiseTest(string model)
 
 }
 
+void DenoiseBenchmark()
+{
+	// noisy unit spheres of growing size, denoised with the default parameters
+	for (int num = 10000; num <= 1000000; num *= 10)
+	{
+		vector<Eigen::Vector3d> Vall(num), Nall(num);
+		for (int i = 0; i < num; i++)
+		{
+			// Fibonacci sphere with deterministic radial noise
+			double z = 1 - 2.0 * (i + 0.5) / num;
+			double rho = sqrt(1 - z * z);
+			double phi = i * 2.399963229728653;
+			Nall[i] = Eigen::Vector3d(rho * cos(phi), rho * sin(phi), z);
+			Vall[i] = Nall[i] * (1 + 0.3 / sqrt(num) * sin(12.9898 * i));
+		}
+		BGAL::_PointCloudDenoiser denoiser;
+		denoiser.denoise_(Vall, Nall);
+		double err0 = 0, err1 = 0;
+		for (int i = 0; i < num; i++)
+		{
+			err0 += pow(Vall[i].norm() - 1, 2);
+			err1 += pow(denoiser.get_points_()[i].norm() - 1, 2);
+		}
+		cout << "points: " << num << "   time: " << denoiser.time_() << " s   points/s: " << denoiser.points_per_second_()
+			<< "   rms: " << sqrt(err0 / num) << " -> " << sqrt(err1 / num) << endl;
+	}
+}
+
 void Poisson(string model)
 {
 	clock_t start, end;
@@ -4396,6 +3809,7 @@ int main()
 
 
 	//DenoiseTest(model);
+	//DenoiseBenchmark();
 	//RFEPSTest(model);
 	//Comput_rnn(model);
 	//Comput_RPD(model);
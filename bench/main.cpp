@@ -0,0 +1,557 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <BGAL/BaseShape/KDTree.h>
+#include <BGAL/BaseShape/Point.h>
+#include <BGAL/BaseShape/Polygon.h>
+#include <BGAL/Integral/Integral.h>
+#include <BGAL/CVTLike/CPD.h>
+#include <BGAL/CVTLike/CVT.h>
+#include <BGAL/Geodesic/Dijkstra/Dijkstra.h>
+#include <BGAL/Model/ManifoldModel.h>
+#include <BGAL/Model/Model_Iterator.h>
+#include <BGAL/Model/Simplification.h>
+#include <BGAL/Reconstruction/MarchingTetrahedra/MarchingTetrahedra.h>
+#include <BGAL/Tessellation2D/Tessellation2D.h>
+#include <BGAL/Tessellation3D/Side3D.h>
+#include <BGAL/Tessellation3D/Tessellation3D.h>
+
+// Benchmarks of the hot paths on synthetic inputs. Every input is generated from a fixed
+// seed and its size grows with --scale, so runs of two builds at the same scale
+// are comparable. Usage:
+//   bgal_bench [--scale s] [--repeat r] [--filter name] [--output file.json]
+// Every benchmark is run r times after one warm up run; the JSON report has the minimum,
+// median and mean wall time in milliseconds and the size of the input.
+
+//Options
+struct Options
+{
+	int scale = 1;
+	int repeat = 5;
+	std::string filter;
+	std::string output;
+};
+//***********************************
+
+//Result
+struct Result
+{
+	std::string name;
+	std::map<std::string, long long> sizes;
+	std::vector<double> times;
+};
+//***********************************
+
+//Synthetic inputs
+// icosahedron subdivided level times and projected on the unit sphere, 20 * 4^level faces
+BGAL::_ManifoldModel icosphere(const int& level)
+{
+	const double t = (1.0 + sqrt(5.0)) / 2.0;
+	std::vector<BGAL::_Point3> vertices = {
+		BGAL::_Point3(-1, t, 0), BGAL::_Point3(1, t, 0), BGAL::_Point3(-1, -t, 0), BGAL::_Point3(1, -t, 0),
+		BGAL::_Point3(0, -1, t), BGAL::_Point3(0, 1, t), BGAL::_Point3(0, -1, -t), BGAL::_Point3(0, 1, -t),
+		BGAL::_Point3(t, 0, -1), BGAL::_Point3(t, 0, 1), BGAL::_Point3(-t, 0, -1), BGAL::_Point3(-t, 0, 1) };
+	std::vector<std::array<int, 3>> faces = {
+		{0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+		{1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+		{3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+		{4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1} };
+	for (auto& v : vertices)
+		v = v.normalize_();
+	for (int l = 0; l < level; ++l)
+	{
+		std::map<std::pair<int, int>, int> middles;
+		auto middle = [&](int a, int b)
+		{
+			std::pair<int, int> key(std::min(a, b), std::max(a, b));
+			auto it = middles.find(key);
+			if (it != middles.end())
+				return it->second;
+			vertices.push_back(((vertices[a] + vertices[b]) * 0.5).normalize_());
+			middles[key] = vertices.size() - 1;
+			return (int)vertices.size() - 1;
+		};
+		std::vector<std::array<int, 3>> finer;
+		for (auto& f : faces)
+		{
+			int a = middle(f[0], f[1]), b = middle(f[1], f[2]), c = middle(f[2], f[0]);
+			finer.push_back({ f[0], a, c });
+			finer.push_back({ f[1], b, a });
+			finer.push_back({ f[2], c, b });
+			finer.push_back({ a, b, c });
+		}
+		faces.swap(finer);
+	}
+	std::vector<BGAL::_Model::_MFace> mfaces;
+	for (auto& f : faces)
+	{
+		BGAL::_Model::_MFace face(f[0], f[1], f[2], vertices[f[0]], vertices[f[1]], vertices[f[2]]);
+		face.id = mfaces.size();
+		mfaces.push_back(face);
+	}
+	return BGAL::_ManifoldModel(vertices, mfaces);
+}
+// the level whose icosphere has about 20480 * scale faces
+int sphere_level(const int& scale)
+{
+	int level = 5;
+	while (20 * (1 << (2 * level)) < 20480 * scale)
+		++level;
+	return level;
+}
+std::vector<BGAL::_Point3> sphere_points(const int& num, const unsigned& seed)
+{
+	std::mt19937 gen(seed);
+	std::normal_distribution<double> normal;
+	std::vector<BGAL::_Point3> points;
+	for (int i = 0; i < num; ++i)
+		points.push_back(BGAL::_Point3(normal(gen), normal(gen), normal(gen)).normalize_());
+	return points;
+}
+// faces are const through the model, so the areas are not taken from their caches
+double model_area(const BGAL::_Model& model)
+{
+	double area = 0;
+	for (int i = 0; i < model.number_faces_(); ++i)
+	{
+		const BGAL::_Model::_MFace& face = model.face_(i);
+		area += (face.point(1) - face.point(0)).cross_(face.point(2) - face.point(0)).length_() * 0.5;
+	}
+	return area;
+}
+std::vector<BGAL::_Point3> box_points(const int& num, const double& half, const unsigned& seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<double> uniform(-half, half);
+	std::vector<BGAL::_Point3> points;
+	for (int i = 0; i < num; ++i)
+		points.push_back(BGAL::_Point3(uniform(gen), uniform(gen), uniform(gen)));
+	return points;
+}
+//***********************************
+
+//Runner
+// times run after one untimed call
+void measure(Result& result, const Options& options, const std::function<void()>& run)
+{
+	for (int r = 0; r <= options.repeat; ++r)
+	{
+		auto start = std::chrono::steady_clock::now();
+		run();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (r > 0)
+			result.times.push_back(ms);
+	}
+}
+void write_json(std::ostream& out, const Options& options, const std::vector<Result>& results)
+{
+	out << "{\n  \"scale\": " << options.scale << ",\n  \"repeat\": " << options.repeat
+		<< ",\n  \"threads\": " << omp_get_max_threads() << ",\n  \"benchmarks\": [";
+	for (int i = 0; i < results.size(); ++i)
+	{
+		std::vector<double> times = results[i].times;
+		std::sort(times.begin(), times.end());
+		double mean = 0;
+		for (auto& t : times)
+			mean += t / times.size();
+		out << (i ? "," : "") << "\n    {\"name\": \"" << results[i].name << "\"";
+		for (auto& s : results[i].sizes)
+			out << ", \"" << s.first << "\": " << s.second;
+		out << ", \"min_ms\": " << times.front() << ", \"median_ms\": " << times[times.size() / 2]
+			<< ", \"mean_ms\": " << mean << "}";
+	}
+	out << "\n  ]\n}\n";
+}
+//***********************************
+
+//Benchmarks
+Result ModelLoadingBench(const Options& options)
+{
+	Result result{ "model_loading" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	const std::string file = "bgal_bench_sphere.obj";
+	model.save_obj_file_(file);
+	result.sizes["faces"] = model.number_faces_();
+	measure(result, options, [&]
+		{
+			BGAL::_ManifoldModel loaded(file);
+		});
+	std::remove(file.c_str());
+	return result;
+}
+Result PQPDistanceBench(const Options& options)
+{
+	Result result{ "pqp_distance" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	model.initialization_PQP_();
+	std::vector<BGAL::_Point3> queries = box_points(20000 * options.scale, 1.5, 1);
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["queries"] = queries.size();
+	double sum = 0;
+	measure(result, options, [&]
+		{
+			for (auto& q : queries)
+				sum += model.signed_distance_(q);
+		});
+	return result;
+}
+Result KDTreeBench(const Options& options)
+{
+	Result result{ "kdtree_knn" };
+	std::vector<BGAL::_Point3> points = box_points(100000 * options.scale, 1, 2);
+	std::vector<BGAL::_Point3> queries = box_points(100000 * options.scale, 1, 3);
+	result.sizes["points"] = points.size();
+	result.sizes["queries"] = queries.size();
+	result.sizes["k"] = 8;
+	measure(result, options, [&]
+		{
+			BGAL::_KDTree tree(points);
+			std::vector<int> ids;
+			std::vector<double> sqdists;
+			for (auto& q : queries)
+				tree.knn_search_(q, 8, ids, sqdists);
+		});
+	return result;
+}
+Result DijkstraBench(const Options& options)
+{
+	Result result{ "dijkstra" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	result.sizes["vertices"] = model.number_vertices_();
+	std::map<int, double> sources;
+	sources[0] = 0;
+	measure(result, options, [&]
+		{
+			BGAL::Geodesic::_Dijkstra dijkstra(model, sources);
+			dijkstra.execute_();
+		});
+	return result;
+}
+Result Tessellation2DBench(const Options& options)
+{
+	Result result{ "tessellation2d" };
+	BGAL::_Polygon boundary;
+	boundary.start_();
+	boundary.insert_(BGAL::_Point2(0, 0));
+	boundary.insert_(BGAL::_Point2(1, 0));
+	boundary.insert_(BGAL::_Point2(1, 1));
+	boundary.insert_(BGAL::_Point2(0, 1));
+	boundary.end_();
+	std::mt19937 gen(4);
+	std::uniform_real_distribution<double> uniform(0, 1);
+	std::vector<BGAL::_Point2> sites;
+	for (int i = 0; i < 10000 * options.scale; ++i)
+		sites.push_back(BGAL::_Point2(uniform(gen), uniform(gen)));
+	result.sizes["sites"] = sites.size();
+	measure(result, options, [&]
+		{
+			BGAL::_Tessellation2D tessellation(boundary, sites);
+		});
+	return result;
+}
+Result PolygonIntegrationBench(const Options& options)
+{
+	Result result{ "polygon_integration" };
+	BGAL::_Polygon boundary;
+	boundary.start_();
+	boundary.insert_(BGAL::_Point2(0, 0));
+	boundary.insert_(BGAL::_Point2(1, 0));
+	boundary.insert_(BGAL::_Point2(1, 1));
+	boundary.insert_(BGAL::_Point2(0, 1));
+	boundary.end_();
+	std::mt19937 gen(4);
+	std::uniform_real_distribution<double> uniform(0, 1);
+	std::vector<BGAL::_Point2> sites;
+	for (int i = 0; i < 10000 * options.scale; ++i)
+		sites.push_back(BGAL::_Point2(uniform(gen), uniform(gen)));
+	BGAL::_Tessellation2D tessellation(boundary, sites);
+	const std::vector<BGAL::_Polygon>& cells = tessellation.get_cell_polygons_();
+	result.sizes["cells"] = cells.size();
+	// CVT energy and gradient of every cell
+	std::vector<Eigen::Vector3d> integrals;
+	measure(result, options, [&]
+		{
+			BGAL::_Integral::integral_cells(
+				[&](const int& i, const Eigen::Vector2d& p)
+				{
+					const Eigen::Vector2d d(sites[i].x() - p.x(), sites[i].y() - p.y());
+					return Eigen::Vector3d(d.squaredNorm(), 2 * d.x(), 2 * d.y());
+				}, cells, integrals);
+		});
+	return result;
+}
+Result RestrictedTessellation3DBench(const Options& options)
+{
+	Result result{ "restricted_tessellation3d" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	std::vector<BGAL::_Point3> sites = sphere_points(2000 * options.scale, 5);
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = sites.size();
+	BGAL::_Restricted_Tessellation3D RVD(model);
+	BGAL::_Side3D::reset_statistics_();
+	measure(result, options, [&]
+		{
+			RVD.calculate_(sites);
+		});
+	// predicates per run and the level of the filter that decided them
+	const BGAL::_Side3D::_Statistics statistics = BGAL::_Side3D::statistics_();
+	result.sizes["side3d_static_filter"] = statistics.static_filter / (options.repeat + 1);
+	result.sizes["side3d_interval_filter"] = statistics.interval_filter / (options.repeat + 1);
+	result.sizes["side3d_exact"] = statistics.exact / (options.repeat + 1);
+	return result;
+}
+Result CVT3DBench(const Options& options)
+{
+	Result result{ "cvt3d_iterations" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	std::vector<BGAL::_Point3> sites = sphere_points(1000 * options.scale, 6);
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1.0;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 0;
+	para.max_iteration = 10;
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = sites.size();
+	result.sizes["iterations"] = para.max_iteration;
+	measure(result, options, [&]
+		{
+			BGAL::_CVT3D cvt(model, rho, para);
+			cvt.calculate_(sites);
+		});
+	return result;
+}
+Result SimplificationBench(const Options& options)
+{
+	Result result{ "simplification" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	const int target = model.number_faces_() / 16;
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["target_faces"] = target;
+	measure(result, options, [&]
+		{
+			BGAL::_ManifoldModel coarse = BGAL::_Mesh_Simplification::simplify_(model, target);
+		});
+	return result;
+}
+Result MultiresolutionCVTBench(const Options& options)
+{
+	Result result{ "cvt3d_multiresolution" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1.0;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 1e-4;
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = 1000 * options.scale;
+	result.sizes["levels"] = 3;
+	measure(result, options, [&]
+		{
+			BGAL::_CVT3D cvt(model, rho, para);
+			cvt.calculate_multiresolution_(1000 * options.scale, 3);
+		});
+	return result;
+}
+// the single level solver until it reaches the final energy of the multiresolution one,
+// within 0.1%; reached_target is 0 if it converges above it
+Result CVT3DToTargetBench(const Options& options)
+{
+	Result result{ "cvt3d_to_target" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1.0;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 1e-4;
+	double target = 0;
+	para.callback = [&](const BGAL::_LBFGS::_Iteration_Info& info)
+	{
+		target = info.energy;
+		return true;
+	};
+	{
+		BGAL::_CVT3D cvt(model, rho, para);
+		cvt.calculate_multiresolution_(1000 * options.scale, 3);
+	}
+	bool reached = true;
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = 1000 * options.scale;
+	measure(result, options, [&]
+		{
+			double energy = 0;
+			BGAL::_LBFGS::_Parameter run = para;
+			run.callback = [&](const BGAL::_LBFGS::_Iteration_Info& info)
+			{
+				energy = info.energy;
+				return info.energy > target * 1.001;
+			};
+			BGAL::_CVT3D cvt(model, rho, run);
+			cvt.calculate_(1000 * options.scale);
+			reached = reached && energy <= target * 1.001;
+		});
+	result.sizes["reached_target"] = reached;
+	return result;
+}
+Result CPD3DBench(const Options& options)
+{
+	Result result{ "cpd3d_iterations" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	std::vector<BGAL::_Point3> sites = sphere_points(500 * options.scale, 7);
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1.0;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 0;
+	para.max_iteration = 5;
+	std::vector<double> capacity(sites.size(), model_area(model) / sites.size());
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = sites.size();
+	result.sizes["iterations"] = para.max_iteration;
+	measure(result, options, [&]
+		{
+			BGAL::_CPD3D cpd(model, rho, para);
+			cpd.calculate_(capacity, sites);
+		});
+	return result;
+}
+Result CPD3DWeightsBench(const Options& options)
+{
+	Result result{ "cpd3d_weights" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(options.scale));
+	std::vector<BGAL::_Point3> sites = sphere_points(10000 * options.scale, 9);
+	// every other cell twice as large
+	const double area = model_area(model);
+	std::vector<double> capacity(sites.size());
+	for (int i = 0; i < sites.size(); ++i)
+		capacity[i] = area / (1.5 * sites.size()) * (i % 2 == 0 ? 2 : 1);
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = sites.size();
+	measure(result, options, [&]
+		{
+			BGAL::_CPD3D cpd(model);
+			cpd._para.is_show = false;
+			cpd.calculate_weights_(capacity, sites);
+		});
+	return result;
+}
+Result CapVTBench(const Options& options)
+{
+	Result result{ "capvt_iterations" };
+	BGAL::_ManifoldModel model = icosphere(sphere_level(5 * options.scale));
+	model.initialization_PQP_();
+	std::vector<BGAL::_Point3> sites = sphere_points(100000 * options.scale, 8);
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1.0;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 0;
+	para.max_iteration = 3;
+	result.sizes["faces"] = model.number_faces_();
+	result.sizes["sites"] = sites.size();
+	result.sizes["iterations"] = para.max_iteration;
+	measure(result, options, [&]
+		{
+			BGAL::_CVT3D cvt(model, rho, para);
+			cvt.calculate_CapVT(sites);
+		});
+	return result;
+}
+Result MarchingTetrahedraBench(const Options& options)
+{
+	Result result{ "marching_tetrahedra" };
+	int depth = 6;
+	while ((1 << (3 * (depth - 6))) < options.scale)
+		++depth;
+	std::pair<BGAL::_Point3, BGAL::_Point3> bbox(BGAL::_Point3(-1.2, -1.2, -1.2), BGAL::_Point3(1.2, 1.2, 1.2));
+	std::function<std::pair<double, BGAL::_Point3>(BGAL::_Point3 p)> sphere = [](BGAL::_Point3 p)
+	{
+		double r = p.length_();
+		return std::make_pair(r - 1, r > 0 ? p / r : p);
+	};
+	result.sizes["depth"] = depth;
+	measure(result, options, [&]
+		{
+			BGAL::_Marching_Tetrahedra MT(bbox, depth);
+			MT.set_method_(1);
+			MT.reconstruction_(sphere);
+		});
+	return result;
+}
+//***********************************
+
+int main(int argc, char** argv)
+{
+	Options options;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (i + 1 < argc && arg == "--scale")
+			options.scale = std::max(1, atoi(argv[++i]));
+		else if (i + 1 < argc && arg == "--repeat")
+			options.repeat = std::max(1, atoi(argv[++i]));
+		else if (i + 1 < argc && arg == "--filter")
+			options.filter = argv[++i];
+		else if (i + 1 < argc && arg == "--output")
+			options.output = argv[++i];
+		else
+		{
+			std::cerr << "usage: bgal_bench [--scale s] [--repeat r] [--filter name] [--output file.json]" << std::endl;
+			return 1;
+		}
+	}
+	std::vector<std::pair<std::string, std::function<Result(const Options&)>>> benchmarks = {
+		{ "model_loading", ModelLoadingBench },
+		{ "pqp_distance", PQPDistanceBench },
+		{ "kdtree_knn", KDTreeBench },
+		{ "dijkstra", DijkstraBench },
+		{ "tessellation2d", Tessellation2DBench },
+		{ "polygon_integration", PolygonIntegrationBench },
+		{ "restricted_tessellation3d", RestrictedTessellation3DBench },
+		{ "cvt3d_iterations", CVT3DBench },
+		{ "simplification", SimplificationBench },
+		{ "cvt3d_multiresolution", MultiresolutionCVTBench },
+		{ "cvt3d_to_target", CVT3DToTargetBench },
+		{ "cpd3d_iterations", CPD3DBench },
+		{ "cpd3d_weights", CPD3DWeightsBench },
+		{ "capvt_iterations", CapVTBench },
+		{ "marching_tetrahedra", MarchingTetrahedraBench } };
+	std::vector<Result> results;
+	for (auto& b : benchmarks)
+	{
+		if (b.first.find(options.filter) == std::string::npos)
+			continue;
+		std::cerr << "====================" << b.first << std::endl;
+		results.push_back(b.second(options));
+	}
+	if (options.output.empty())
+		write_json(std::cout, options, results);
+	else
+	{
+		std::ofstream out(options.output);
+		write_json(out, options, results);
+	}
+	return 0;
+}
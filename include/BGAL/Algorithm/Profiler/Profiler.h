@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+namespace BGAL
+{
+  // Wall-clock scopes and event counters of the library.
+  // Scopes nest per thread: a scope opened inside another is reported under its path,
+  // "rvd/clipping" for a "clipping" scope inside "rvd". Every thread records its scopes in
+  // its own buffer, so recording takes no lock; counters are relaxed atomics. Reports are
+  // meant to be written once the work being profiled has finished.
+  // The instrumentation of the library goes through the BGAL_PROFILE_* macros, which
+  // compile to nothing unless BGAL_PROFILE is defined (the BGAL_PROFILE CMake option);
+  // when compiled in, recording is on until enable_(false).
+  class _Profiler
+  {
+  public:
+    class _Scope
+    {
+    public:
+      // in_name must outlive the profiler, a string literal
+      explicit _Scope(const char *in_name);
+      ~_Scope();
+      // closes the scope before the end of its block
+      void end_();
+
+    private:
+      const char *_name;
+      double _start;
+      bool _active;
+    };
+    class _Counter
+    {
+    public:
+      explicit _Counter(const char *in_name);
+      void add_(const long long &in_count)
+      {
+        if (enabled_())
+          _value.fetch_add(in_count, std::memory_order_relaxed);
+      }
+      const char *name_() const
+      {
+        return _name;
+      }
+      long long value_() const
+      {
+        return _value.load(std::memory_order_relaxed);
+      }
+      void reset_()
+      {
+        _value.store(0, std::memory_order_relaxed);
+      }
+
+    private:
+      const char *_name;
+      std::atomic<long long> _value;
+    };
+    static void enable_(const bool &in_enable);
+    static bool enabled_();
+    // drops the recorded scopes and zeroes the counters
+    static void reset_();
+    // complete events ("ph": "X") of every scope and the final value of every counter, for
+    // chrome://tracing or Perfetto
+    static void write_chrome_trace_(const std::string &in_file_name);
+    // calls, total and self milliseconds of every scope path, and the counters
+    static void write_report_(const std::string &in_file_name);
+  };
+} // namespace BGAL
+
+#define BGAL_PROFILE_CONCAT_(a, b) a##b
+#define BGAL_PROFILE_CONCAT(a, b) BGAL_PROFILE_CONCAT_(a, b)
+#ifdef BGAL_PROFILE
+// times the rest of the enclosing block
+#define BGAL_PROFILE_SCOPE(name) BGAL::_Profiler::_Scope BGAL_PROFILE_CONCAT(bgal_profile_scope_, __LINE__)(name)
+// times from BGAL_PROFILE_BEGIN(id, name) to BGAL_PROFILE_END(id) in the same block
+#define BGAL_PROFILE_BEGIN(id, name) BGAL::_Profiler::_Scope bgal_profile_##id(name)
+#define BGAL_PROFILE_END(id) bgal_profile_##id.end_()
+#define BGAL_PROFILE_COUNT(name, count)                     \
+  do                                                        \
+  {                                                         \
+    static BGAL::_Profiler::_Counter bgal_profile_counter(name); \
+    bgal_profile_counter.add_(count);                       \
+  } while (0)
+#else
+#define BGAL_PROFILE_SCOPE(name)
+#define BGAL_PROFILE_BEGIN(id, name)
+#define BGAL_PROFILE_END(id)
+#define BGAL_PROFILE_COUNT(name, count) \
+  do                                    \
+  {                                     \
+  } while (0)
+#endif
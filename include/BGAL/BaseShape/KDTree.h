@@ -12,6 +12,17 @@ namespace BGAL
 		int search_(const _Point3& in_p, double& min_dist) const;
 		std::vector<int> nsearch_(const std::vector<_Point3>& in_ps, const int& k) const;
 		std::vector<int> rsearch_(const std::vector<_Point3>& in_p, const double& in_r) const;
+		// The min(k, n) nearest points of in_p sorted by distance. out_ids and
+		// out_sqdists are overwritten and can be reused across queries.
+		void knn_search_(const _Point3& in_p, const int& k,
+		                 std::vector<int>& out_ids, std::vector<double>& out_sqdists) const;
+		// All points within in_r of in_p, in no particular order.
+		void radius_search_(const _Point3& in_p, const double& in_r,
+		                    std::vector<int>& out_ids, std::vector<double>& out_sqdists) const;
+		inline int number_points_() const
+		{
+			return _points.size();
+		}
 	private:
 		void build_(const std::vector<_Point3>& in_points);
 		void clear_();
@@ -28,5 +39,7 @@ namespace BGAL
 	private:
 		_Node* _root;
 		std::vector<_Point3> _points;
+		// flat xyz copy of _points for the search kernels
+		std::vector<double> _coords;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "Point.h"
+#include <functional>
 #include <vector>
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
@@ -105,6 +106,8 @@ namespace BGAL
 		const _Point2& operator[](const int& in_inx) const;
 		_Point2& operator[](const int& in_inx);
 		bool is_in_(const _Point2& in_p) const;
+		// collinear vertices are allowed, either orientation
+		bool is_convex_() const;
 		_Point2 nearest_point_(const _Point2& in_p);
 		double distance_to_boundary_(const _Point2& in_p);
 		int intersection_with_linesegment_(const _Point2& p1, const _Point2& p2, std::vector<std::pair<int, _Point2>>& intersections) const;
@@ -138,5 +141,9 @@ namespace BGAL
 		double area_() const;
 		double triangle_area_() const;
 		double circumference_() const;
+	private:
+		friend class _Prepared_Polygon;
+		// the segment query over the edges in_edges in increasing order, every edge if null
+		int intersection_with_linesegment_(const _Point2& p1, const _Point2& p2, const std::vector<int>* in_edges, const std::function<bool(const _Point2&)>& in_is_in, std::vector<std::pair<int, _Point2>>& intersections) const;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "Polygon.h"
+#include <Eigen/Dense>
+#include <utility>
+#include <vector>
+namespace BGAL
+{
+	// A polygon prepared for many queries. Its edges are binned in a uniform grid over the
+	// bounding box, about one edge per cell, so a query only looks at the edges near it:
+	// is_in_ walks the cells right of the point on its row, nearest_point_ visits rings of
+	// cells around the point until no closer edge can be left, and the segment query visits
+	// the cells along the segment. The answers are those of the _Polygon queries. The
+	// batched queries run in parallel.
+	class _Prepared_Polygon
+	{
+	public:
+		_Prepared_Polygon(const _Polygon& in_polygon);
+		inline const _Polygon& polygon_() const
+		{
+			return _polygon;
+		}
+		bool is_in_(const _Point2& in_p) const;
+		_Point2 nearest_point_(const _Point2& in_p) const;
+		// negative inside
+		double distance_to_boundary_(const _Point2& in_p) const;
+		int intersection_with_linesegment_(const _Point2& p1, const _Point2& p2, std::vector<std::pair<int, _Point2>>& intersections) const;
+		// one answer per point, or per segment
+		std::vector<char> is_in_(const std::vector<_Point2>& in_points) const;
+		std::vector<_Point2> nearest_points_(const std::vector<_Point2>& in_points) const;
+		std::vector<double> distances_to_boundary_(const std::vector<_Point2>& in_points) const;
+		std::vector<int> intersections_with_linesegments_(const std::vector<std::pair<_Point2, _Point2>>& in_segments,
+			std::vector<std::vector<std::pair<int, _Point2>>>& out_intersections) const;
+	private:
+		int column_(const double& in_x) const;
+		int row_(const double& in_y) const;
+		// the cells the segment may pass through
+		void cells_along_(const Eigen::Vector2d& a, const Eigen::Vector2d& b, std::vector<int>& out_cells) const;
+		bool in_cell_(const int& in_cell, const int& in_edge) const;
+		// squared distance to the nearest point q of the boundary
+		double nearest_(const Eigen::Vector2d& in_p, Eigen::Vector2d& q) const;
+	private:
+		_Polygon _polygon;
+		std::vector<Eigen::Vector2d> _points;
+		Eigen::Vector2d _min;
+		Eigen::Vector2d _max;
+		double _dx;
+		double _dy;
+		int _nx;
+		int _ny;
+		// slack of the cells, for the tolerances of the queries
+		double _pad;
+		// edge i joins the points i and i + 1; the edges of the cell row * _nx + column are
+		// _cell_edges[_cell_begin[cell]] ... _cell_edges[_cell_begin[cell + 1] - 1]
+		std::vector<int> _cell_begin;
+		std::vector<int> _cell_edges;
+	};
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <Eigen/Sparse>
 #include "BGAL/BaseShape/Point.h"
 #include "BGAL/BaseShape/Polygon.h"
 #include "BGAL/BaseShape/Triangle.h"
@@ -14,8 +15,14 @@ namespace BGAL
 	{
 	public:
 		_CPD3D(const _ManifoldModel& model);
+		// rho is evaluated from several threads at once
 		_CPD3D(const _ManifoldModel& model, std::function<double(_Point3& p)>& rho, _LBFGS::_Parameter para);
 		void calculate_(const std::vector<double>& capacity, std::vector<_Point3> sites);
+		// only the weights: the power diagram of the fixed sites whose cells have the capacities,
+		// by damped Newton steps from the weights of the last solve
+		void calculate_weights_(const std::vector<double>& capacity, std::vector<_Point3> sites);
+		// continues a run checkpointed through _para.checkpoint_file
+		void resume_(const std::string& checkpoint_file);
 		const std::vector<_Point3>& get_sites() const
 		{
 			return _sites;
@@ -28,6 +35,13 @@ namespace BGAL
 		{
 			return _RPD;
 		}
+	private:
+		// the masses of the power cells of the weights; false if a site is hidden
+		bool cell_masses_(const Eigen::VectorXd& weights, Eigen::VectorXd& masses);
+		// the derivatives of the masses by the weights, on the current power diagram
+		void hessian_(Eigen::SparseMatrix<double>& h) const;
+		void solve_weights_();
+		void optimize_(const std::string& checkpoint_file);
 	public:
 		// ЩӦ÷װһµģʱûʱˣֱӱ¶
 		const _ManifoldModel& _model;
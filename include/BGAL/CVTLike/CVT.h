@@ -15,8 +15,21 @@ namespace BGAL
 	public:
 		_CVT3D(const _ManifoldModel& model);
 		_CVT3D(const _ManifoldModel& model, std::function<double(_Point3& p)>& rho, _LBFGS::_Parameter para);
+		// seeds site_num sites by area and density, see _Site_Sampler
 		void calculate_(int site_num);
+		void calculate_(const std::vector<_Point3>& sites);
+		// Coarse to fine: every coarser level has a model simplified to a quarter of the faces and
+		// half of the sites. The sites of a level are optimized, the largest cells are split and
+		// the result seeds the next finer level; the full model only polishes.
+		void calculate_multiresolution_(int site_num, int level_num = 3);
+		// continues a run checkpointed through _para.checkpoint_file
+		void resume_(const std::string& checkpoint_file);
+		// Capacity constrained: moves the sites on the model until their restricted Voronoi
+		// cells have equal areas, minimizing the sum of (area - mean area)^2. The sites are
+		// projected with the PQP tree of the model, so model.initialization_PQP_() must be called first.
 		void calculate_CapVT(std::vector<BGAL::_Point3>& sites);
+		// areas of the cells of the current sites
+		void cell_areas_(std::vector<double>& out_areas) const;
 		const std::vector<_Point3>& get_sites() const
 		{
 			return _sites;
@@ -25,6 +38,9 @@ namespace BGAL
 		{
 			return _RVD;
 		}
+	private:
+		void optimize_(const std::string& checkpoint_file);
+		void optimize_CapVT_();
 	public:
 		const _ManifoldModel& _model;
 		_Restricted_Tessellation3D _RVD;
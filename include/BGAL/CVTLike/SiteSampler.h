@@ -0,0 +1,35 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "BGAL/BaseShape/Point.h"
+#include "BGAL/Model/Model.h"
+
+namespace BGAL
+{
+	// Initial sites on a surface, distributed by area times density.
+	// A face is picked from an alias table over area * rho(centroid) in constant time and a
+	// point is drawn uniformly inside it. The draws are split in fixed blocks with their own
+	// generator seeded by the seed and the block index, so the sites are the same for any
+	// number of threads.
+	class _Site_Sampler
+	{
+	public:
+		_Site_Sampler(const _Model& model);
+		_Site_Sampler(const _Model& model, std::function<double(_Point3& p)>& rho);
+		std::vector<_Point3> sample_(int num, unsigned int seed = 0) const;
+		// blue noise sites: weighted sample elimination (Yuksel 2015) of
+		// candidate_ratio * num sites drawn by sample_
+		std::vector<_Point3> sample_blue_noise_(int num, unsigned int seed = 0, int candidate_ratio = 5) const;
+		double area_() const
+		{
+			return _area;
+		}
+	private:
+		void build_(std::function<double(_Point3& p)>& rho);
+	private:
+		const _Model& _model;
+		std::vector<double> _probability;
+		std::vector<int> _alias;
+		double _area;
+	};
+} // namespace BGAL
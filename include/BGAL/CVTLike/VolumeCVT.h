@@ -0,0 +1,32 @@
+#pragma once
+#include "BGAL/BaseShape/Point.h"
+#include "BGAL/Model/ManifoldModel.h"
+#include "BGAL/Tessellation3D/ClippedTessellation3D.h"
+#include "BGAL/Optimization/LBFGS/LBFGS.h"
+
+namespace BGAL
+{
+	// CVT of the volume enclosed by a closed model: the sites live inside the solid
+	// and their cells are the Voronoi cells clipped by it.
+	class _Volume_CVT3D
+	{
+	public:
+		_Volume_CVT3D(const _ManifoldModel& model);
+		_Volume_CVT3D(const _ManifoldModel& model, std::function<double(_Point3& p)>& rho, _LBFGS::_Parameter para);
+		void calculate_(int site_num);
+		void calculate_(const std::vector<_Point3>& sites);
+		const std::vector<_Point3>& get_sites() const
+		{
+			return _sites;
+		}
+		const _Clipped_Tessellation3D& get_CVD() const
+		{
+			return _CVD;
+		}
+	public:
+		_Clipped_Tessellation3D _CVD;
+		std::vector<_Point3> _sites{};
+		std::function<double(_Point3& p)> _rho;
+		_LBFGS::_Parameter _para;
+	};
+} // namespace BGAL
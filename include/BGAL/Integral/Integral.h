@@ -2,11 +2,30 @@
 #include "Tetrahedron_arbq_rule.h"
 #include "BGAL/BaseShape/Polygon.h"
 #include <Eigen/Dense>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
 namespace BGAL 
 {
+	// Quadrature rule on the reference simplex: num nodes given by their barycentric
+	// coordinates (dimension + 1 each) and weights that sum to one.
+	class _Quadrature_Rule
+	{
+	public:
+		int degree;
+		int num;
+		std::vector<double> nodes;
+		std::vector<double> weights;
+	};
 	class _Integral 
 	{
 	public:
+		// Rules exact for polynomials up to in_degree, built once and shared. Tetrahedra use
+		// the Keast rules with positive weights where one exists; the defaults are the rules
+		// the fixed integral_triangle and integral_tetrahedron always used.
+		static const _Quadrature_Rule& tetrahedron_rule(int in_degree = 3);
+		static const _Quadrature_Rule& triangle_rule(int in_degree = 3);
 		template<class F>
 		static Eigen::VectorXd integral_triangle(F f, const _Polygon& poly) 
 		{
@@ -51,6 +70,8 @@ namespace BGAL
 		template<class F>
 		static Eigen::VectorXd integral_polygon(F f, const _Polygon& poly) 
 		{
+			if (poly.is_convex_())
+				return integral_polygon_fast(f, poly);
 			std::vector<_Polygon> tris = poly.constrained_delaunay_triangulation_();
 			Eigen::VectorXd r = integral_triangle(f, tris[0]);
 			for (int i = 1; i < tris.size(); ++i) {
@@ -67,59 +88,186 @@ namespace BGAL
 			}
 			return r;
 		}
+		// Integrates f over a triangle with a rule. f maps an Eigen::Vector2d to R, the result
+		// type, so a fixed size Eigen result or a double does not allocate.
 		template<class F>
-		static Eigen::VectorXd integral_tetrahedron(F f, const _Point3& p1, const _Point3& p2, const _Point3& p3, const _Point3& p4) 
+		static auto integral_triangle(F f, const Eigen::Vector2d& p1, const Eigen::Vector2d& p2, const Eigen::Vector2d& p3, const _Quadrature_Rule& rule)
+			-> typename std::decay<decltype(f(p1))>::type
 		{
-			double node_xyz[3 * 4] = 
+			typedef typename std::decay<decltype(f(p1))>::type R;
+			const Eigen::Vector2d v1 = p2 - p1, v2 = p3 - p1;
+			const double area = fabs(v1.x() * v2.y() - v1.y() * v2.x()) * 0.5;
+			const double* b = rule.nodes.data();
+			R r = rule.weights[0] * f(Eigen::Vector2d(b[0] * p1 + b[1] * p2 + b[2] * p3));
+			for (int i = 1; i < rule.num; ++i)
 			{
-				0.0, 0.0, 0.0,
-				1.0, 0.0, 0.0,
-				0.0, 1.0, 0.0,
-				0.0, 0.0, 1.0 
-			};
-			double node_xyz2[12];
-			node_xyz2[0] = p1.x();
-			node_xyz2[1] = p1.y();
-			node_xyz2[2] = p1.z();
-			node_xyz2[3] = p2.x();
-			node_xyz2[4] = p2.y();
-			node_xyz2[5] = p2.z();
-			node_xyz2[6] = p3.x();
-			node_xyz2[7] = p3.y();
-			node_xyz2[8] = p3.z();
-			node_xyz2[9] = p4.x();
-			node_xyz2[10] = p4.y();
-			node_xyz2[11] = p4.z();
-
-			double* w;
-			double* xyz;
-			double* xyz2;
-			int order_num = keast_order_num(4);
-			xyz = new double[3 * order_num];
-			xyz2 = new double[3 * order_num];
-			w = new double[order_num];
-
-			keast_rule(4, order_num, xyz, w);
-
-			tetrahedron_reference_to_physical(node_xyz2, order_num, xyz, xyz2);
-
-			double volume = tetrahedron_volume(node_xyz2);
-			std::vector<_Point3> samples;
-			for (int i = 0; i < order_num; ++i) 
+				b = rule.nodes.data() + 3 * i;
+				r += rule.weights[i] * f(Eigen::Vector2d(b[0] * p1 + b[1] * p2 + b[2] * p3));
+			}
+			return area * r;
+		}
+		// the same over a triangle in space, f maps an Eigen::Vector3d to R
+		template<class F>
+		static auto integral_triangle(F f, const Eigen::Vector3d& p1, const Eigen::Vector3d& p2, const Eigen::Vector3d& p3, const _Quadrature_Rule& rule = triangle_rule())
+			-> typename std::decay<decltype(f(p1))>::type
+		{
+			typedef typename std::decay<decltype(f(p1))>::type R;
+			const double area = (p2 - p1).cross(p3 - p1).norm() * 0.5;
+			const double* b = rule.nodes.data();
+			R r = rule.weights[0] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3));
+			for (int i = 1; i < rule.num; ++i)
 			{
-				samples.push_back(_Point3(xyz2[0 + i * 3], xyz2[1 + i * 3], xyz2[2 + i * 3]));
+				b = rule.nodes.data() + 3 * i;
+				r += rule.weights[i] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3));
 			}
-			Eigen::VectorXd r = volume * w[0] * f(samples[0]);
-			for (int i = 1; i < order_num; ++i) 
+			return area * r;
+		}
+		// Integrates f, as above, over a cell: a fan of triangles from the first vertex when
+		// the cell is convex, as power diagram cells are, and its constrained Delaunay
+		// triangulation otherwise. An empty cell, the one of a hidden site, gives zero; f is
+		// still called once there for the size of the result.
+		template<class F>
+		static auto integral_cell(F f, const _Polygon& poly, const _Quadrature_Rule& rule = triangle_rule())
+			-> typename std::decay<decltype(f(Eigen::Vector2d()))>::type
+		{
+			typedef typename std::decay<decltype(f(Eigen::Vector2d()))>::type R;
+			const int n = poly.num_();
+			if (n < 3)
+				return R(0.0 * f(Eigen::Vector2d::Zero()));
+			if (poly.is_convex_())
 			{
-				r = r + volume * w[i] * f(samples[i]);
+				const Eigen::Vector2d p1(poly[0].x(), poly[0].y());
+				Eigen::Vector2d p2(poly[1].x(), poly[1].y());
+				Eigen::Vector2d p3(poly[2].x(), poly[2].y());
+				R r = integral_triangle(f, p1, p2, p3, rule);
+				for (int i = 3; i < n; ++i)
+				{
+					p2 = p3;
+					p3 = Eigen::Vector2d(poly[i].x(), poly[i].y());
+					r += integral_triangle(f, p1, p2, p3, rule);
+				}
+				return r;
+			}
+			std::vector<_Polygon> tris = poly.constrained_delaunay_triangulation_();
+			R r = 0.0 * f(Eigen::Vector2d::Zero());
+			for (int i = 0; i < tris.size(); ++i)
+			{
+				r += integral_triangle(f,
+					Eigen::Vector2d(tris[i][0].x(), tris[i][0].y()),
+					Eigen::Vector2d(tris[i][1].x(), tris[i][1].y()),
+					Eigen::Vector2d(tris[i][2].x(), tris[i][2].y()), rule);
 			}
-
-			delete[] w;
-			delete[] xyz;
-			delete[] xyz2;
-
 			return r;
 		}
+		// Integrates over every cell of a tessellation in parallel, the get_cell_polygons_()
+		// of a _Tessellation2D: out[i] is the integral of f(i, p) over cells[i].
+		template<class F, class R>
+		static void integral_cells(F f, const std::vector<_Polygon>& cells, std::vector<R>& out, const _Quadrature_Rule& rule = triangle_rule())
+		{
+			const int n = cells.size();
+			out.resize(n);
+#pragma omp parallel for schedule(dynamic, 64)
+			for (int i = 0; i < n; ++i)
+			{
+				out[i] = integral_cell([&](const Eigen::Vector2d& p) { return f(i, p); }, cells[i], rule);
+			}
+		}
+		// Integrals of 1, x, y, x^2, xy and y^2 over a simple polygon of either orientation,
+		// in closed form from its edges by Green's theorem. Polynomial integrands of degree
+		// two, the CVT energy and its gradient under a constant density, need no quadrature.
+		static Eigen::Matrix<double, 6, 1> polygon_moments(const _Polygon& poly);
+		// the moments of every cell in parallel, zero for the empty ones
+		static void polygon_moments(const std::vector<_Polygon>& cells, std::vector<Eigen::Matrix<double, 6, 1>>& out);
+		template<class F>
+		static Eigen::VectorXd integral_tetrahedron(F f, const _Point3& p1, const _Point3& p2, const _Point3& p3, const _Point3& p4) 
+		{
+			return integral_tetrahedron(f, p1, p2, p3, p4, tetrahedron_rule());
+		}
+		template<class F>
+		static Eigen::VectorXd integral_tetrahedron(F f, const _Point3& p1, const _Point3& p2, const _Point3& p3, const _Point3& p4, const _Quadrature_Rule& rule) 
+		{
+			const double volume = fabs((p2 - p1).cross_(p3 - p1).dot_(p4 - p1)) / 6.0;
+			const double* b = rule.nodes.data();
+			Eigen::VectorXd r = volume * rule.weights[0] * f(_Point3(
+				b[0] * p1.x() + b[1] * p2.x() + b[2] * p3.x() + b[3] * p4.x(),
+				b[0] * p1.y() + b[1] * p2.y() + b[2] * p3.y() + b[3] * p4.y(),
+				b[0] * p1.z() + b[1] * p2.z() + b[2] * p3.z() + b[3] * p4.z()));
+			for (int i = 1; i < rule.num; ++i) 
+			{
+				b = rule.nodes.data() + 4 * i;
+				r += volume * rule.weights[i] * f(_Point3(
+					b[0] * p1.x() + b[1] * p2.x() + b[2] * p3.x() + b[3] * p4.x(),
+					b[0] * p1.y() + b[1] * p2.y() + b[2] * p3.y() + b[3] * p4.y(),
+					b[0] * p1.z() + b[1] * p2.z() + b[2] * p3.z() + b[3] * p4.z()));
+			}
+			return r;
+		}
+		// Integrates f over a tetrahedron with a rule and the unsigned volume. f maps an
+		// Eigen::Vector3d to R, the result type, so a fixed size Eigen result or a double does
+		// not allocate.
+		template<class F>
+		static auto integral_tetrahedron(F f, const Eigen::Vector3d& p1, const Eigen::Vector3d& p2, const Eigen::Vector3d& p3, const Eigen::Vector3d& p4, const _Quadrature_Rule& rule = tetrahedron_rule())
+			-> typename std::decay<decltype(f(p1))>::type
+		{
+			typedef typename std::decay<decltype(f(p1))>::type R;
+			const double volume = fabs((p2 - p1).cross(p3 - p1).dot(p4 - p1)) / 6.0;
+			const double* b = rule.nodes.data();
+			R r = rule.weights[0] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3 + b[3] * p4));
+			for (int i = 1; i < rule.num; ++i)
+			{
+				b = rule.nodes.data() + 4 * i;
+				r += rule.weights[i] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3 + b[3] * p4));
+			}
+			return volume * r;
+		}
+		// Integrates f over every tetrahedron of a mesh in parallel: out[t] is the integral over
+		// tets[t], computed with the unsigned volume. f maps an Eigen::Vector3d to R; with a fixed
+		// size Eigen result the loop does not allocate.
+		template<class F, class R>
+		static void integral_tetrahedra(F f, const std::vector<Eigen::Vector3d>& vertices, const std::vector<std::array<int, 4>>& tets, std::vector<R>& out, const _Quadrature_Rule& rule = tetrahedron_rule())
+		{
+			const int n = tets.size();
+			out.resize(n);
+#pragma omp parallel for schedule(static)
+			for (int t = 0; t < n; ++t)
+			{
+				const Eigen::Vector3d& p1 = vertices[tets[t][0]];
+				const Eigen::Vector3d& p2 = vertices[tets[t][1]];
+				const Eigen::Vector3d& p3 = vertices[tets[t][2]];
+				const Eigen::Vector3d& p4 = vertices[tets[t][3]];
+				const double volume = fabs((p2 - p1).cross(p3 - p1).dot(p4 - p1)) / 6.0;
+				const double* b = rule.nodes.data();
+				R r = rule.weights[0] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3 + b[3] * p4));
+				for (int i = 1; i < rule.num; ++i)
+				{
+					b = rule.nodes.data() + 4 * i;
+					r += rule.weights[i] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3 + b[3] * p4));
+				}
+				out[t] = volume * r;
+			}
+		}
+		// same for the triangles of a surface mesh
+		template<class F, class R>
+		static void integral_triangles(F f, const std::vector<Eigen::Vector3d>& vertices, const std::vector<std::array<int, 3>>& faces, std::vector<R>& out, const _Quadrature_Rule& rule = triangle_rule())
+		{
+			const int n = faces.size();
+			out.resize(n);
+#pragma omp parallel for schedule(static)
+			for (int t = 0; t < n; ++t)
+			{
+				const Eigen::Vector3d& p1 = vertices[faces[t][0]];
+				const Eigen::Vector3d& p2 = vertices[faces[t][1]];
+				const Eigen::Vector3d& p3 = vertices[faces[t][2]];
+				const double area = (p2 - p1).cross(p3 - p1).norm() * 0.5;
+				const double* b = rule.nodes.data();
+				R r = rule.weights[0] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3));
+				for (int i = 1; i < rule.num; ++i)
+				{
+					b = rule.nodes.data() + 3 * i;
+					r += rule.weights[i] * f(Eigen::Vector3d(b[0] * p1 + b[1] * p2 + b[2] * p3));
+				}
+				out[t] = area * r;
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include "BGAL/Model/ManifoldModel.h"
+#include <vector>
+
+namespace BGAL
+{
+  // Level sets of a piecewise linear scalar field given at the vertices of a _ManifoldModel.
+  // An edge is crossed by the level value when exactly one of its ends is above value, at
+  // the linear interpolation of its ends. The connectivity of the model is flattened once:
+  // every face knows its three undirected edges (the half-edges 2k and 2k + 1 are reverses,
+  // so k identifies both), and every edge its ends and faces. Crossing vertices are then
+  // indexed by edge id, and the faces are processed in parallel.
+  class _Mesh_Contouring
+  {
+  public:
+    _Mesh_Contouring(const _ManifoldModel &in_model);
+    // Polylines of the level value. A closed loop repeats its first point at its end; a
+    // polyline reaching the boundary of the model is open.
+    std::vector<std::vector<_Point3>> isolines_(const std::vector<double> &in_field, const double &in_value) const;
+    // Polylines of every value of in_values, extracted in one pass over the edges.
+    std::vector<std::vector<std::vector<_Point3>>> isolines_(const std::vector<double> &in_field,
+                                                             const std::vector<double> &in_values) const;
+    // Cuts the model along the level value: the first model holds the faces below value,
+    // the second the faces above. Crossed faces are cut into one triangle on one side and
+    // two on the other, with the orientation of the model.
+    std::pair<_ManifoldModel, _ManifoldModel> split_(const std::vector<double> &in_field, const double &in_value) const;
+
+  private:
+    _Point3 crossing_(const std::vector<double> &in_field, const int &eid, const double &in_value) const;
+
+  private:
+    const _ManifoldModel &_model;
+    // undirected edge opposite to every vertex of every face
+    std::vector<int> _face_edges;
+    // the two ends of every undirected edge
+    std::vector<int> _edge_vertices;
+    // the faces on both sides of every edge, -1 on the boundary
+    std::vector<int> _edge_faces;
+  };
+} // namespace BGAL
@@ -116,16 +116,16 @@ namespace BGAL
 			return _name;
 		}
 		void initialization_PQP_();
-		std::tuple<_Point3, double, int> nearest_point_(const _Point3& in_point);
-		double signed_distance_(const _Point3& in_point);
-		double signed_distance_(const _Point3& in_point, _Point3& gradient);
-		bool is_in_(const _Point3& in_point);
+		std::tuple<_Point3, double, int> nearest_point_(const _Point3& in_point) const;
+		double signed_distance_(const _Point3& in_point) const;
+		double signed_distance_(const _Point3& in_point, _Point3& gradient) const;
+		bool is_in_(const _Point3& in_point) const;
 	protected:
 		void read_file_(const std::string& in_file_name);
 		void read_obj_file_(const std::string& in_file_name);
 		void read_off_file_(const std::string& in_file_name);
 		void compute_normal_boundingbox_();
-		_PQP_Query_Resutl proximity_query_(const _Point3& in_point);
+		_PQP_Query_Resutl proximity_query_(const _Point3& in_point) const;
 	protected:
 		std::vector<_MFace> _faces;
 		std::vector<_Point3> _vertices;
@@ -135,6 +135,7 @@ namespace BGAL
 		std::string _name;
 		std::pair<_Point3, _Point3> _bounding_box;
 	private:
-		PQP_Model _pqp_model;
+		// point queries only read the tree, so they are const and can run in parallel
+		mutable PQP_Model _pqp_model;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include "BGAL/Model/Model.h"
+#include <vector>
+
+namespace BGAL
+{
+  // Signed distance of a closed model sampled on a regular grid, negative inside.
+  // The grid is cut into blocks of block_size^3 samples. Blocks within the band of the
+  // surface are stored sample by sample, with exact PQP distances computed in parallel.
+  // Away from the surface the distance comes from a fast sweeping solution of |grad d| = 1
+  // seeded by the band, and the sign from a flood of the outside through the non band
+  // samples. A sparse grid sweeps and stores one value per block, at its middle sample,
+  // and interpolates those inside far blocks; a dense grid stores and sweeps every sample.
+  class _Signed_Distance_Grid
+  {
+  public:
+    static const int block_size = 8;
+    _Signed_Distance_Grid();
+    // in_model.initialization_PQP_() must have been called. in_band is in grid steps
+    // and must be at least 1 for the band to separate the inside from the outside.
+    _Signed_Distance_Grid(_Model &in_model, const double &in_step, const double &in_band = 3.0, const bool &in_dense = false);
+    int size_(const int &axis) const
+    {
+      return _size[axis];
+    }
+    double step_() const
+    {
+      return _step;
+    }
+    const _Point3 &origin_() const
+    {
+      return _origin;
+    }
+    _Point3 position_(const int &i, const int &j, const int &k) const
+    {
+      return _origin + _Point3(i * _step, j * _step, k * _step);
+    }
+    // number of blocks stored sample by sample
+    int number_dense_blocks_() const
+    {
+      return _values.size() / (block_size * block_size * block_size);
+    }
+    int number_exact_queries_() const
+    {
+      return _num_queries;
+    }
+    double value_(const int &i, const int &j, const int &k) const;
+    // trilinear interpolation, clamped to the grid
+    double sample_(const _Point3 &in_point) const;
+    double sample_(const _Point3 &in_point, _Point3 &gradient) const;
+    // value and the point moved onto the surface along the gradient, the field expected by
+    // _Marching_Tetrahedra
+    std::pair<double, _Point3> field_(const _Point3 &in_point) const;
+
+  private:
+    double far_value_(const int &i, const int &j, const int &k, const int &b) const;
+    int block_id_(const int &i, const int &j, const int &k) const
+    {
+      return ((i / block_size) * _num_blocks[1] + j / block_size) * _num_blocks[2] + k / block_size;
+    }
+
+  private:
+    _Point3 _origin;
+    double _step;
+    int _size[3];
+    int _num_blocks[3];
+    double _band;
+    // offset of every block in _values, -1 for far blocks of a sparse grid
+    std::vector<int> _block_offsets;
+    // value at the middle sample of every block
+    std::vector<float> _block_values;
+    std::vector<float> _values;
+    int _num_queries;
+  };
+} // namespace BGAL
@@ -0,0 +1,16 @@
+#pragma once
+#include "BGAL/Model/ManifoldModel.h"
+
+namespace BGAL
+{
+  // Quadric error metric simplification (Garland and Heckbert 1997) of a closed manifold model.
+  // Edges are collapsed to the point minimizing the summed area weighted quadrics of their
+  // ends, cheapest first. A collapse is skipped if it would break the link condition, and so
+  // the manifold, or flip a face; the result is a valid _ManifoldModel.
+  class _Mesh_Simplification
+  {
+  public:
+    // collapses edges until at most in_num_faces faces are left or no valid collapse remains
+    static _ManifoldModel simplify_(const _ManifoldModel &in_model, const int &in_num_faces);
+  };
+} // namespace BGAL
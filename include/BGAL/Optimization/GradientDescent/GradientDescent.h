@@ -1,8 +1,13 @@
 #pragma once
 #include <Eigen/Dense>
-#include <time.h>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 #include <iostream>
+#include "BGAL/Optimization/LineSearch/LineSearch.h"
+#include "BGAL/Optimization/VectorKernel/VectorKernel.h"
 namespace BGAL
 {
   class _GradientDescent
@@ -20,6 +25,11 @@ namespace BGAL
       bool is_show;
       double wolfe;
       double init_step;
+      // sufficient decrease constant and largest step of the More-Thuente search
+      double armijo;
+      double max_step;
+      // false falls back to the bisection search on the weak Wolfe conditions
+      bool more_thuente;
       _Parameter();
     };
     _Parameter _parameter;
@@ -27,6 +37,11 @@ namespace BGAL
     _GradientDescent(const _Parameter &in_parameter);
     template <class fun>
     int minimize(fun &f, Eigen::VectorXd &iterX);
+    // function evaluations of the last minimize call
+    int number_evaluations_() const
+    {
+      return _num_evaluations;
+    }
 
   private:
     template <class fun>
@@ -35,22 +50,41 @@ namespace BGAL
                        Eigen::VectorXd &iterX,
                        Eigen::VectorXd &gradient,
                        double &step,
-                       const Eigen::VectorXd &direction);
+                       const Eigen::VectorXd &direction,
+                       const Eigen::VectorXd &iX);
+    template <class fun>
+    int bisection_search_(fun &f,
+                          double &fval,
+                          Eigen::VectorXd &iterX,
+                          Eigen::VectorXd &gradient,
+                          double &step,
+                          const Eigen::VectorXd &direction,
+                          const Eigen::VectorXd &iX);
+
+  private:
+    int _num_evaluations;
   };
   template <class fun>
   int _GradientDescent::minimize(fun &f, Eigen::VectorXd &iterX)
   {
-    const clock_t start_t = clock();
+    const std::chrono::steady_clock::time_point start_t = std::chrono::steady_clock::now();
     const int n = iterX.size();
+    _num_evaluations = 0;
+    auto counted_f = [&](const Eigen::VectorXd &X, Eigen::VectorXd &g) {
+      ++_num_evaluations;
+      return f(X, g);
+    };
     Eigen::VectorXd gradient = Eigen::VectorXd::Zero(n);
-    double fval = f(iterX, gradient);
+    Eigen::VectorXd oldX(n), oldGradient(n);
+    double fval = counted_f(iterX, gradient);
     Eigen::VectorXd direction = -gradient;
     int k = 0;
     int l = 0;
-    double step = 1.0 / direction.norm();
+    double gnorm = sqrt(_Vector_Kernel::dot_(gradient, gradient));
+    double step = 1.0 / gnorm;
     while (1)
     {
-      if (gradient.norm() < _parameter.epsilon)
+      if (gnorm < _parameter.epsilon)
       {
         if (_parameter.is_show)
         {
@@ -66,7 +100,16 @@ namespace BGAL
         }
         return k;
       }
-      int num_linear = linear_search_(f, fval, iterX, gradient, step, direction);
+      oldX = iterX;
+      oldGradient = gradient;
+      const double old_fval = fval;
+      int num_linear = linear_search_(counted_f, fval, iterX, gradient, step, direction, oldX);
+      if (num_linear == _parameter.max_linearsearch || num_linear < 0)
+      {
+        iterX = oldX;
+        gradient = oldGradient;
+        fval = old_fval;
+      }
       if (num_linear == _parameter.max_linearsearch)
       {
         if (_parameter.is_show)
@@ -85,12 +128,14 @@ namespace BGAL
       }
       l += num_linear;
       k++;
+      gnorm = sqrt(_Vector_Kernel::dot_(gradient, gradient));
       if (_parameter.is_show)
       {
-        std::cout << k << "\t" << l << "\t" << (clock() - start_t) * 1.0 / CLOCKS_PER_SEC << "\t" << gradient.norm()
+        std::cout << k << "\t" << l << "\t"
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start_t).count() << "\t" << gnorm
                   << "\t" << fval << std::endl;
       }
-      direction = -gradient;
+      direction.noalias() = -gradient;
       //step = _parameter.init_step;
     }
   }
@@ -100,7 +145,28 @@ namespace BGAL
                                        Eigen::VectorXd &iterX,
                                        Eigen::VectorXd &gradient,
                                        double &step,
-                                       const Eigen::VectorXd &direction)
+                                       const Eigen::VectorXd &direction,
+                                       const Eigen::VectorXd &iX)
+  {
+    if (!_parameter.more_thuente)
+      return bisection_search_(f, fval, iterX, gradient, step, direction, iX);
+    _More_Thuente::_Parameter mt;
+    mt.armijo = _parameter.armijo;
+    mt.wolfe = _parameter.wolfe;
+    mt.xtol = _parameter.min_xtol;
+    mt.min_step = _parameter.min_step;
+    mt.max_step = _parameter.max_step;
+    mt.max_evaluation = _parameter.max_linearsearch;
+    return _More_Thuente::search_(f, fval, iterX, gradient, step, direction, iX, mt);
+  }
+  template <class fun>
+  int _GradientDescent::bisection_search_(fun &f,
+                                          double &fval,
+                                          Eigen::VectorXd &iterX,
+                                          Eigen::VectorXd &gradient,
+                                          double &step,
+                                          const Eigen::VectorXd &direction,
+                                          const Eigen::VectorXd &iX)
   {
     if (step < 0)
     {
@@ -108,7 +174,6 @@ namespace BGAL
       throw std::runtime_error("error! step<0");
     }
     const double ifval = fval;
-    const Eigen::VectorXd iX = iterX;
     const double idg = gradient.dot(direction);
     if (idg > 0)
     {
@@ -120,7 +185,7 @@ namespace BGAL
     int k = 1;
     while (1)
     {
-      iterX = iX + step * direction;
+      _Vector_Kernel::add_scaled_(iterX, iX, step, direction);
       fval = f(iterX, gradient);
       if (fval > ifval)
       {
@@ -157,7 +222,7 @@ namespace BGAL
         iterX = iX;
         break;
       }
-      step = isinf(step_u) ? 2 * step : 0.5 * (step_l + step_u);
+      step = std::isinf(step_u) ? 2 * step : 0.5 * (step_l + step_u);
     }
     return k;
   }
@@ -1,13 +1,37 @@
 #pragma once
 #include <Eigen/Dense>
-#include <time.h>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <iostream>
+#include "BGAL/Algorithm/Profiler/Profiler.h"
+#include "BGAL/Optimization/LineSearch/LineSearch.h"
+#include "BGAL/Optimization/VectorKernel/VectorKernel.h"
 namespace BGAL
 {
   class _LBFGS
   {
   public:
+    // State reported to _Parameter::callback after the initial evaluation (iteration 0)
+    // and after every accepted step.
+    class _Iteration_Info
+    {
+    public:
+      int iteration;
+      double energy;
+      double gradient_norm;
+      // line-search evaluations of this iteration and of the whole run
+      int linear_search;
+      int total_linear_search;
+      // function evaluations of the whole run, including the initial one
+      int evaluations;
+      // wall-clock seconds since minimize started
+      double time;
+    };
     class _Parameter
     {
     public:
@@ -20,50 +44,157 @@ namespace BGAL
       double epsilon;
       bool is_show;
       double wolfe;
+      // sufficient decrease constant and largest step of the More-Thuente search
+      double armijo;
+      double max_step;
+      // false falls back to the bisection search on the weak Wolfe conditions
+      bool more_thuente;
+      // wall-clock limit in milliseconds, <= 0 for none
       double max_time;
+      // returning false stops the optimization after the current iteration
+      std::function<bool(const _Iteration_Info &)> callback;
+      // the state is written to checkpoint_file every checkpoint_interval iterations,
+      // an empty name for none; checkpoint_data adds data of the caller to it
+      std::string checkpoint_file;
+      int checkpoint_interval;
+      std::function<Eigen::VectorXd()> checkpoint_data;
       _Parameter();
       _Parameter(const _Parameter &in_parameter);
     };
+    // Everything needed to continue a run: the variables, the next search direction, the
+    // step history and the counters.
+    class _Checkpoint
+    {
+    public:
+      int iteration;
+      int total_linear_search;
+      int evaluations;
+      int cursor;
+      double time;
+      double step;
+      Eigen::VectorXd x;
+      Eigen::VectorXd direction;
+      Eigen::MatrixXd s;
+      Eigen::MatrixXd y;
+      Eigen::VectorXd ys;
+      Eigen::VectorXd data;
+    };
     _Parameter _parameter;
     _LBFGS();
     _LBFGS(const _Parameter &in_parameter);
     template <class fun>
     int minimize(fun &f, Eigen::VectorXd &iterX);
+    // continues the run saved in in_file; iterX is overwritten by the saved variables
+    template <class fun>
+    int resume(fun &f, Eigen::VectorXd &iterX, const std::string &in_file);
+    static bool load_checkpoint_(const std::string &in_file, _Checkpoint &out_checkpoint);
+    // function evaluations of the last minimize call
+    int number_evaluations_() const
+    {
+      return _num_evaluations;
+    }
 
   private:
+    void allocate_(const int &n);
+    template <class fun>
+    int iterate_(fun &f, Eigen::VectorXd &iterX, double fval, int k, int l, int cursor, double step,
+                 const std::chrono::steady_clock::time_point &start_t);
+    bool save_checkpoint_(const Eigen::VectorXd &iterX, const int &k, const int &l, const int &cursor,
+                          const std::chrono::steady_clock::time_point &start_t) const;
     template <class fun>
     int linear_search_(fun &f,
                        double &fval,
                        Eigen::VectorXd &iterX,
                        Eigen::VectorXd &gradient,
                        double &step,
-                       const Eigen::VectorXd &direction);
+                       const Eigen::VectorXd &direction,
+                       const Eigen::VectorXd &iX);
+    template <class fun>
+    int bisection_search_(fun &f,
+                          double &fval,
+                          Eigen::VectorXd &iterX,
+                          Eigen::VectorXd &gradient,
+                          double &step,
+                          const Eigen::VectorXd &direction,
+                          const Eigen::VectorXd &iX);
+    bool report_(const int &k, const int &num_linear, const int &l, const double &fval, const double &gnorm,
+                 const std::chrono::steady_clock::time_point &start_t) const;
+
+  private:
+    // the columns of _s and _y form the ring buffer of the last m steps and gradient
+    // changes; all work vectors are allocated once per problem size
+    Eigen::MatrixXd _s;
+    Eigen::MatrixXd _y;
+    Eigen::VectorXd _alpha;
+    Eigen::VectorXd _ys;
+    Eigen::VectorXd _gradient;
+    Eigen::VectorXd _old_x;
+    Eigen::VectorXd _old_gradient;
+    Eigen::VectorXd _direction;
+    int _num_evaluations;
   };
   template <class fun>
   int _LBFGS::minimize(fun &f, Eigen::VectorXd &iterX)
   {
-    const clock_t start_t = clock();
-    const int n = iterX.size();
-    std::vector<Eigen::VectorXd> s(_parameter.m);
-    std::vector<Eigen::VectorXd> y(_parameter.m);
-    Eigen::VectorXd alpha(_parameter.m);
-    Eigen::VectorXd ys(_parameter.m);
-    Eigen::VectorXd gradient = Eigen::VectorXd::Zero(n);
-    Eigen::VectorXd oldX, oldGradient;
-    double fval = f(iterX, gradient);
-    if (_parameter.is_show)
-    {
-      std::cout << 0 << "\t" << 0 << "\t" << (clock() - start_t) * 1.0 / CLOCKS_PER_SEC << "\t" << gradient.norm() << "\t"
-                << fval << std::endl;
-    }
-    Eigen::VectorXd direction = -gradient;
-    int k = 0;
-    int l = 0;
-    int cursor = 0;
-    double step = 1.0 / direction.norm();
+    BGAL_PROFILE_SCOPE("lbfgs");
+    const std::chrono::steady_clock::time_point start_t = std::chrono::steady_clock::now();
+    allocate_(iterX.size());
+    _num_evaluations = 0;
+    auto counted_f = [&](const Eigen::VectorXd &X, Eigen::VectorXd &g) {
+      ++_num_evaluations;
+      BGAL_PROFILE_COUNT("lbfgs/evaluations", 1);
+      return f(X, g);
+    };
+    _gradient.setZero();
+    double fval = counted_f(iterX, _gradient);
+    double gnorm = sqrt(_Vector_Kernel::dot_(_gradient, _gradient));
+    if (!report_(0, 0, 0, fval, gnorm, start_t))
+      return 0;
+    _direction.noalias() = -_gradient;
+    return iterate_(counted_f, iterX, fval, 0, 0, 0, 1.0 / gnorm, start_t);
+  }
+  template <class fun>
+  int _LBFGS::resume(fun &f, Eigen::VectorXd &iterX, const std::string &in_file)
+  {
+    BGAL_PROFILE_SCOPE("lbfgs");
+    _Checkpoint checkpoint;
+    if (!load_checkpoint_(in_file, checkpoint))
+      throw std::runtime_error("can't read the checkpoint " + in_file);
+    if (checkpoint.s.cols() != _parameter.m)
+      throw std::runtime_error("the checkpoint was written with another history size m!");
+    // the time budget continues where the saved run stopped
+    const std::chrono::steady_clock::time_point start_t =
+        std::chrono::steady_clock::now() -
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(checkpoint.time));
+    allocate_(checkpoint.x.size());
+    iterX = checkpoint.x;
+    _direction = checkpoint.direction;
+    _s = checkpoint.s;
+    _y = checkpoint.y;
+    _ys = checkpoint.ys;
+    _num_evaluations = checkpoint.evaluations;
+    auto counted_f = [&](const Eigen::VectorXd &X, Eigen::VectorXd &g) {
+      ++_num_evaluations;
+      BGAL_PROFILE_COUNT("lbfgs/evaluations", 1);
+      return f(X, g);
+    };
+    // evaluated again so that the state kept by f matches iterX
+    _gradient.setZero();
+    double fval = counted_f(iterX, _gradient);
+    return iterate_(counted_f, iterX, fval, checkpoint.iteration, checkpoint.total_linear_search, checkpoint.cursor,
+                    checkpoint.step, start_t);
+  }
+  template <class fun>
+  int _LBFGS::iterate_(fun &counted_f, Eigen::VectorXd &iterX, double fval, int k, int l, int cursor, double step,
+                       const std::chrono::steady_clock::time_point &start_t)
+  {
+    const int m = _parameter.m;
+    Eigen::VectorXd &gradient = _gradient;
+    Eigen::VectorXd &direction = _direction;
+    double gnorm = sqrt(_Vector_Kernel::dot_(gradient, gradient));
     while (1)
     {
-      if (gradient.norm() < _parameter.epsilon)
+      if (gnorm < _parameter.epsilon)
       {
         if (_parameter.is_show)
         {
@@ -71,7 +202,9 @@ namespace BGAL
         }
         return k;
       }
-      if (_parameter.max_time > 0 && _parameter.max_time < (clock() - start_t) * 1000.0 / CLOCKS_PER_SEC)
+      if (_parameter.max_time > 0 &&
+          _parameter.max_time <
+              std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_t).count())
       {
         if (_parameter.is_show)
         {
@@ -87,9 +220,16 @@ namespace BGAL
         }
         return k;
       }
-      oldX = iterX;
-      oldGradient = gradient;
-      int num_linear = linear_search_(f, fval, iterX, gradient, step, direction);
+      _old_x = iterX;
+      _old_gradient = gradient;
+      const double old_fval = fval;
+      int num_linear = linear_search_(counted_f, fval, iterX, gradient, step, direction, _old_x);
+      if (num_linear == _parameter.max_linearsearch || num_linear < 0)
+      {
+        iterX = _old_x;
+        gradient = _old_gradient;
+        fval = old_fval;
+      }
       if (num_linear == _parameter.max_linearsearch)
       {
         if (_parameter.is_show)
@@ -108,45 +248,50 @@ namespace BGAL
       }
       l += num_linear;
       k++;
-      if (_parameter.is_show)
-      {
-        std::cout << k << "\t" << l << "\t" << (clock() - start_t) * 1.0 / CLOCKS_PER_SEC << "\t" << gradient.norm()
-                  << "\t" << fval << std::endl;
-      }
-      s[cursor] = iterX - oldX;
-      y[cursor] = gradient - oldGradient;
-      double _ys = y[cursor].dot(s[cursor]);
-      double _yy = y[cursor].dot(y[cursor]);
-      ys[cursor] = _ys;
-      cursor = (cursor + 1) % _parameter.m;
-      int incr, bound;
-      if (k < _parameter.m)
-      {
-        incr = 0;
-        bound = k;
-      }
-      else
-      {
-        incr = cursor;
-        bound = _parameter.m;
-      }
-      direction = -gradient;
-      int j = cursor;
-
+      gnorm = sqrt(_Vector_Kernel::dot_(gradient, gradient));
+      if (!report_(k, num_linear, l, fval, gnorm, start_t))
+        return k;
+      double _yy;
+      double _ys_ = _Vector_Kernel::difference_(_s.col(cursor), _y.col(cursor), iterX, _old_x, gradient, _old_gradient, _yy);
+      _ys(cursor) = _ys_;
+      cursor = (cursor + 1) % m;
+      int bound = k < m ? k : m;
+      // two-loop recursion; every axpy also computes the dot product needed next
+      direction.noalias() = -gradient;
+      int j = (cursor + m - 1) % m;
+      double dot = _Vector_Kernel::dot_(_s.col(j), direction);
       for (int i = 0; i < bound; i++)
       {
-        j = (j + _parameter.m - 1) % _parameter.m;
-        alpha(j) = s[j].dot(direction) / ys(j);
-        direction = direction - alpha[j] * y[j];
+        _alpha(j) = dot / _ys(j);
+        const int next = (j + m - 1) % m;
+        if (i + 1 < bound)
+          dot = _Vector_Kernel::axpy_dot_(-_alpha(j), _y.col(j), direction, _s.col(next));
+        else
+          _Vector_Kernel::axpy_(-_alpha(j), _y.col(j), direction);
+        j = next;
       }
-      direction = (_ys / _yy) * direction;
+      j = (j + 1) % m;
+      _Vector_Kernel::scale_(_ys_ / _yy, direction);
+      dot = _Vector_Kernel::dot_(_y.col(j), direction);
       for (int i = 0; i < bound; i++)
       {
-        double beta = y[j].dot(direction) / ys(j);
-        direction = direction + (alpha(j) - beta) * s[j];
-        j = (j + 1) % _parameter.m;
+        double beta = dot / _ys(j);
+        const int next = (j + 1) % m;
+        if (i + 1 < bound)
+          dot = _Vector_Kernel::axpy_dot_(_alpha(j) - beta, _s.col(j), direction, _y.col(next));
+        else
+          _Vector_Kernel::axpy_(_alpha(j) - beta, _s.col(j), direction);
+        j = next;
       }
       step = 1.0;
+      if (!_parameter.checkpoint_file.empty() && _parameter.checkpoint_interval > 0 &&
+          k % _parameter.checkpoint_interval == 0)
+      {
+        if (!save_checkpoint_(iterX, k, l, cursor, start_t) && _parameter.is_show)
+        {
+          std::cout << "can't write the checkpoint " << _parameter.checkpoint_file << std::endl;
+        }
+      }
     }
   }
   template <class fun>
@@ -155,7 +300,28 @@ namespace BGAL
                              Eigen::VectorXd &iterX,
                              Eigen::VectorXd &gradient,
                              double &step,
-                             const Eigen::VectorXd &direction)
+                             const Eigen::VectorXd &direction,
+                             const Eigen::VectorXd &iX)
+  {
+    if (!_parameter.more_thuente)
+      return bisection_search_(f, fval, iterX, gradient, step, direction, iX);
+    _More_Thuente::_Parameter mt;
+    mt.armijo = _parameter.armijo;
+    mt.wolfe = _parameter.wolfe;
+    mt.xtol = _parameter.min_xtol;
+    mt.min_step = _parameter.min_step;
+    mt.max_step = _parameter.max_step;
+    mt.max_evaluation = _parameter.max_linearsearch;
+    return _More_Thuente::search_(f, fval, iterX, gradient, step, direction, iX, mt);
+  }
+  template <class fun>
+  int _LBFGS::bisection_search_(fun &f,
+                                double &fval,
+                                Eigen::VectorXd &iterX,
+                                Eigen::VectorXd &gradient,
+                                double &step,
+                                const Eigen::VectorXd &direction,
+                                const Eigen::VectorXd &iX)
   {
     if (step < 0)
     {
@@ -163,7 +329,6 @@ namespace BGAL
       throw std::runtime_error("error! step<0");
     }
     const double ifval = fval;
-    const Eigen::VectorXd iX = iterX;
     const double idg = gradient.dot(direction);
     if (idg > 0)
     {
@@ -175,7 +340,7 @@ namespace BGAL
     int k = 1;
     while (1)
     {
-      iterX = iX + step * direction;
+      _Vector_Kernel::add_scaled_(iterX, iX, step, direction);
       fval = f(iterX, gradient);
       if (fval > ifval)
       {
@@ -212,7 +377,7 @@ namespace BGAL
         iterX = iX;
         break;
       }
-      step = isinf(step_u) ? 2 * step : 0.5 * (step_l + step_u);
+      step = std::isinf(step_u) ? 2 * step : 0.5 * (step_l + step_u);
       //step /= 10;
     }
     return k;
@@ -0,0 +1,149 @@
+#pragma once
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "BGAL/Optimization/VectorKernel/VectorKernel.h"
+
+namespace BGAL
+{
+  // Line search of More and Thuente (ACM TOMS 20(3), 1994) for the strong Wolfe
+  // conditions
+  //   f(x0 + t d) <= f(x0) + armijo * t * g0.d,   |g(x0 + t d).d| <= wolfe * |g0.d|.
+  // The trial steps come from safeguarded cubic and quadratic interpolation of the
+  // function values and directional derivatives seen so far, so a well scaled
+  // direction usually needs one or two evaluations.
+  class _More_Thuente
+  {
+  public:
+    class _Parameter
+    {
+    public:
+      double armijo;
+      double wolfe;
+      // relative width of the interval of uncertainty at which the search gives up
+      double xtol;
+      double min_step;
+      double max_step;
+      int max_evaluation;
+      _Parameter();
+    };
+    // Searches along direction from x0, whose value and gradient are fval and
+    // gradient on entry. On success x, fval and gradient hold the accepted point and
+    // the number of evaluations is returned; max_evaluation is returned if the
+    // evaluations run out and -1 for any other failure. x, fval and gradient are
+    // left at the last trial point on failure.
+    template <class fun>
+    static int search_(fun &f,
+                       double &fval,
+                       Eigen::VectorXd &x,
+                       Eigen::VectorXd &gradient,
+                       double &step,
+                       const Eigen::VectorXd &direction,
+                       const Eigen::VectorXd &x0,
+                       const _Parameter &in_parameter);
+
+  private:
+    // Updates the interval [x, y] with the trial step t and moves t to the next trial
+    // step; returns false if the arguments are inconsistent (rounding errors).
+    static bool update_interval_(double &x, double &fx, double &dx,
+                                 double &y, double &fy, double &dy,
+                                 double &t, const double &ft, const double &dt,
+                                 const double &tmin, const double &tmax, bool &brackt);
+  };
+  template <class fun>
+  int _More_Thuente::search_(fun &f,
+                             double &fval,
+                             Eigen::VectorXd &x,
+                             Eigen::VectorXd &gradient,
+                             double &step,
+                             const Eigen::VectorXd &direction,
+                             const Eigen::VectorXd &x0,
+                             const _Parameter &in_parameter)
+  {
+    if (step <= 0)
+      throw std::runtime_error("error! step<=0");
+    const double dginit = _Vector_Kernel::dot_(gradient, direction);
+    if (dginit > 0)
+      throw std::runtime_error("error! direction is not a decline direction!");
+    const double finit = fval;
+    const double dgtest = in_parameter.armijo * dginit;
+    bool brackt = false;
+    bool stage1 = true;
+    bool consistent = true;
+    double width = in_parameter.max_step - in_parameter.min_step;
+    double prev_width = 2 * width;
+    // stx: best step so far, sty: other end of the interval
+    double stx = 0, fx = finit, dgx = dginit;
+    double sty = 0, fy = finit, dgy = dginit;
+    int count = 0;
+    while (1)
+    {
+      double stmin, stmax;
+      if (brackt)
+      {
+        stmin = std::min(stx, sty);
+        stmax = std::max(stx, sty);
+      }
+      else
+      {
+        stmin = stx;
+        stmax = step + 4 * (step - stx);
+      }
+      step = std::max(step, in_parameter.min_step);
+      step = std::min(step, in_parameter.max_step);
+      // fall back to the best step if the search can't make any more progress
+      if ((brackt && (step <= stmin || stmax <= step || in_parameter.max_evaluation <= count + 1 || !consistent)) ||
+          (brackt && stmax - stmin <= in_parameter.xtol * stmax))
+      {
+        step = stx;
+      }
+      _Vector_Kernel::add_scaled_(x, x0, step, direction);
+      fval = f(x, gradient);
+      const double dg = _Vector_Kernel::dot_(gradient, direction);
+      const double ftest = finit + step * dgtest;
+      ++count;
+      if (brackt && (step <= stmin || stmax <= step || !consistent))
+        return -1;
+      if (step == in_parameter.max_step && fval <= ftest && dg <= dgtest)
+        return -1;
+      if (step == in_parameter.min_step && (ftest < fval || dgtest <= dg))
+        return -1;
+      if (brackt && stmax - stmin <= in_parameter.xtol * stmax)
+        return -1;
+      if (in_parameter.max_evaluation <= count)
+        return in_parameter.max_evaluation;
+      if (fval <= ftest && fabs(dg) <= in_parameter.wolfe * (-dginit))
+        return count;
+      if (stage1 && fval <= ftest && std::min(in_parameter.armijo, in_parameter.wolfe) * dginit <= dg)
+        stage1 = false;
+      if (stage1 && ftest < fval && fval <= fx)
+      {
+        // modified function psi(t) = f(t) - f(0) - armijo * t * g0.d
+        double fm = fval - step * dgtest;
+        double fxm = fx - stx * dgtest;
+        double fym = fy - sty * dgtest;
+        double dgm = dg - dgtest;
+        double dgxm = dgx - dgtest;
+        double dgym = dgy - dgtest;
+        consistent = update_interval_(stx, fxm, dgxm, sty, fym, dgym, step, fm, dgm, stmin, stmax, brackt);
+        fx = fxm + stx * dgtest;
+        fy = fym + sty * dgtest;
+        dgx = dgxm + dgtest;
+        dgy = dgym + dgtest;
+      }
+      else
+      {
+        consistent = update_interval_(stx, fx, dgx, sty, fy, dgy, step, fval, dg, stmin, stmax, brackt);
+      }
+      // force a sufficient shrinking of the interval
+      if (brackt)
+      {
+        if (0.66 * prev_width <= fabs(sty - stx))
+          step = stx + 0.5 * (sty - stx);
+        prev_width = width;
+        width = fabs(sty - stx);
+      }
+    }
+  }
+} // namespace BGAL
@@ -0,0 +1,38 @@
+#pragma once
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+  // BLAS-1 kernels of the first-order optimizers. Vectors with at least
+  // parallel_size entries are processed by all OpenMP threads, the fused kernels
+  // read every operand only once.
+  class _Vector_Kernel
+  {
+  public:
+    static const int parallel_size = 1 << 16;
+    // a . b
+    static double dot_(const Eigen::Ref<const Eigen::VectorXd> &a, const Eigen::Ref<const Eigen::VectorXd> &b);
+    // y += a * x
+    static void axpy_(const double &a, const Eigen::Ref<const Eigen::VectorXd> &x, Eigen::Ref<Eigen::VectorXd> y);
+    // y += a * x, then returns z . y
+    static double axpy_dot_(const double &a,
+                            const Eigen::Ref<const Eigen::VectorXd> &x,
+                            Eigen::Ref<Eigen::VectorXd> y,
+                            const Eigen::Ref<const Eigen::VectorXd> &z);
+    // out = x + a * d
+    static void add_scaled_(Eigen::Ref<Eigen::VectorXd> out,
+                            const Eigen::Ref<const Eigen::VectorXd> &x,
+                            const double &a,
+                            const Eigen::Ref<const Eigen::VectorXd> &d);
+    // y *= a
+    static void scale_(const double &a, Eigen::Ref<Eigen::VectorXd> y);
+    // s = x - old_x, y = g - old_g; returns y . s and stores y . y in out_yy
+    static double difference_(Eigen::Ref<Eigen::VectorXd> s,
+                              Eigen::Ref<Eigen::VectorXd> y,
+                              const Eigen::Ref<const Eigen::VectorXd> &x,
+                              const Eigen::Ref<const Eigen::VectorXd> &old_x,
+                              const Eigen::Ref<const Eigen::VectorXd> &g,
+                              const Eigen::Ref<const Eigen::VectorXd> &old_g,
+                              double &out_yy);
+  };
+} // namespace BGAL
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+	// Feature-preserving point-cloud denoising in two stages on a fixed CSR
+	// neighbourhood graph.
+	// 1. Bilateral normal filtering, repeated normal_iteration times:
+	//      n_i <- normalize(sum_j ws(|p_i - p_j|) wr(|n_i - n_j|) n_j),
+	//    with Gaussian kernels ws (width sigma_s) and wr (width sigma_r); n_j is flipped
+	//    to the side of n_i first.
+	// 2. Position update onto the filtered tangent planes, repeated position_iteration times:
+	//      p_i <- p_i + step * sum_j w_ij (((p_j - p_i) . n_j) n_j + ((p_j - p_i) . n_i) n_i) / (2 sum_j w_ij).
+	//    Averaging the planes of p_j and p_i cancels the first-order shrinking/growing on
+	//    curved parts.
+	// Every iteration reads one buffer and writes the other, so all points are updated
+	// in parallel without races. sigma_s <= 0 uses the mean neighbour distance of each point.
+	class _PointCloudDenoiser
+	{
+	public:
+		class _Parameter
+		{
+		public:
+			int k;
+			int normal_iteration;
+			int position_iteration;
+			double sigma_s;
+			double sigma_r;
+			double step;
+			_Parameter();
+		};
+		_Parameter _parameter;
+		_PointCloudDenoiser();
+		_PointCloudDenoiser(const _Parameter& in_parameter);
+		// Builds the k-nearest neighbourhood graph with _Neighborhood and denoises.
+		void denoise_(const std::vector<Eigen::Vector3d>& in_points,
+		              const std::vector<Eigen::Vector3d>& in_normals);
+		void denoise_(const std::vector<Eigen::Vector3d>& in_points,
+		              const std::vector<Eigen::Vector3d>& in_normals,
+		              const std::vector<int>& in_offsets,
+		              const std::vector<int>& in_indices);
+		const std::vector<Eigen::Vector3d>& get_points_() const
+		{
+			return _points;
+		}
+		const std::vector<Eigen::Vector3d>& get_normals_() const
+		{
+			return _normals;
+		}
+		// Wall-clock time of the last denoise_ call in seconds, without the graph build.
+		double time_() const
+		{
+			return _time;
+		}
+		double points_per_second_() const
+		{
+			return _time > 0 ? _points.size() / _time : 0;
+		}
+	private:
+		std::vector<Eigen::Vector3d> _points;
+		std::vector<Eigen::Vector3d> _normals;
+		double _time;
+	};
+} // namespace BGAL
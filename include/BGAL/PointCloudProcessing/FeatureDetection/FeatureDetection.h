@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+	// Per-point two-normal clustering used to tell smooth points from sharp-feature
+	// candidates. For every point the normals of its neighbourhood are split into two
+	// balanced clusters,
+	//   min sum_j x_j |N_j - n1|^2 + (1 - x_j) |N_j - n2|^2,  sum_j x_j = k / 2,  0 <= x_j <= 1,
+	// and the point is smooth when the two cluster normals n1, n2 (nearly) coincide.
+	// Neighbourhoods are given in CSR form: the neighbours of point i are
+	// indices[offsets[i]] ... indices[offsets[i + 1] - 1].
+	class _Feature_Detection
+	{
+	public:
+		class _Parameter
+		{
+		public:
+			int min_neighbors;
+			int max_iteration;
+			double smooth_threshold;
+			_Parameter();
+		};
+		_Parameter _parameter;
+		_Feature_Detection();
+		_Feature_Detection(const _Parameter& in_parameter);
+		void detect_(const std::vector<Eigen::Vector3d>& in_normals,
+		             const std::vector<int>& in_offsets,
+		             const std::vector<int>& in_indices);
+		inline int number_points_() const
+		{
+			return _is_valid.size();
+		}
+		// 1 if the point had at least min_neighbors neighbours and was processed.
+		const std::vector<int>& get_is_valid_() const
+		{
+			return _is_valid;
+		}
+		// 1 for smooth points, 0 for feature candidates and skipped points.
+		const std::vector<int>& get_is_smooth_() const
+		{
+			return _is_smooth;
+		}
+		const std::vector<Eigen::Vector3d>& get_normals1_() const
+		{
+			return _normals1;
+		}
+		const std::vector<Eigen::Vector3d>& get_normals2_() const
+		{
+			return _normals2;
+		}
+		// Clustering energy of every point, 0 for skipped points.
+		const std::vector<double>& get_energies_() const
+		{
+			return _energies;
+		}
+		// Solves the clustering problem for one neighbourhood. d and order are scratch
+		// buffers with room for k entries, so the call itself never allocates.
+		static double two_normals_(const std::vector<Eigen::Vector3d>& in_normals,
+		                           const int* in_neighbors,
+		                           const int& k,
+		                           const int& max_iteration,
+		                           double* d,
+		                           int* order,
+		                           Eigen::Vector3d& n1,
+		                           Eigen::Vector3d& n2);
+	private:
+		std::vector<int> _is_valid;
+		std::vector<int> _is_smooth;
+		std::vector<Eigen::Vector3d> _normals1;
+		std::vector<Eigen::Vector3d> _normals2;
+		std::vector<double> _energies;
+	};
+} // namespace BGAL
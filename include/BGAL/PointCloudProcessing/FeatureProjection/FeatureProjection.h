@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+	// Moves sharp-feature candidates onto the intersection of the tangent planes of
+	// their neighbours. For a candidate P_i with neighbours (P_j, n_j) the new position
+	// minimizes
+	//   sum_j (n_j . (P_j - z))^2 + mu |P_i - z|^2,
+	// i.e. solves the 3x3 normal equations
+	//   (sum_j n_j n_j^T + mu I) z = sum_j (n_j . P_j) n_j + mu P_i.
+	// The systems are assembled and solved in blocks; nearly singular systems fall back
+	// to a truncated eigen-decomposition that returns the smallest displacement.
+	// Neighbourhoods use the same CSR layout as _Feature_Detection.
+	class _Feature_Projection
+	{
+	public:
+		class _Parameter
+		{
+		public:
+			double mu;
+			double min_displacement;
+			double max_displacement;
+			double degenerate_eps;
+			int block_size;
+			_Parameter();
+		};
+		_Parameter _parameter;
+		_Feature_Projection();
+		_Feature_Projection(const _Parameter& in_parameter);
+		// in_is_candidate[i] != 0 marks the points to project; the others are copied.
+		void project_(const std::vector<Eigen::Vector3d>& in_points,
+		              const std::vector<Eigen::Vector3d>& in_normals,
+		              const std::vector<int>& in_offsets,
+		              const std::vector<int>& in_indices,
+		              const std::vector<int>& in_is_candidate);
+		const std::vector<Eigen::Vector3d>& get_points_() const
+		{
+			return _points;
+		}
+		// 1 if the candidate moved by more than min_displacement and, when
+		// max_displacement > 0, by no more than max_displacement.
+		const std::vector<int>& get_is_projected_() const
+		{
+			return _is_projected;
+		}
+		int number_projected_() const
+		{
+			return _num_projected;
+		}
+		int number_degenerate_() const
+		{
+			return _num_degenerate;
+		}
+		// Solves the symmetric system [a00 a01 a02; a01 a11 a12; a02 a12 a22] z = b by
+		// eigen-decomposition, dropping eigenvalues below eps * lambda_max. The returned
+		// z is the solution closest to in_origin.
+		static Eigen::Vector3d solve_degenerate_(const double* a, const Eigen::Vector3d& b,
+		                                         const Eigen::Vector3d& in_origin, const double& eps);
+	private:
+		std::vector<Eigen::Vector3d> _points;
+		std::vector<int> _is_projected;
+		int _num_projected;
+		int _num_degenerate;
+	};
+} // namespace BGAL
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+	// Chunked point-cloud reader. Supported formats:
+	//   .ply                       ascii or binary_little_endian, vertex x y z [nx ny nz];
+	//                              other vertex properties and elements after the vertices are skipped;
+	//   anything else (.xyz, .txt) one point per line, "x y z" or "x y z nx ny nz".
+	// Every read_ consumes about chunk_bytes of the file, so memory stays bounded no
+	// matter how large the file is. ASCII chunks are parsed in parallel.
+	class _PointCloud_Reader
+	{
+	public:
+		_PointCloud_Reader();
+		explicit _PointCloud_Reader(const std::string& in_file_name, const size_t& in_chunk_bytes = 64 << 20);
+		~_PointCloud_Reader();
+		void open_(const std::string& in_file_name, const size_t& in_chunk_bytes = 64 << 20);
+		void close_();
+		inline bool has_normals_() const
+		{
+			return _has_normals;
+		}
+		// Number of points announced by a PLY header, -1 for XYZ files.
+		inline long long number_points_() const
+		{
+			return _num_points;
+		}
+		// Replaces points/normals with the next chunk and returns its size, 0 at the end
+		// of the file. normals stay empty if the file has none.
+		int read_(std::vector<Eigen::Vector3d>& out_points, std::vector<Eigen::Vector3d>& out_normals);
+	private:
+		enum class _Format
+		{
+			XYZ,
+			PLY_ASCII,
+			PLY_BINARY
+		};
+		void read_ply_header_();
+		int parse_ascii_(const char* in_begin, const char* in_end,
+		                 std::vector<Eigen::Vector3d>& out_points, std::vector<Eigen::Vector3d>& out_normals) const;
+	private:
+		std::ifstream _in;
+		_Format _format;
+		size_t _chunk_bytes;
+		bool _has_normals;
+		long long _num_points;
+		long long _num_read;
+		// ascii: columns of x y z nx ny nz and the number of columns of a line
+		int _columns[6];
+		int _num_columns;
+		// binary: byte offset and type code of x y z nx ny nz, size of one vertex
+		int _offsets[6];
+		int _types[6];
+		int _stride;
+		std::string _rest;
+		std::vector<char> _buffer;
+	};
+
+	// Chunked point-cloud writer: .ply is written as binary little endian with double
+	// coordinates, anything else as ASCII "x y z [nx ny nz]" lines formatted in parallel.
+	// The PLY vertex count is patched in close_().
+	class _PointCloud_Writer
+	{
+	public:
+		_PointCloud_Writer();
+		_PointCloud_Writer(const std::string& in_file_name, const bool& in_with_normals);
+		~_PointCloud_Writer();
+		void open_(const std::string& in_file_name, const bool& in_with_normals);
+		void write_(const std::vector<Eigen::Vector3d>& in_points, const std::vector<Eigen::Vector3d>& in_normals);
+		void close_();
+		// digits after the decimal point of ASCII output
+		int _precision;
+	private:
+		std::ofstream _out;
+		bool _is_ply;
+		bool _with_normals;
+		long long _num_written;
+		std::streampos _count_pos;
+	};
+
+	class _PointCloud_IO
+	{
+	public:
+		static void read_(const std::string& in_file_name,
+		                  std::vector<Eigen::Vector3d>& out_points, std::vector<Eigen::Vector3d>& out_normals);
+		// in_normals may be empty.
+		static void write_(const std::string& in_file_name,
+		                   const std::vector<Eigen::Vector3d>& in_points, const std::vector<Eigen::Vector3d>& in_normals);
+	};
+} // namespace BGAL
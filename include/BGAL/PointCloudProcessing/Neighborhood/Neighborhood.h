@@ -0,0 +1,95 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <Eigen/Dense>
+#include "BGAL/BaseShape/Point.h"
+#include "BGAL/BaseShape/KDTree.h"
+
+namespace BGAL
+{
+	// Per-point adaptive neighbourhoods of a point cloud. The neighbourhood of point i
+	// holds every point within
+	//   r_i = max(radius, distance to the k-th nearest point),
+	// so each point gets at least k neighbours (k-NN in sparse regions, a fixed radius
+	// elsewhere), sorted by distance and optionally capped at max_k. All points are
+	// queried in one parallel pass over a _KDTree and the result is stored in CSR form:
+	// the neighbours of point i are indices[offsets[i]] ... indices[offsets[i + 1] - 1].
+	// When radius_rule is set it picks the global radius from the k-NN distances of all
+	// points instead, found in the same pass.
+	class _Neighborhood
+	{
+	public:
+		class _Parameter
+		{
+		public:
+			int k;
+			double radius;
+			int max_k;
+			bool include_self;
+			int block_size;
+			std::function<double(const std::vector<double>&)> radius_rule;
+			_Parameter();
+		};
+		_Parameter _parameter;
+		_Neighborhood();
+		_Neighborhood(const _Parameter& in_parameter);
+		void build_(const std::vector<_Point3>& in_points);
+		void build_(const std::vector<Eigen::Vector3d>& in_points);
+		// in_tree must have been built from in_points.
+		void build_(const _KDTree& in_tree, const std::vector<_Point3>& in_points);
+		inline int number_points_() const
+		{
+			return _radii.size();
+		}
+		inline int number_neighbors_(const int& in_id) const
+		{
+			return _offsets[in_id + 1] - _offsets[in_id];
+		}
+		inline const int* neighbors_(const int& in_id) const
+		{
+			return _indices.data() + _offsets[in_id];
+		}
+		const std::vector<int>& get_offsets_() const
+		{
+			return _offsets;
+		}
+		const std::vector<int>& get_indices_() const
+		{
+			return _indices;
+		}
+		// The adaptive radius r_i of every point.
+		const std::vector<double>& get_radii_() const
+		{
+			return _radii;
+		}
+		int min_neighbors_() const
+		{
+			return _min_k;
+		}
+		int max_neighbors_() const
+		{
+			return _max_k;
+		}
+		double mean_neighbors_() const
+		{
+			return _mean_k;
+		}
+		double max_radius_() const
+		{
+			return _max_radius;
+		}
+		double mean_radius_() const
+		{
+			return _mean_radius;
+		}
+	private:
+		std::vector<int> _offsets;
+		std::vector<int> _indices;
+		std::vector<double> _radii;
+		int _min_k;
+		int _max_k;
+		double _mean_k;
+		double _max_radius;
+		double _mean_radius;
+	};
+} // namespace BGAL
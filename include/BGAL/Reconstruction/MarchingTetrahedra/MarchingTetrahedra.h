@@ -1,4 +1,5 @@
 #pragma once
+#include "BGAL/Algorithm/Profiler/Profiler.h"
 #include "BGAL/BaseShape/Point.h"
 #include "BGAL/Model/ManifoldModel.h"
 #include <tuple>
@@ -14,13 +15,37 @@ namespace BGAL
     _Marching_Tetrahedra(const std::pair<_Point3, _Point3> &in_boundingbox, const int &in_depth);
     template <class F>
     _ManifoldModel reconstruction_(const F &sign);
+    // Narrow band variant on an octree of cubes with 2^depth cubes per side at the finest
+    // level. A cube is refined where the field changes sign at its corners or where |f| at
+    // a corner is below in_band times its diagonal, so in_band no smaller than the Lipschitz
+    // constant of the field (1 for a distance) never misses the surface. Finest cubes split
+    // into the six tetrahedra around their main diagonal, which match across cubes, and the
+    // band is closed by following the sign changes through the faces, so the surface is
+    // watertight. The field is evaluated level by level in parallel and must be thread safe.
+    template <class F>
+    _ManifoldModel adaptive_reconstruction_(const F &sign, const double &in_band = 1.0);
     void set_method_(const int &m)
     {
       _method = m;
     }
+    // number of field evaluations made by the last adaptive reconstruction
+    int number_evaluations_() const
+    {
+      return _num_evaluations;
+    }
 
   private:
     void tiling_();
+    void adaptive_tiling_(const std::function<double(const _Point3 &)> &field,
+                          const double &in_band,
+                          std::vector<_Point3> &out_vertices,
+                          std::vector<std::tuple<int, int, int, int>> &out_tetras,
+                          std::vector<double> &out_values);
+    template <class F>
+    _ManifoldModel polygonize_(const F &sign,
+                               const std::vector<_Point3> &in_vertices,
+                               const std::vector<std::tuple<int, int, int, int>> &in_tetras,
+                               const std::vector<double> &signs);
 
   private:
     std::pair<_Point3, _Point3> _boundingbox;
@@ -28,38 +53,69 @@ namespace BGAL
     std::vector<_Point3> _tetra_vertices;
     std::vector<std::tuple<int, int, int, int>> _tetras;
     int _method;
+    int _num_evaluations;
   };
   template <class F>
   _ManifoldModel _Marching_Tetrahedra::reconstruction_(const F &sign)
   {
+    BGAL_PROFILE_SCOPE("marching_tetrahedra");
+    BGAL_PROFILE_BEGIN(tiling, "tiling");
+    if (_tetras.empty())
+      tiling_();
+    BGAL_PROFILE_END(tiling);
+    BGAL_PROFILE_BEGIN(signs, "signs");
     std::vector<double> signs(_tetra_vertices.size());
     for (int i = 0; i < _tetra_vertices.size(); ++i)
     {
       signs[i] = sign(_tetra_vertices[i]).first;
     }
+    BGAL_PROFILE_END(signs);
+    return polygonize_(sign, _tetra_vertices, _tetras, signs);
+  }
+  template <class F>
+  _ManifoldModel _Marching_Tetrahedra::adaptive_reconstruction_(const F &sign, const double &in_band)
+  {
+    BGAL_PROFILE_SCOPE("marching_tetrahedra");
+    BGAL_PROFILE_BEGIN(tiling, "adaptive_tiling");
+    std::vector<_Point3> vertices;
+    std::vector<std::tuple<int, int, int, int>> tetras;
+    std::vector<double> signs;
+    adaptive_tiling_([&sign](const _Point3 &p)
+                     { return sign(p).first; },
+                     in_band, vertices, tetras, signs);
+    BGAL_PROFILE_END(tiling);
+    return polygonize_(sign, vertices, tetras, signs);
+  }
+  template <class F>
+  _ManifoldModel _Marching_Tetrahedra::polygonize_(const F &sign,
+                                                   const std::vector<_Point3> &in_vertices,
+                                                   const std::vector<std::tuple<int, int, int, int>> &in_tetras,
+                                                   const std::vector<double> &signs)
+  {
+    BGAL_PROFILE_SCOPE("polygonize");
     std::vector<_Point3> _vertices;
     std::map<std::pair<int, int>, int> from_edge_to_vertex;
     std::vector<std::tuple<int, int, int>> tris;
-    for (int i = 0; i < _tetras.size(); ++i)
+    for (int i = 0; i < in_tetras.size(); ++i)
     {
       std::vector<int> negetive;
       std::vector<int> positive;
-      if (signs[std::get<0>(_tetras[i])] < 0)
-        negetive.push_back(std::get<0>(_tetras[i]));
+      if (signs[std::get<0>(in_tetras[i])] < 0)
+        negetive.push_back(std::get<0>(in_tetras[i]));
       else
-        positive.push_back(std::get<0>(_tetras[i]));
-      if (signs[std::get<1>(_tetras[i])] < 0)
-        negetive.push_back(std::get<1>(_tetras[i]));
+        positive.push_back(std::get<0>(in_tetras[i]));
+      if (signs[std::get<1>(in_tetras[i])] < 0)
+        negetive.push_back(std::get<1>(in_tetras[i]));
       else
-        positive.push_back(std::get<1>(_tetras[i]));
-      if (signs[std::get<2>(_tetras[i])] < 0)
-        negetive.push_back(std::get<2>(_tetras[i]));
+        positive.push_back(std::get<1>(in_tetras[i]));
+      if (signs[std::get<2>(in_tetras[i])] < 0)
+        negetive.push_back(std::get<2>(in_tetras[i]));
       else
-        positive.push_back(std::get<2>(_tetras[i]));
-      if (signs[std::get<3>(_tetras[i])] < 0)
-        negetive.push_back(std::get<3>(_tetras[i]));
+        positive.push_back(std::get<2>(in_tetras[i]));
+      if (signs[std::get<3>(in_tetras[i])] < 0)
+        negetive.push_back(std::get<3>(in_tetras[i]));
       else
-        positive.push_back(std::get<3>(_tetras[i]));
+        positive.push_back(std::get<3>(in_tetras[i]));
       if (negetive.size() == 1)
       {
         std::vector<int> tri_v;
@@ -83,14 +139,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -99,7 +155,7 @@ namespace BGAL
           }
           tri_v.push_back(from_edge_to_vertex[std::make_pair(v0, v1)]);
         }
-        if (negetive[0] == std::get<3>(_tetras[i]) || negetive[0] == std::get<1>(_tetras[i]))
+        if (negetive[0] == std::get<3>(in_tetras[i]) || negetive[0] == std::get<1>(in_tetras[i]))
         {
           tris.push_back(std::make_tuple(tri_v[2], tri_v[1], tri_v[0]));
         }
@@ -131,14 +187,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -147,7 +203,7 @@ namespace BGAL
           }
           tri_v.push_back(from_edge_to_vertex[std::make_pair(v0, v1)]);
         }
-        if (positive[0] == std::get<3>(_tetras[i]) || positive[0] == std::get<1>(_tetras[i]))
+        if (positive[0] == std::get<3>(in_tetras[i]) || positive[0] == std::get<1>(in_tetras[i]))
         {
           tris.push_back(std::make_tuple(tri_v[0], tri_v[1], tri_v[2]));
         }
@@ -159,7 +215,7 @@ namespace BGAL
       else if (negetive.size() == 2)
       {
         std::vector<int> tri_v;
-        if (negetive[1] == std::get<3>(_tetras[i]))
+        if (negetive[1] == std::get<3>(in_tetras[i]))
         {
           int v0, v1;
           if (negetive[1] < positive[0])
@@ -179,14 +235,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -211,14 +267,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -243,14 +299,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -275,14 +331,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -290,7 +346,7 @@ namespace BGAL
             }
           }
           tri_v.push_back(from_edge_to_vertex[std::make_pair(v0, v1)]);
-          if (negetive[0] == std::get<1>(_tetras[i]))
+          if (negetive[0] == std::get<1>(in_tetras[i]))
           {
             tris.push_back(std::make_tuple(tri_v[3], tri_v[2], tri_v[1]));
             tris.push_back(std::make_tuple(tri_v[3], tri_v[1], tri_v[0]));
@@ -321,14 +377,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -353,14 +409,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -385,14 +441,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -417,14 +473,14 @@ namespace BGAL
             {
             case 0:
             {
-              _vertices.push_back(sign((_tetra_vertices[v0] + _tetra_vertices[v1]) * 0.5).second);
+              _vertices.push_back(sign((in_vertices[v0] + in_vertices[v1]) * 0.5).second);
               break;
             }
             case 1:
             {
               double len = fabs(signs[v0]) + fabs(signs[v1]);
               _vertices.push_back(
-                  _tetra_vertices[v0] * fabs(signs[v1]) / len + _tetra_vertices[v1] * fabs(signs[v0] / len));
+                  in_vertices[v0] * fabs(signs[v1]) / len + in_vertices[v1] * fabs(signs[v0] / len));
               break;
             }
             default:
@@ -432,7 +488,7 @@ namespace BGAL
             }
           }
           tri_v.push_back(from_edge_to_vertex[std::make_pair(v0, v1)]);
-          if (positive[0] == std::get<1>(_tetras[i]))
+          if (positive[0] == std::get<1>(in_tetras[i]))
           {
             tris.push_back(std::make_tuple(tri_v[0], tri_v[1], tri_v[2]));
             tris.push_back(std::make_tuple(tri_v[0], tri_v[2], tri_v[3]));
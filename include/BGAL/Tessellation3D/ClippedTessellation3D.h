@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <array>
+#include <tuple>
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Regular_triangulation_3.h>
+#include <CGAL/Regular_triangulation_cell_base_3.h>
+#include <CGAL/Triangulation_vertex_base_with_info_3.h>
+
+#include "BGAL/BaseShape/Point.h"
+#include "BGAL/Model/ManifoldModel.h"
+#include "BGAL/Tessellation3D/Tessellation3D.h"
+
+namespace BGAL
+{
+  // Power diagram of weighted sites clipped against a closed volume.
+  // The volume is a set of domain tetrahedra whose orientation is their sign: a tet mesh
+  // has positive tetrahedra only. The cone decomposition of a closed _ManifoldModel has
+  // one tetrahedron from the center of its bounding box to every face, with negative ones
+  // where the surface folds back, and their signed sum is exactly the enclosed volume.
+  // Every domain tetrahedron is clipped by the cells it overlaps, found by a flood over
+  // the Delaunay neighbours, and the domain tetrahedra are processed in parallel.
+  // Cells are stored as tetrahedra with the same convention: an integral over a cell is
+  // the sum of the integrals over its tetrahedra times the sign of their volume.
+  class _Clipped_Tessellation3D
+  {
+    typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+    typedef K::FT Weight;
+    typedef K::Point_3 Point;
+    typedef K::Weighted_point_3 Weighted_point;
+    typedef CGAL::Regular_triangulation_vertex_base_3<K> Vb0;
+    typedef CGAL::Triangulation_vertex_base_with_info_3<int, K, Vb0> Vb;
+    typedef CGAL::Regular_triangulation_cell_base_3<K> Cb;
+    typedef CGAL::Triangulation_data_structure_3<Vb, Cb> Tds;
+    typedef CGAL::Regular_triangulation_3<K, Tds> Rt;
+
+  private:
+    std::vector<_Point3> _domain_vertices;
+    std::vector<std::array<int, 4>> _domain_tets;
+    double _domain_volume;
+    int _num_sites;
+    std::vector<_Point3> _sites;
+    std::vector<double> _weights;
+    std::vector<_Point3> _vertices;
+    std::vector<std::vector<std::tuple<int, int, int, int>>> _cells;
+    std::vector<double> _volumes;
+    std::vector<std::map<int, double>> _facets;
+    _Tessellation3D_Skeleton _skeleton;
+
+  private:
+    void calculate_();
+
+  public:
+    // cone decomposition of the volume bounded by a closed model
+    _Clipped_Tessellation3D(const _ManifoldModel &in_model);
+    // explicit tetrahedral domain
+    _Clipped_Tessellation3D(const std::vector<_Point3> &in_vertices, const std::vector<std::array<int, 4>> &in_tets);
+    void calculate_(const std::vector<_Point3> &in_sites);
+    void calculate_(const std::vector<_Point3> &in_sites, const std::vector<double> &in_weights);
+    static double signed_volume_(const _Point3 &a, const _Point3 &b, const _Point3 &c, const _Point3 &d)
+    {
+      return (b - a).cross_(c - a).dot_(d - a) / 6.0;
+    }
+    // the signed number of domain tetrahedra containing in_p is 1 inside and 0 outside
+    bool is_inside_(const _Point3 &in_p) const;
+    double domain_volume_() const
+    {
+      return _domain_volume;
+    }
+    std::pair<_Point3, _Point3> domain_bounding_box_() const;
+    const std::vector<_Point3> &get_domain_vertices_() const
+    {
+      return _domain_vertices;
+    }
+    // oriented by their sign, see above
+    const std::vector<std::array<int, 4>> &get_domain_tets_() const
+    {
+      return _domain_tets;
+    }
+    int number_vertices_() const
+    {
+      return _vertices.size();
+    }
+    _Point3 vertex_(const int &id) const
+    {
+      if (id < 0 || id >= _vertices.size())
+        throw std::runtime_error("Beyond the index!");
+      return _vertices[id];
+    }
+    const std::vector<_Point3> &get_vertices_() const
+    {
+      return _vertices;
+    }
+    const std::vector<_Point3> &get_sites_() const
+    {
+      return _sites;
+    }
+    const std::vector<std::vector<std::tuple<int, int, int, int>>> &get_cells_() const
+    {
+      return _cells;
+    }
+    double volume_(const int &id) const
+    {
+      return _volumes[id];
+    }
+    // neighbouring site -> area of the common facet inside the volume
+    const std::vector<std::map<int, double>> &get_facets_() const
+    {
+      return _facets;
+    }
+  };
+} // namespace BGAL
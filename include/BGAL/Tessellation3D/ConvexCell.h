@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "BGAL/BaseShape/Point.h"
+#include "BGAL/Model/ManifoldModel.h"
+
+namespace BGAL
+{
+  // Convex polytope cut out of a box by half spaces a x + b y + c z + d <= 0, each plane
+  // given as (a, b, c, d). The polytope is stored by its dual: every vertex is a triangle of
+  // the three planes meeting there, ordered so that their normals have a positive
+  // determinant, and two vertices are joined by an edge when their triangles share two
+  // planes. A clip removes the triangles of the vertices on the positive side of the plane
+  // and closes the hole with a fan of triangles to the new plane, so the polytope is never
+  // rebuilt and a cut costs a pass over its vertices. Vertices where more than three planes
+  // meet are repeated, one for each triangle of their fan.
+  class _Convex_Cell
+  {
+  public:
+    _Convex_Cell();
+    _Convex_Cell(const _Point3 &in_min, const _Point3 &in_max);
+    // returns false if the plane doesn't cut into the cell; the side of every vertex is exact
+    bool clip_(const Eigen::Vector4d &in_plane);
+    void clip_(const std::vector<Eigen::Vector4d> &in_planes);
+    // clips every cell by its own planes, the cells in parallel
+    static void clip_(std::vector<_Convex_Cell> &cells, const std::vector<std::vector<Eigen::Vector4d>> &in_planes);
+    bool empty_() const
+    {
+      return _triangles.empty();
+    }
+    int number_vertices_() const
+    {
+      return _triangles.size();
+    }
+    _Point3 vertex_(const int &id) const
+    {
+      if (id < 0 || id >= _triangles.size())
+        throw std::runtime_error("Beyond the index!");
+      return _Point3(_vertices[id].x(), _vertices[id].y(), _vertices[id].z());
+    }
+    const Eigen::Vector4d &plane_(const int &id) const
+    {
+      return _planes[id];
+    }
+    // the planes 0 ... 5 are the faces of the box, then the clipping planes in their order
+    int number_planes_() const
+    {
+      return _planes.size();
+    }
+    // every plane on the boundary of the cell with its polygon, counterclockwise seen
+    // from outside
+    std::vector<std::pair<int, std::vector<int>>> facets_() const;
+    double volume_() const;
+    _Point3 centroid_() const;
+    // triangulated boundary
+    _ManifoldModel model_() const;
+
+  private:
+    Eigen::Vector3d intersection_(const std::array<int, 3> &in_triangle) const;
+
+  private:
+    std::vector<Eigen::Vector4d> _planes;
+    std::vector<std::array<int, 3>> _triangles;
+    std::vector<Eigen::Vector3d> _vertices;
+  };
+} // namespace BGAL
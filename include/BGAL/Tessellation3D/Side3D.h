@@ -45,7 +45,7 @@ namespace BGAL
             double p2x, double p2y, double p2z,
             double w1, double w2,
             double qx, double qy, double qz);
-        static _BOC::_Sign base_side2_(
+        static inline _BOC::_Sign base_side2_(
             double p1x,
             double p1y,
             double p1z,
@@ -81,7 +81,7 @@ namespace BGAL
             double w1, double w2, double w3,
             double q1x, double q1y, double q1z,
             double q2x, double q2y, double q2z);
-        static _BOC::_Sign base_side3_(
+        static inline _BOC::_Sign base_side3_(
             double p1x,
             double p1y,
             double p1z,
@@ -130,6 +130,17 @@ namespace BGAL
             double q3x, double q3y, double q3z);
 
     public:
+        // number of queries decided by the static floating point filter, by the
+        // interval filter and by exact arithmetic
+        class _Statistics
+        {
+        public:
+            long long static_filter;
+            long long interval_filter;
+            long long exact;
+        };
+        static _Statistics statistics_();
+        static void reset_statistics_();
         static _BOC::_Sign side1_(
             double p1x, double p1y, double p1z,
             double p2x, double p2y, double p2z,
@@ -151,5 +162,10 @@ namespace BGAL
             double q1x, double q1y, double q1z,
             double q2x, double q2y, double q2z,
             double q3x, double q3y, double q3z);
+        // n queries stored row by row, each row holding the arguments of side1_ (11),
+        // side2_ (18) or side3_ (25) in the same order
+        static void side1_batch_(const int &n, const double *in_queries, _BOC::_Sign *out);
+        static void side2_batch_(const int &n, const double *in_queries, _BOC::_Sign *out);
+        static void side3_batch_(const int &n, const double *in_queries, _BOC::_Sign *out);
     };
 } // namespace BGAL
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <vector>
 #include <queue>
 #include <map>
+#include <string>
 #include <iostream>
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
@@ -32,14 +33,41 @@ namespace BGAL
     typedef CGAL::Regular_triangulation_3<K, Tds> Rt;
 
   private:
-    std::vector<std::set<int>> _neights;
+    // neighbours of site i are _neights[_offsets[i]] ... _neights[_offsets[i + 1] - 1]
+    std::vector<int> _offsets;
+    std::vector<int> _neights;
 
   public:
+    class _Neighbours
+    {
+      const int *_begin;
+      const int *_end;
+
+    public:
+      _Neighbours(const int *in_begin, const int *in_end) : _begin(in_begin), _end(in_end)
+      {
+      }
+      const int *begin() const
+      {
+        return _begin;
+      }
+      const int *end() const
+      {
+        return _end;
+      }
+      int size() const
+      {
+        return _end - _begin;
+      }
+    };
     _Tessellation3D_Skeleton();
+    // the neighbours of every site come sorted by index
     _Tessellation3D_Skeleton(Rt &rt, const int &num_vertices);
-    const std::set<int> &neight_(const int &in_i) const
+    // reorders the neighbours of every site by increasing distance to it
+    void sort_by_distance_(const std::vector<_Point3> &in_sites);
+    _Neighbours neight_(const int &in_i) const
     {
-      return _neights[in_i];
+      return _Neighbours(_neights.data() + _offsets[in_i], _neights.data() + _offsets[in_i + 1]);
     }
   };
   class _Restricted_Tessellation3D
@@ -64,6 +92,11 @@ namespace BGAL
     std::vector<std::map<int, std::vector<std::pair<int, int>>>> _edges;
     _Tessellation3D_Skeleton _skeleton;
     std::vector<bool> _is_hidden;
+    std::vector<int> _rdt_faces;
+    // scratch rows of side_batch_, grouped by the kind of vertex
+    std::vector<double> _side_queries[3];
+    std::vector<int> _side_rows[3];
+    std::vector<_BOC::_Sign> _side_signs;
 
   private:
     struct _Symbolic_Point
@@ -126,12 +159,15 @@ namespace BGAL
       }
     };
     _BOC::_Sign side_(const int &ip1, const int &ip2, _Symbolic_Point &v);
+    // side_ of every vertex of vs, with the predicates of each kind evaluated as one batch
+    void side_batch_(const int &ip1, const int &ip2, const std::vector<_Symbolic_Point> &vs, std::vector<_BOC::_Sign> &out);
     _Symbolic_Point insec_bisector_(const _Symbolic_Point &p1,
                                     const _Symbolic_Point &p2,
                                     const int &neigh,
                                     const int &center,
                                     const std::vector<int> &current_face_vid) const;
     void calculate_();
+    void extract_rdt_(const std::vector<std::tuple<int, int, int, int>> &in_dual_faces);
 
   public:
     _Restricted_Tessellation3D(const _ManifoldModel& in_model);
@@ -162,6 +198,10 @@ namespace BGAL
       return _vertices[id];
     }
     
+    const std::vector<_Point3> &get_vertices_() const
+    {
+      return _vertices;
+    }
     const  std::vector<_Point3>& get_sites_() const
     {
         return _sites;
@@ -174,5 +214,23 @@ namespace BGAL
     {
       return _edges;
     }
+    // the neighbours of every site in the power diagram, not only on the surface
+    const _Tessellation3D_Skeleton &get_skeleton_() const
+    {
+      return _skeleton;
+    }
+    // Restricted Delaunay triangulation of the sites, dual to the vertices where three
+    // cells meet. Three site ids per triangle, oriented along the surface normal and
+    // sorted, so the buffer is the same for any number of threads.
+    const std::vector<int> &get_rdt_faces_() const
+    {
+      return _rdt_faces;
+    }
+    int number_rdt_faces_() const
+    {
+      return _rdt_faces.size() / 3;
+    }
+    // Writes the sites and the RDT as a binary little-endian PLY.
+    void save_rdt_(const std::string &in_file_name) const;
   };
 } // namespace BGAL
\ No newline at end of file
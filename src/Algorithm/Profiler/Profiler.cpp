@@ -0,0 +1,209 @@
+#include "BGAL/Algorithm/Profiler/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace BGAL
+{
+  namespace
+  {
+    struct _Event
+    {
+      const char *name;
+      double start;
+      double end;
+      int depth;
+    };
+    struct _Thread_Buffer
+    {
+      int tid;
+      int depth;
+      std::vector<_Event> events;
+    };
+    struct _Registry
+    {
+      std::mutex mutex;
+      // owned here so that the scopes of finished threads are still reported
+      std::vector<std::shared_ptr<_Thread_Buffer>> buffers;
+      std::vector<_Profiler::_Counter *> counters;
+      std::atomic<bool> enabled{true};
+      std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+    _Registry &registry_()
+    {
+      static _Registry registry;
+      return registry;
+    }
+    _Thread_Buffer &thread_buffer_()
+    {
+      thread_local std::shared_ptr<_Thread_Buffer> buffer;
+      if (!buffer)
+      {
+        buffer = std::make_shared<_Thread_Buffer>();
+        buffer->depth = 0;
+        _Registry &registry = registry_();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer->tid = registry.buffers.size();
+        registry.buffers.push_back(buffer);
+      }
+      return *buffer;
+    }
+    // microseconds since the profiler started
+    double now_()
+    {
+      return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - registry_().epoch).count();
+    }
+    struct _Path_Statistics
+    {
+      long long calls = 0;
+      double total = 0;
+      double children = 0;
+    };
+    // scope events with their paths, rebuilt from the nesting depths of every thread
+    std::vector<std::pair<std::string, std::pair<int, _Event>>> paths_()
+    {
+      _Registry &registry = registry_();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      std::vector<std::pair<std::string, std::pair<int, _Event>>> paths;
+      for (auto &buffer : registry.buffers)
+      {
+        std::vector<_Event> events = buffer->events;
+        std::sort(events.begin(), events.end(), [](const _Event &a, const _Event &b)
+                  { return a.start < b.start || (a.start == b.start && a.depth < b.depth); });
+        std::vector<std::string> stack;
+        for (auto &e : events)
+        {
+          stack.resize(std::min<int>(stack.size(), e.depth));
+          std::string path = stack.empty() ? e.name : stack.back() + "/" + e.name;
+          stack.push_back(path);
+          paths.push_back(std::make_pair(path, std::make_pair(buffer->tid, e)));
+        }
+      }
+      return paths;
+    }
+  } // namespace
+
+  _Profiler::_Scope::_Scope(const char *in_name) : _name(in_name), _start(0), _active(enabled_())
+  {
+    if (_active)
+    {
+      ++thread_buffer_().depth;
+      _start = now_();
+    }
+  }
+  _Profiler::_Scope::~_Scope()
+  {
+    end_();
+  }
+  void _Profiler::_Scope::end_()
+  {
+    if (!_active)
+      return;
+    _active = false;
+    const double end = now_();
+    _Thread_Buffer &buffer = thread_buffer_();
+    --buffer.depth;
+    buffer.events.push_back(_Event{_name, _start, end, buffer.depth});
+  }
+  _Profiler::_Counter::_Counter(const char *in_name) : _name(in_name), _value(0)
+  {
+    _Registry &registry = registry_();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.counters.push_back(this);
+  }
+  void _Profiler::enable_(const bool &in_enable)
+  {
+    registry_().enabled.store(in_enable, std::memory_order_relaxed);
+  }
+  bool _Profiler::enabled_()
+  {
+    return registry_().enabled.load(std::memory_order_relaxed);
+  }
+  void _Profiler::reset_()
+  {
+    _Registry &registry = registry_();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto &buffer : registry.buffers)
+      buffer->events.clear();
+    for (auto &counter : registry.counters)
+      counter->reset_();
+  }
+  void _Profiler::write_chrome_trace_(const std::string &in_file_name)
+  {
+    std::ofstream out(in_file_name);
+    if (!out)
+      throw std::runtime_error("Can't open " + in_file_name);
+    std::vector<std::pair<std::string, std::pair<int, _Event>>> paths = paths_();
+    double last = 0;
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (auto &p : paths)
+    {
+      const _Event &e = p.second.second;
+      last = std::max(last, e.end);
+      out << (first ? "" : ",") << "\n{\"name\": \"" << e.name << "\", \"cat\": \"" << p.first
+          << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << p.second.first << ", \"ts\": " << e.start
+          << ", \"dur\": " << e.end - e.start << "}";
+      first = false;
+    }
+    std::map<std::string, long long> counters;
+    {
+      _Registry &registry = registry_();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      for (auto &counter : registry.counters)
+        counters[counter->name_()] += counter->value_();
+    }
+    for (auto &c : counters)
+    {
+      out << (first ? "" : ",") << "\n{\"name\": \"" << c.first << "\", \"ph\": \"C\", \"pid\": 0, \"tid\": 0, \"ts\": "
+          << last << ", \"args\": {\"value\": " << c.second << "}}";
+      first = false;
+    }
+    out << "\n]}\n";
+  }
+  void _Profiler::write_report_(const std::string &in_file_name)
+  {
+    std::ofstream out(in_file_name);
+    if (!out)
+      throw std::runtime_error("Can't open " + in_file_name);
+    std::map<std::string, _Path_Statistics> statistics;
+    for (auto &p : paths_())
+    {
+      const double duration = p.second.second.end - p.second.second.start;
+      _Path_Statistics &s = statistics[p.first];
+      ++s.calls;
+      s.total += duration;
+      const size_t slash = p.first.rfind('/');
+      if (slash != std::string::npos)
+        statistics[p.first.substr(0, slash)].children += duration;
+    }
+    std::map<std::string, long long> counters;
+    {
+      _Registry &registry = registry_();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      for (auto &counter : registry.counters)
+        counters[counter->name_()] += counter->value_();
+    }
+    out << "{\n  \"scopes\": [";
+    bool first = true;
+    for (auto &s : statistics)
+    {
+      out << (first ? "" : ",") << "\n    {\"path\": \"" << s.first << "\", \"calls\": " << s.second.calls
+          << ", \"total_ms\": " << s.second.total / 1000 << ", \"self_ms\": " << (s.second.total - s.second.children) / 1000 << "}";
+      first = false;
+    }
+    out << "\n  ],\n  \"counters\": {";
+    first = true;
+    for (auto &c : counters)
+    {
+      out << (first ? "" : ",") << "\n    \"" << c.first << "\": " << c.second;
+      first = false;
+    }
+    out << "\n  }\n}\n";
+  }
+} // namespace BGAL
@@ -78,10 +78,102 @@ namespace BGAL
 		}
 		return guess;
 	}
+	void _KDTree::knn_search_(const _Point3 &in_p, const int &k,
+							  std::vector<int> &out_ids, std::vector<double> &out_sqdists) const
+	{
+		out_ids.clear();
+		out_sqdists.clear();
+		const int kk = std::min(k, (int)_points.size());
+		if (kk <= 0 || !_root)
+			return;
+		const double q[3] = {in_p[0], in_p[1], in_p[2]};
+		// the tree is median-split, so its depth and the stack stay below log2(n) + 2
+		std::pair<const _Node *, double> S[128];
+		int top = 0;
+		S[top++] = std::make_pair(_root, 0.0);
+		while (top > 0)
+		{
+			const _Node *node = S[--top].first;
+			const double bound = S[top].second;
+			if ((int)out_ids.size() == kk && bound >= out_sqdists.back())
+				continue;
+			while (node)
+			{
+				const double *c = _coords.data() + 3 * node->_id;
+				const double dx = q[0] - c[0], dy = q[1] - c[1], dz = q[2] - c[2];
+				const double d2 = dx * dx + dy * dy + dz * dz;
+				if ((int)out_ids.size() < kk || d2 < out_sqdists.back())
+				{
+					// keep the candidates sorted by insertion, k is small
+					if ((int)out_ids.size() < kk)
+					{
+						out_ids.push_back(node->_id);
+						out_sqdists.push_back(d2);
+					}
+					int j = (int)out_ids.size() - 1;
+					while (j > 0 && out_sqdists[j - 1] > d2)
+					{
+						out_ids[j] = out_ids[j - 1];
+						out_sqdists[j] = out_sqdists[j - 1];
+						--j;
+					}
+					out_ids[j] = node->_id;
+					out_sqdists[j] = d2;
+				}
+				const double diff = q[node->_axis] - c[node->_axis];
+				const int dir = diff < 0 ? 0 : 1;
+				if (node->_next[!dir])
+					S[top++] = std::make_pair(node->_next[!dir], diff * diff);
+				node = node->_next[dir];
+			}
+		}
+	}
+	void _KDTree::radius_search_(const _Point3 &in_p, const double &in_r,
+								 std::vector<int> &out_ids, std::vector<double> &out_sqdists) const
+	{
+		out_ids.clear();
+		out_sqdists.clear();
+		if (!_root || _points.empty())
+			return;
+		const double q[3] = {in_p[0], in_p[1], in_p[2]};
+		const double r2 = in_r * in_r;
+		std::pair<const _Node *, double> S[128];
+		int top = 0;
+		S[top++] = std::make_pair(_root, 0.0);
+		while (top > 0)
+		{
+			const _Node *node = S[--top].first;
+			if (S[top].second > r2)
+				continue;
+			while (node)
+			{
+				const double *c = _coords.data() + 3 * node->_id;
+				const double dx = q[0] - c[0], dy = q[1] - c[1], dz = q[2] - c[2];
+				const double d2 = dx * dx + dy * dy + dz * dz;
+				if (d2 <= r2)
+				{
+					out_ids.push_back(node->_id);
+					out_sqdists.push_back(d2);
+				}
+				const double diff = q[node->_axis] - c[node->_axis];
+				const int dir = diff < 0 ? 0 : 1;
+				if (node->_next[!dir] && diff * diff <= r2)
+					S[top++] = std::make_pair(node->_next[!dir], diff * diff);
+				node = node->_next[dir];
+			}
+		}
+	}
 	void _KDTree::build_(const std::vector<_Point3> &in_points)
 	{
 		clear_();
 		_points = in_points;
+		_coords.resize(3 * _points.size());
+		for (int i = 0; i < (int)_points.size(); ++i)
+		{
+			_coords[3 * i] = _points[i][0];
+			_coords[3 * i + 1] = _points[i][1];
+			_coords[3 * i + 2] = _points[i][2];
+		}
 		std::vector<int> ids(_points.size());
 		std::iota(std::begin(ids), std::end(ids), 0);
 		std::stack<std::tuple<int *, int, int, _Node *, int>> S;
@@ -144,5 +236,6 @@ namespace BGAL
 		}
 		_root = nullptr;
 		_points.clear();
+		_coords.clear();
 	}
 } // namespace BGAL
@@ -167,6 +167,14 @@ namespace BGAL
 		return (is_in_(in_p) ? -min_dis : min_dis);
 	}
 	int _Polygon::intersection_with_linesegment_(const _Point2 &p1, const _Point2 &p2, std::vector<std::pair<int, _Point2>> &intersections) const
+	{
+		auto is_in = [this](const _Point2 &in_p)
+		{
+			return is_in_(in_p);
+		};
+		return intersection_with_linesegment_(p1, p2, nullptr, is_in, intersections);
+	}
+	int _Polygon::intersection_with_linesegment_(const _Point2 &p1, const _Point2 &p2, const std::vector<int> *in_edges, const std::function<bool(const _Point2 &)> &in_is_in, std::vector<std::pair<int, _Point2>> &intersections) const
 	{
 		bool add_p1 = false;
 		bool add_p2 = false;
@@ -174,8 +182,10 @@ namespace BGAL
 		int p2_inx = -1;
 		std::vector<bool> is_on_vertex;
 		intersections.resize(0);
-		for (int i = 0; i < _points.size(); ++i)
+		const int num_edges = in_edges ? in_edges->size() : _points.size();
+		for (int k = 0; k < num_edges; ++k)
 		{
+			const int i = in_edges ? (*in_edges)[k] : k;
 			bool p1_on = false;
 			bool p2_on = false;
 
@@ -316,26 +326,68 @@ namespace BGAL
 			}
 			return 2;
 		}
-		if ((!is_in_(p1)) && (!is_in_(p2)))
+		if ((!in_is_in(p1)) && (!in_is_in(p2)))
 		{
 			intersections.resize(0);
 			return 0;
 		}
-		if (is_in_(p2) && is_on_vertex[0])
+		if (in_is_in(p2) && is_on_vertex[0])
 		{
 			intersections[0].first = (intersections[0].first + _points.size() - 1) % _points.size();
 		}
 		return intersections.size();
 	}
+	bool _Polygon::is_convex_() const
+	{
+		const int n = _points.size();
+		if (n < 3)
+			return false;
+		const double x0 = _points[0].x(), y0 = _points[0].y();
+		// sign of u x v, zero when they are parallel up to rounding
+		auto side = [](const double& ux, const double& uy, const double& vx, const double& vy)
+		{
+			const double c = ux * vy - uy * vx;
+			const double tolerance = 1e-12 * (fabs(ux) + fabs(uy)) * (fabs(vx) + fabs(vy));
+			return c > tolerance ? 1 : (c < -tolerance ? -1 : 0);
+		};
+		// every corner turns the same way, and so does every triangle of the fan from the
+		// first vertex, which rules out the polygons winding more than once
+		int sign = 0;
+		auto agree = [&sign](const int& s)
+		{
+			if (s * sign < 0)
+				return false;
+			if (s != 0)
+				sign = s;
+			return true;
+		};
+		for (int i = 0; i < n; ++i)
+		{
+			const _Point2& a = _points[i];
+			const _Point2& b = _points[(i + 1) % n];
+			const _Point2& c = _points[(i + 2) % n];
+			if (!agree(side(b.x() - a.x(), b.y() - a.y(), c.x() - b.x(), c.y() - b.y())))
+				return false;
+		}
+		for (int i = 1; i + 1 < n; ++i)
+		{
+			if (!agree(side(_points[i].x() - x0, _points[i].y() - y0, _points[i + 1].x() - x0, _points[i + 1].y() - y0)))
+				return false;
+		}
+		return sign != 0;
+	}
 	double _Polygon::area_() const
 	{
+		// shoelace formula around the first vertex, the polygon being simple
+		if (num_() < 3)
+			return 0;
 		double sum = 0;
-		std::vector<_Polygon> tris = constrained_delaunay_triangulation_();
-		for (int i = 0; i < tris.size(); ++i)
+		const double x0 = _points[0].x(), y0 = _points[0].y();
+		for (int i = 1; i + 1 < num_(); ++i)
 		{
-			sum += tris[i].triangle_area_();
+			sum += (_points[i].x() - x0) * (_points[i + 1].y() - y0) - (_points[i + 1].x() - x0) * (_points[i].y() - y0);
 		}
-		return sum;
+		return fabs(sum) * 0.5;
 	}
 	double _Polygon::triangle_area_() const
 	{
@@ -0,0 +1,274 @@
+#include "BGAL/BaseShape/PreparedPolygon.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace BGAL
+{
+	_Prepared_Polygon::_Prepared_Polygon(const _Polygon &in_polygon) : _polygon(in_polygon)
+	{
+		const int n = _polygon.num_();
+		if (n < 3)
+			throw std::runtime_error("The number of points is too small!");
+		_points.resize(n);
+		for (int i = 0; i < n; ++i)
+		{
+			_points[i] = Eigen::Vector2d(_polygon[i].x(), _polygon[i].y());
+		}
+		_min = _max = _points[0];
+		for (int i = 1; i < n; ++i)
+		{
+			_min = _min.cwiseMin(_points[i]);
+			_max = _max.cwiseMax(_points[i]);
+		}
+		const double size = std::max(_max.x() - _min.x(), _max.y() - _min.y());
+		_pad = 1e-9 * size + _BOC::precision_();
+		const double w = std::max(_max.x() - _min.x(), 1e-3 * size);
+		const double h = std::max(_max.y() - _min.y(), 1e-3 * size);
+		_nx = std::max(1, std::min(n, int(std::round(std::sqrt(n * w / h)))));
+		_ny = std::max(1, (n + _nx - 1) / _nx);
+		_dx = w / _nx;
+		_dy = h / _ny;
+
+		std::vector<std::pair<int, int>> cell_edges;
+		std::vector<int> cells;
+		for (int i = 0; i < n; ++i)
+		{
+			cells_along_(_points[i], _points[(i + 1) % n], cells);
+			for (int c : cells)
+			{
+				cell_edges.push_back(std::make_pair(c, i));
+			}
+		}
+		std::sort(cell_edges.begin(), cell_edges.end());
+		_cell_begin.assign(_nx * _ny + 1, 0);
+		_cell_edges.resize(cell_edges.size());
+		for (int k = 0; k < cell_edges.size(); ++k)
+		{
+			++_cell_begin[cell_edges[k].first + 1];
+			_cell_edges[k] = cell_edges[k].second;
+		}
+		for (int c = 0; c < _nx * _ny; ++c)
+		{
+			_cell_begin[c + 1] += _cell_begin[c];
+		}
+	}
+	int _Prepared_Polygon::column_(const double &in_x) const
+	{
+		const double c = std::floor((in_x - _min.x()) / _dx);
+		return c < 0 ? 0 : (c >= _nx ? _nx - 1 : int(c));
+	}
+	int _Prepared_Polygon::row_(const double &in_y) const
+	{
+		const double r = std::floor((in_y - _min.y()) / _dy);
+		return r < 0 ? 0 : (r >= _ny ? _ny - 1 : int(r));
+	}
+	void _Prepared_Polygon::cells_along_(const Eigen::Vector2d &a, const Eigen::Vector2d &b, std::vector<int> &out_cells) const
+	{
+		out_cells.clear();
+		const int r0 = row_(std::min(a.y(), b.y()) - _pad);
+		const int r1 = row_(std::max(a.y(), b.y()) + _pad);
+		for (int r = r0; r <= r1; ++r)
+		{
+			// the part of the segment in the slab of the row
+			double x0 = std::min(a.x(), b.x());
+			double x1 = std::max(a.x(), b.x());
+			if (a.y() != b.y())
+			{
+				const double y0 = _min.y() + r * _dy - _pad;
+				const double y1 = y0 + _dy + 2 * _pad;
+				double t0 = (y0 - a.y()) / (b.y() - a.y());
+				double t1 = (y1 - a.y()) / (b.y() - a.y());
+				if (t0 > t1)
+					std::swap(t0, t1);
+				t0 = std::max(t0, 0.0);
+				t1 = std::min(t1, 1.0);
+				if (t0 > t1)
+					continue;
+				x0 = a.x() + t0 * (b.x() - a.x());
+				x1 = a.x() + t1 * (b.x() - a.x());
+				if (x0 > x1)
+					std::swap(x0, x1);
+			}
+			const int c1 = column_(x1 + _pad);
+			for (int c = column_(x0 - _pad); c <= c1; ++c)
+			{
+				out_cells.push_back(r * _nx + c);
+			}
+		}
+	}
+	bool _Prepared_Polygon::in_cell_(const int &in_cell, const int &in_edge) const
+	{
+		for (int k = _cell_begin[in_cell]; k < _cell_begin[in_cell + 1]; ++k)
+		{
+			if (_cell_edges[k] == in_edge)
+				return true;
+		}
+		return false;
+	}
+	bool _Prepared_Polygon::is_in_(const _Point2 &in_p) const
+	{
+		const double x = in_p.x(), y = in_p.y();
+		if (x < _min.x() - _pad || x > _max.x() + _pad || y < _min.y() - _pad || y > _max.y() + _pad)
+			return false;
+		const int n = _points.size();
+		const int r = row_(y), c0 = column_(x);
+		bool res = false;
+		// the ray to the right of the point, with the tests of _Polygon::is_in_
+		for (int c = c0; c < _nx; ++c)
+		{
+			const int cell = r * _nx + c;
+			for (int k = _cell_begin[cell]; k < _cell_begin[cell + 1]; ++k)
+			{
+				const int e = _cell_edges[k];
+				// every edge once, in the first of its cells on the ray
+				if (c > c0 && in_cell_(cell - 1, e))
+					continue;
+				const Eigen::Vector2d &p1 = _points[(e + 1) % n];
+				const Eigen::Vector2d &p2 = _points[e];
+				const double ax = p1.x() - x, ay = p1.y() - y;
+				const double bx = p2.x() - x, by = p2.y() - y;
+				if (_BOC::sign_(fabs(ax * by - ay * bx)) == _BOC::_Sign::ZerO && _BOC::sign_(ax * bx + ay * by) != _BOC::_Sign::PositivE)
+				{
+					return false;
+				}
+				if (((_BOC::sign_(p1.y() - y) == _BOC::_Sign::PositivE) != (_BOC::sign_(p2.y() - y) == _BOC::_Sign::PositivE)) && _BOC::sign_(x - (y - p1.y()) * (p1.x() - p2.x()) / (p1.y() - p2.y()) - p1.x()) == _BOC::_Sign::NegativE)
+				{
+					res = !res;
+				}
+			}
+		}
+		return res;
+	}
+	double _Prepared_Polygon::nearest_(const Eigen::Vector2d &in_p, Eigen::Vector2d &q) const
+	{
+		const int n = _points.size();
+		double best = std::numeric_limits<double>::max();
+		auto visit = [&](const int &cell)
+		{
+			for (int k = _cell_begin[cell]; k < _cell_begin[cell + 1]; ++k)
+			{
+				const int e = _cell_edges[k];
+				const Eigen::Vector2d &a = _points[e];
+				const Eigen::Vector2d ab = _points[(e + 1) % n] - a;
+				const double len = ab.squaredNorm();
+				Eigen::Vector2d lp = a;
+				if (_BOC::sign_(std::sqrt(len)) != _BOC::_Sign::ZerO)
+				{
+					lp += std::min(std::max(ab.dot(in_p - a) / len, 0.0), 1.0) * ab;
+				}
+				const double d = (lp - in_p).squaredNorm();
+				if (d < best)
+				{
+					best = d;
+					q = lp;
+				}
+			}
+		};
+		const int c0 = column_(in_p.x()), r0 = row_(in_p.y());
+		for (int ring = 0;; ++ring)
+		{
+			const int cmin = c0 - ring, cmax = c0 + ring, rmin = r0 - ring, rmax = r0 + ring;
+			for (int r = std::max(rmin, 0); r <= std::min(rmax, _ny - 1); ++r)
+			{
+				if (r == rmin || r == rmax)
+				{
+					for (int c = std::max(cmin, 0); c <= std::min(cmax, _nx - 1); ++c)
+					{
+						visit(r * _nx + c);
+					}
+					continue;
+				}
+				if (cmin >= 0)
+					visit(r * _nx + cmin);
+				if (cmax < _nx)
+					visit(r * _nx + cmax);
+			}
+			// every cell left is beyond one of the sides of the block not on the border of the grid
+			double bound = std::numeric_limits<double>::max();
+			if (cmin > 0)
+				bound = std::min(bound, in_p.x() - (_min.x() + cmin * _dx));
+			if (cmax < _nx - 1)
+				bound = std::min(bound, _min.x() + (cmax + 1) * _dx - in_p.x());
+			if (rmin > 0)
+				bound = std::min(bound, in_p.y() - (_min.y() + rmin * _dy));
+			if (rmax < _ny - 1)
+				bound = std::min(bound, _min.y() + (rmax + 1) * _dy - in_p.y());
+			if (bound == std::numeric_limits<double>::max() || (bound > 0 && bound * bound >= best))
+				break;
+		}
+		return best;
+	}
+	_Point2 _Prepared_Polygon::nearest_point_(const _Point2 &in_p) const
+	{
+		Eigen::Vector2d q;
+		nearest_(Eigen::Vector2d(in_p.x(), in_p.y()), q);
+		return _Point2(q.x(), q.y());
+	}
+	double _Prepared_Polygon::distance_to_boundary_(const _Point2 &in_p) const
+	{
+		Eigen::Vector2d q;
+		const double d = std::sqrt(nearest_(Eigen::Vector2d(in_p.x(), in_p.y()), q));
+		return is_in_(in_p) ? -d : d;
+	}
+	int _Prepared_Polygon::intersection_with_linesegment_(const _Point2 &p1, const _Point2 &p2, std::vector<std::pair<int, _Point2>> &intersections) const
+	{
+		std::vector<int> cells;
+		cells_along_(Eigen::Vector2d(p1.x(), p1.y()), Eigen::Vector2d(p2.x(), p2.y()), cells);
+		std::vector<int> edges;
+		for (int c : cells)
+		{
+			edges.insert(edges.end(), _cell_edges.begin() + _cell_begin[c], _cell_edges.begin() + _cell_begin[c + 1]);
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		auto is_in = [this](const _Point2 &in_p)
+		{
+			return is_in_(in_p);
+		};
+		return _polygon.intersection_with_linesegment_(p1, p2, &edges, is_in, intersections);
+	}
+	std::vector<char> _Prepared_Polygon::is_in_(const std::vector<_Point2> &in_points) const
+	{
+		std::vector<char> res(in_points.size());
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < in_points.size(); ++i)
+		{
+			res[i] = is_in_(in_points[i]);
+		}
+		return res;
+	}
+	std::vector<_Point2> _Prepared_Polygon::nearest_points_(const std::vector<_Point2> &in_points) const
+	{
+		std::vector<_Point2> res(in_points.size());
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < in_points.size(); ++i)
+		{
+			res[i] = nearest_point_(in_points[i]);
+		}
+		return res;
+	}
+	std::vector<double> _Prepared_Polygon::distances_to_boundary_(const std::vector<_Point2> &in_points) const
+	{
+		std::vector<double> res(in_points.size());
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < in_points.size(); ++i)
+		{
+			res[i] = distance_to_boundary_(in_points[i]);
+		}
+		return res;
+	}
+	std::vector<int> _Prepared_Polygon::intersections_with_linesegments_(const std::vector<std::pair<_Point2, _Point2>> &in_segments,
+		std::vector<std::vector<std::pair<int, _Point2>>> &out_intersections) const
+	{
+		std::vector<int> res(in_segments.size());
+		out_intersections.resize(in_segments.size());
+#pragma omp parallel for schedule(dynamic, 64)
+		for (int i = 0; i < in_segments.size(); ++i)
+		{
+			res[i] = intersection_with_linesegment_(in_segments[i].first, in_segments[i].second, out_intersections[i]);
+		}
+		return res;
+	}
+}
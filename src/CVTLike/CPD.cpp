@@ -16,181 +16,181 @@ namespace BGAL
 		};
 		_para.is_show = true;
 		_para.epsilon = 5e-5;
+		_para.max_linearsearch = 20;
 		_max_count = 50;
 		_omt_eps = 1e-4;
-		_pinvtoler = 1e-6;
-		_hessian_eps = 1e-10;
+		_pinvtoler = 1e-4;
+		_hessian_eps = 1e-5;
 	}
 	_CPD3D::_CPD3D(const _ManifoldModel& model, std::function<double(_Point3& p)>& rho, _LBFGS::_Parameter para) : _model(model), _RPD(model), _rho(rho), _para(para)
 	{
+		_para.max_linearsearch = 20;
 		_max_count = 50;
 		_omt_eps = 1e-4;
-		_pinvtoler = 1e-6;
-		_hessian_eps = 1e-10;
+		_pinvtoler = 1e-4;
+		_hessian_eps = 1e-5;
 	}
 	void _CPD3D::calculate_(const std::vector<double>& capacity, std::vector<_Point3> sites)
 	{
-
-		_max_count = 50;
-		_omt_eps = 1e-4;
-		_pinvtoler = 1e-4;
-		_hessian_eps = 1e-5;
-		_para.max_linearsearch = 20;
-
 		_capacity = capacity;
-		int num = _capacity.size();
-		/*_sites.resize(num);
+		_sites = sites;
+		_weights.resize(_capacity.size(), 0);
+		optimize_("");
+	}
+	void _CPD3D::calculate_weights_(const std::vector<double>& capacity, std::vector<_Point3> sites)
+	{
+		_capacity = capacity;
+		_sites = sites;
+		_weights.resize(_capacity.size(), 0);
+		solve_weights_();
+	}
+	void _CPD3D::resume_(const std::string& checkpoint_file)
+	{
+		_LBFGS::_Checkpoint checkpoint;
+		if (!_LBFGS::load_checkpoint_(checkpoint_file, checkpoint))
+			throw std::runtime_error("can't read the checkpoint " + checkpoint_file);
+		int num = checkpoint.x.size() / 3;
+		if (checkpoint.data.size() != 2 * num)
+			throw std::runtime_error("the checkpoint has no capacities and weights!");
+		_sites.resize(num);
+		_capacity.resize(num);
+		_weights.resize(num);
 		for (int i = 0; i < num; ++i)
 		{
-			int fid = rand() % _model.number_faces_();
-			double l0, l1, l2, sum;
-			l0 = _BOC::rand_();
-			l1 = _BOC::rand_();
-			l2 = _BOC::rand_();
-			sum = l0 + l1 + l2;
-			l0 /= sum;
-			l1 /= sum;
-			l2 /= sum;
-			_sites[i] = _model.face_(fid).point(0) * l0 + _model.face_(fid).point(1) * l1 + _model.face_(fid).point(2) * l2;
-		}*/
-		_sites = sites;
-		_weights.resize(num, 0);
+			_sites[i] = BGAL::_Point3(checkpoint.x(i * 3), checkpoint.x(i * 3 + 1), checkpoint.x(i * 3 + 2));
+			_capacity[i] = checkpoint.data(i);
+			_weights[i] = checkpoint.data(num + i);
+		}
+		optimize_(checkpoint_file);
+	}
+	bool _CPD3D::cell_masses_(const Eigen::VectorXd& weights, Eigen::VectorXd& masses)
+	{
+		const int num = _sites.size();
+		for (int i = 0; i < num; ++i)
+		{
+			_weights[i] = weights(i);
+		}
 		_RPD.calculate_(_sites, _weights);
-		std::function<bool(Eigen::SparseMatrix<double>& h)> cal_h
-			= [&](Eigen::SparseMatrix<double>& h)
+		const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RPD.get_cells_();
+		const std::vector<_Point3>& vertices = _RPD.get_vertices_();
+		masses.resize(num);
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < num; ++i)
 		{
-			const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RPD.get_cells_();
-			const std::vector<std::map<int, std::vector<std::pair<int, int>>>>& edges = _RPD.get_edges_();
-			vector<Eigen::Triplet<double>> trilist;
-			for (int i = 0; i < num; ++i)
+			double mass = 0;
+			for (auto& t : cells[i])
 			{
-				double hii = 0;
-				for (auto& kv : edges[i])
-				{
-					// һʱдģҪϸĥ
-					double len = 0;
-					std::set<int> temp_p;
-					for (auto& te : kv.second)
+				const _Point3& q1 = vertices[std::get<0>(t)];
+				const _Point3& q2 = vertices[std::get<1>(t)];
+				const _Point3& q3 = vertices[std::get<2>(t)];
+				mass += BGAL::_Integral::integral_triangle(
+					[&](const Eigen::Vector3d& p)
 					{
-						len += (_RPD.vertex_(te.first) - _RPD.vertex_(te.second)).length_();
-						if (temp_p.find(te.first) == temp_p.end())
-						{
-							temp_p.insert(te.first);
-						}
-						else
-						{
-							temp_p.erase(te.first);
-						}
-						if (temp_p.find(te.second) == temp_p.end())
-						{
-							temp_p.insert(te.second);
-						}
-						else
-						{
-							temp_p.erase(te.second);
-						}
-					}
-					std::vector<int> ps;
-					for (auto& tp : temp_p)
-					{
-						ps.push_back(tp);
-					}
-					BGAL::_Point3 mid_p;
-					// ˻ҪǱ⣬⴦£ҪǴͨ߼ʵ
-					if (ps.size() < 2)
-					{
-						mid_p = (_sites[i] + _sites[kv.first]) * 0.5;
-					}
-					else
-					{
-						const BGAL::_Point3& sp = _RPD.vertex_(ps[0]);
-						const BGAL::_Point3& tp = _RPD.vertex_(ps[1]);
-						mid_p = (_RPD.vertex_(ps[0]) + _RPD.vertex_(ps[1])) * 0.5;
-					}					
-					double hij = -_rho(mid_p) * (len) * 0.5 / ((_sites[i] - _sites[kv.first]).length_());
-					trilist.push_back(Eigen::Triplet<double>(i, kv.first, hij));
-					hii -= hij;
-				}
-				trilist.push_back(Eigen::Triplet<double>(i, i, hii + _hessian_eps));
+						BGAL::_Point3 q(p.x(), p.y(), p.z());
+						return _rho(q);
+					}, Eigen::Vector3d(q1.x(), q1.y(), q1.z()), Eigen::Vector3d(q2.x(), q2.y(), q2.z()),
+					Eigen::Vector3d(q3.x(), q3.y(), q3.z()));
 			}
-			h.resize(num, num);
-			h.setFromTriplets(trilist.begin(), trilist.end());
-			return true;
-		};
-		std::function<bool(const Eigen::VectorXd& x, double& e, Eigen::VectorXd& g)> omt_fg
-			= [&](const Eigen::VectorXd& x, double& e, Eigen::VectorXd& g)
+			masses(i) = mass;
+		}
+		return _RPD.number_hidden_point_() == 0;
+	}
+	void _CPD3D::hessian_(Eigen::SparseMatrix<double>& h) const
+	{
+		const int num = _sites.size();
+		const std::vector<std::map<int, std::vector<std::pair<int, int>>>>& edges = _RPD.get_edges_();
+		const std::vector<_Point3>& vertices = _RPD.get_vertices_();
+		// row i holds the neighbours of site i and the diagonal, so every row fills its own slots
+		std::vector<int> begin(num + 1, 0);
+		for (int i = 0; i < num; ++i)
 		{
-			e = 0;
-			g.setZero();
-			for (int i = 0; i < num; ++i)
-			{
-				_weights[i] = x(i);
-			}
-			_RPD.calculate_(_sites, _weights);
-			if (_RPD.number_hidden_point_() > 0)
-			{
-				return false;
-			}
-			const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RPD.get_cells_();
-			for (int i = 0; i < num; ++i)
+			begin[i + 1] = begin[i] + edges[i].size() + 1;
+		}
+		std::vector<Eigen::Triplet<double>> trilist(begin[num]);
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < num; ++i)
+		{
+			int k = begin[i];
+			double hii = 0;
+			for (auto& kv : edges[i])
 			{
-				for (int j = 0; j < cells[i].size(); ++j)
+				// the density integrated over the boundary shared with the neighbour, by the
+				// midpoints of its segments
+				double flux = 0;
+				for (auto& te : kv.second)
 				{
-					Eigen::VectorXd inte = BGAL::_Integral::integral_triangle3D(
-						[&](BGAL::_Point3 p)
-						{
-							Eigen::VectorXd r(2);
-							r(0) = _rho(p);
-							r(1) = _rho(p) * ((_sites[i] - p).sqlength_());
-							return r;
-						}, _RPD.vertex_(std::get<0>(cells[i][j])), _RPD.vertex_(std::get<1>(cells[i][j])), _RPD.vertex_(std::get<2>(cells[i][j]))
-							);
-					e -= inte(1) - _weights[i] * inte(0);
-					g(i) += inte(0);
+					const _Point3& a = vertices[te.first];
+					const _Point3& b = vertices[te.second];
+					_Point3 mid = (a + b) * 0.5;
+					flux += _rho(mid) * (b - a).length_();
 				}
-				g(i) -= _capacity[i];
-				e -= _weights[i] * _capacity[i];
+				const double hij = -flux * 0.5 / (_sites[i] - _sites[kv.first]).length_();
+				trilist[k++] = Eigen::Triplet<double>(i, kv.first, hij);
+				hii -= hij;
 			}
-			return true;
-		};
-
-		std::function<void()> update_w
-			= [&]()
+			trilist[k] = Eigen::Triplet<double>(i, i, hii + _hessian_eps);
+		}
+		h.resize(num, num);
+		h.setFromTriplets(trilist.begin(), trilist.end());
+	}
+	void _CPD3D::solve_weights_()
+	{
+		const int num = _capacity.size();
+		const Eigen::VectorXd capacity = Eigen::Map<const Eigen::VectorXd>(_capacity.data(), num);
+		Eigen::VectorXd iterW = Eigen::Map<const Eigen::VectorXd>(_weights.data(), num);
+		Eigen::VectorXd masses;
+		// the weights of the last solve are kept as the start, unless they hide a cell
+		if (!cell_masses_(iterW, masses) || masses.minCoeff() <= 0)
 		{
-			_weights.clear();
-			_weights.resize(num, 0);
-			Eigen::VectorXd iterW(num);
 			iterW.setZero();
-			for (int i = 0; i < num; ++i)
+			cell_masses_(iterW, masses);
+		}
+		// Kitagawa, Merigot and Thibert: a step is taken only if every cell keeps at least eps0
+		// of mass and the residual drops by a factor (1 - tau / 2), so the cells never vanish
+		const double eps0 = 0.5 * std::min(masses.minCoeff(), capacity.minCoeff());
+		Eigen::VectorXd g = masses - capacity;
+		for (int count = 0; count < _max_count && g.norm() >= _omt_eps; ++count)
+		{
+			Eigen::SparseMatrix<double> hess(num, num);
+			hessian_(hess);
+			const Eigen::VectorXd d = -BGAL::_LinearSystem::solve_ldlt(hess, g, _pinvtoler);
+			bool accepted = false;
+			for (double tau = 1; tau > 1e-10; tau *= 0.5)
 			{
-				iterW(i) = _weights[i];
-			}
-			int count = 0;
-			double e;
-			Eigen::VectorXd g(num);
-			omt_fg(iterW, e, g);
-			while (1)
-			{				
-				
-				if (g.norm() < _omt_eps)
-					break;
-				Eigen::SparseMatrix<double> hess(num, num);
-				cal_h(hess);
-				Eigen::VectorXd d = -BGAL::_LinearSystem::solve_ldlt(hess, g, _pinvtoler);
-				double lambda = 1;
-				double newe = e;
-				while ((!omt_fg(iterW + lambda * d, newe, g)) || newe > e)
+				if (cell_masses_(iterW + tau * d, masses) && masses.minCoeff() > 0 && masses.minCoeff() >= eps0
+					&& (masses - capacity).norm() <= (1 - tau * 0.5) * g.norm())
 				{
-					lambda *= 0.5;
-				}
-				e = newe;
-				iterW = iterW + lambda * d;
-				count++;
-				if (count > _max_count)
+					iterW += tau * d;
+					g = masses - capacity;
+					accepted = true;
 					break;
+				}
 			}
-		};
-
+			if (!accepted)
+			{
+				// no progress along the direction; keep the diagram of the last weights
+				cell_masses_(iterW, masses);
+				break;
+			}
+		}
+	}
+	void _CPD3D::optimize_(const std::string& checkpoint_file)
+	{
+		int num = _capacity.size();
+		/*_sites.resize(num);
+		for (int i = 0; i < num; ++i)
+		{
+			int fid = rand() % _model.number_faces_();
+			double l0, l1, l2, sum;
+			l0 = _BOC::rand_();
+			l1 = _BOC::rand_();
+			l2 = _BOC::rand_();
+			sum = l0 + l1 + l2;
+			l0 /= sum;
+			l1 /= sum;
+			l2 /= sum;
+			_sites[i] = _model.face_(fid).point(0) * l0 + _model.face_(fid).point(1) * l1 + _model.face_(fid).point(2) * l2;
+		}*/
 		std::function<double(const Eigen::VectorXd& X, Eigen::VectorXd& g)> fg
 			= [&](const Eigen::VectorXd& X, Eigen::VectorXd& g)
 		{
@@ -200,11 +200,12 @@ namespace BGAL
 				// ǲҪͶӰmeshд
 				_sites[i] = p;
 			}
-			update_w();
+			solve_weights_();
 
 			const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RPD.get_cells_();
 			double energy = 0;
 			g.setZero();
+#pragma omp parallel for reduction(+ : energy) schedule(dynamic, 256)
 			for (int i = 0; i < num; ++i)
 			{
 				for (int j = 0; j < cells[i].size(); ++j)
@@ -232,6 +233,17 @@ namespace BGAL
 		};
 
 		BGAL::_LBFGS lbfgs(_para);
+		// the capacities and the weights of the last evaluation are saved with the sites
+		lbfgs._parameter.checkpoint_data = [&]()
+		{
+			Eigen::VectorXd data(2 * num);
+			for (int i = 0; i < num; ++i)
+			{
+				data(i) = _capacity[i];
+				data(num + i) = _weights[i];
+			}
+			return data;
+		};
 		Eigen::VectorXd iterX(num * 3);
 		for (int i = 0; i < num; ++i)
 		{
@@ -239,12 +251,15 @@ namespace BGAL
 			iterX(i * 3 + 1) = _sites[i].y();
 			iterX(i * 3 + 2) = _sites[i].z();
 		}
-		lbfgs.minimize(fg, iterX);
+		if (checkpoint_file.empty())
+			lbfgs.minimize(fg, iterX);
+		else
+			lbfgs.resume(fg, iterX, checkpoint_file);
 		for (int i = 0; i < num; ++i)
 		{
 			_sites[i] = BGAL::_Point3(iterX(i * 3), iterX(i * 3 + 1), iterX(i * 3 + 2));
 		}
-		update_w();
+		solve_weights_();
 		_RPD.calculate_(_sites, _weights);
 	}
 } // namespace BGAL
@@ -1,28 +1,14 @@
+#include <algorithm>
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
 #include "BGAL/CVTLike/CVT.h"
+#include "BGAL/CVTLike/SiteSampler.h"
+#include "BGAL/Model/Simplification.h"
 #include "BGAL/Algorithm/BOC/BOC.h"
 #include "BGAL/Integral/Integral.h"
 #include "BGAL/Optimization/LinearSystem/LinearSystem.h"
-#include <omp.h> 
-#include <CGAL/Simple_cartesian.h>
-#include <CGAL/AABB_tree.h>
-#include <CGAL/AABB_traits.h>
-#include <CGAL/Polyhedron_3.h>
-#include <CGAL/AABB_face_graph_triangle_primitive.h>
-#include <CGAL/IO/OBJ.h>
-typedef CGAL::Simple_cartesian<double> K_T;
-typedef K_T::FT FT;
-typedef K_T::Point_3 Point_T;
-
-typedef K_T::Segment_3 Segment;
-typedef CGAL::Polyhedron_3<K_T> Polyhedron;
-typedef CGAL::AABB_face_graph_triangle_primitive<Polyhedron> Primitive;
-typedef CGAL::AABB_traits<K_T, Primitive> Traits;
-typedef CGAL::AABB_tree<Traits> Tree;
-typedef Tree::Point_and_primitive_id Point_and_primitive_id;
-typedef K_T::Plane_3                                     Plane;
+#include <omp.h>
 
 namespace BGAL
 {
@@ -40,22 +26,30 @@ namespace BGAL
 		
 	}
 	void _CVT3D::calculate_(int num_sites)
-	{		
-		int num = num_sites;
-		_sites.resize(num);
-		for (int i = 0; i < num; ++i)
+	{
+		_Site_Sampler sampler(_model, _rho);
+		calculate_(sampler.sample_(num_sites));
+	}
+	void _CVT3D::calculate_(const std::vector<_Point3>& sites)
+	{
+		_sites = sites;
+		optimize_("");
+	}
+	void _CVT3D::resume_(const std::string& checkpoint_file)
+	{
+		_LBFGS::_Checkpoint checkpoint;
+		if (!_LBFGS::load_checkpoint_(checkpoint_file, checkpoint))
+			throw std::runtime_error("can't read the checkpoint " + checkpoint_file);
+		_sites.resize(checkpoint.x.size() / 3);
+		for (int i = 0; i < _sites.size(); ++i)
 		{
-			int fid = rand() % _model.number_faces_();
-			double l0, l1, l2, sum;
-			l0 = _BOC::rand_();
-			l1 = _BOC::rand_();
-			l2 = _BOC::rand_();
-			sum = l0 + l1 + l2;
-			l0 /= sum;
-			l1 /= sum;
-			l2 /= sum;
-			_sites[i] = _model.face_(fid).point(0) * l0 + _model.face_(fid).point(1) * l1 + _model.face_(fid).point(2) * l2;
+			_sites[i] = BGAL::_Point3(checkpoint.x(i * 3), checkpoint.x(i * 3 + 1), checkpoint.x(i * 3 + 2));
 		}
+		optimize_(checkpoint_file);
+	}
+	void _CVT3D::optimize_(const std::string& checkpoint_file)
+	{
+		int num = _sites.size();
 		_RVD.calculate_(_sites);
 		std::function<double(const Eigen::VectorXd& X, Eigen::VectorXd& g)> fg
 			= [&](const Eigen::VectorXd& X, Eigen::VectorXd& g)
@@ -102,7 +96,10 @@ namespace BGAL
 			iterX(i * 3 + 1) = _sites[i].y();
 			iterX(i * 3 + 2) = _sites[i].z();
 		}
-		lbfgs.minimize(fg, iterX);
+		if (checkpoint_file.empty())
+			lbfgs.minimize(fg, iterX);
+		else
+			lbfgs.resume(fg, iterX, checkpoint_file);
 		for (int i = 0; i < num; ++i)
 		{
 			_sites[i] = BGAL::_Point3(iterX(i * 3), iterX(i * 3 + 1), iterX(i * 3 + 2));
@@ -110,168 +107,165 @@ namespace BGAL
 		_RVD.calculate_(_sites);
 	}
 
-	
-	void _CVT3D::calculate_CapVT(std::vector<BGAL::_Point3>& sites)
+
+	void _CVT3D::calculate_multiresolution_(int num_sites, int num_levels)
 	{
-		Polyhedron polyhedron;
-		string modelName = "bunny";
-		std::ifstream input("..\\..\\data\\" + modelName + ".off");
-		input >> polyhedron;
-		input.close();
-		Tree tree(faces(polyhedron).first, faces(polyhedron).second, polyhedron);
-		
-		int num = sites.size();
-		_sites = sites;
-		_RVD.calculate_(_sites);
-		const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RVD.get_cells_();
-		double TotArea = 0;
-		for (int i = 0; i < cells.size(); ++i)
+		// level 0 is the input model, the others are simplified from the previous one
+		std::vector<int> nums(1, num_sites);
+		std::vector<_ManifoldModel> models;
+		models.reserve(num_levels);
+		for (int l = 1; l < num_levels; ++l)
 		{
-			for (int j = 0; j < cells[i].size(); ++j)
-			{
-				double side[3];//存储三条边的长度;
-				auto a = _RVD.vertex_(std::get<0>(cells[i][j]));
-				auto b = _RVD.vertex_(std::get<1>(cells[i][j]));
-				auto c = _RVD.vertex_(std::get<2>(cells[i][j]));
-
-				side[0] = sqrt(pow(a.x() - b.x(), 2) + pow(a.y() - b.y(), 2) + pow(a.z() - b.z(), 2));
-				side[1] = sqrt(pow(a.x() - c.x(), 2) + pow(a.y() - c.y(), 2) + pow(a.z() - c.z(), 2));
-				side[2] = sqrt(pow(c.x() - b.x(), 2) + pow(c.y() - b.y(), 2) + pow(c.z() - b.z(), 2));
-				double p = (side[0] + side[1] + side[2]) / 2;
-				double area = sqrt(p * (p - side[0]) * (p - side[1]) * (p - side[2]));
-				TotArea += area;
-			}
+			const _ManifoldModel& finer = l == 1 ? _model : models.back();
+			int num = (nums.back() + 1) / 2;
+			int num_faces = finer.number_faces_() / 4;
+			if (num < 4 || num_faces < 10 * num)
+				break;
+			models.push_back(_Mesh_Simplification::simplify_(finer, num_faces));
+			nums.push_back(num);
 		}
-		
-
-		std::function<double(const Eigen::VectorXd& X, Eigen::VectorXd& g)> fg
-			= [&](const Eigen::VectorXd& X, Eigen::VectorXd& g)
+		int coarsest = nums.size() - 1;
+		_Site_Sampler sampler(coarsest == 0 ? _model : models.back(), _rho);
+		std::vector<_Point3> sites = sampler.sample_(nums[coarsest]);
+		for (int l = coarsest; l > 0; --l)
 		{
-			omp_set_num_threads(8);
-#pragma omp parallel for schedule(dynamic, 20)
-			for (int i = 0; i < num; ++i)
-			{
-				
-				// 这里是不是需要将点投影到mesh表面有待考虑
-				//_model
-				Point_T query(X(i * 3), X(i * 3 + 1), X(i * 3 + 2));
-				Point_T closest = tree.closest_point(query);
-				
-				BGAL::_Point3 p(closest.x(), closest.y(), closest.z());
-				//BGAL::_Point3 p(X(i * 3), X(i * 3 + 1), X(i * 3 + 2));
-				_sites[i] = p;
-			}
-			_RVD.calculate_(_sites);
-			const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RVD.get_cells_();
-			double energy = 0;
-			g.setZero();
-
-
-			map<int,double> CellAreas;
-
-			double AreaDiff = 0;
-#pragma omp parallel for schedule(dynamic, 20)
+			// the coarse levels only need a rough equilibrium
+			_LBFGS::_Parameter para = _para;
+			para.epsilon = _para.epsilon * 10;
+			para.callback = nullptr;
+			para.checkpoint_file.clear();
+			_CVT3D level(models[l - 1], _rho, para);
+			level.calculate_(sites);
+			sites = level.get_sites();
+			const std::vector<std::vector<std::tuple<int, int, int>>>& cells = level.get_RVD().get_cells_();
+			std::vector<std::pair<double, int>> areas(cells.size());
 			for (int i = 0; i < cells.size(); ++i)
 			{
-				double CellsArea = 0;
+				double area = 0;
 				for (int j = 0; j < cells[i].size(); ++j)
 				{
-					double side[3];//存储三条边的长度;
-					auto a = _RVD.vertex_(std::get<0>(cells[i][j]));
-					auto b = _RVD.vertex_(std::get<1>(cells[i][j]));
-					auto c = _RVD.vertex_(std::get<2>(cells[i][j]));
-					side[0] = sqrt(pow(a.x() - b.x(), 2) + pow(a.y() - b.y(), 2) + pow(a.z() - b.z(), 2));
-					side[1] = sqrt(pow(a.x() - c.x(), 2) + pow(a.y() - c.y(), 2) + pow(a.z() - c.z(), 2));
-					side[2] = sqrt(pow(c.x() - b.x(), 2) + pow(c.y() - b.y(), 2) + pow(c.z() - b.z(), 2));
-					double p = (side[0] + side[1] + side[2]) / 2;
-					double area = sqrt(p * (p - side[0]) * (p - side[1]) * (p - side[2]));
-					CellsArea += area;
+					_Point3 a = level.get_RVD().vertex_(std::get<0>(cells[i][j]));
+					_Point3 b = level.get_RVD().vertex_(std::get<1>(cells[i][j]));
+					_Point3 c = level.get_RVD().vertex_(std::get<2>(cells[i][j]));
+					area += (b - a).cross_(c - a).length_() * 0.5;
 				}
-				CellAreas[i]=CellsArea;
-				AreaDiff += (CellsArea - TotArea / num) * (CellsArea - TotArea / num);
+				areas[i] = std::make_pair(-area, i);
 			}
-			
-			energy = AreaDiff;
-			
-			auto Edges = _RVD.get_edges_();
-#pragma omp parallel for schedule(dynamic, 20)
-			for (int i = 0; i < num; i++)
+			std::sort(areas.begin(), areas.end());
+			// a split site moves halfway to the farthest corner of its cell
+			for (int k = 0; k < nums[l - 1] - nums[l]; ++k)
 			{
-				double sumx = 0.0, sumy = 0.0, sumz = 0.0;
-				for (auto ee : Edges[i])
+				int i = areas[k].second;
+				_Point3 farthest = sites[i];
+				for (int j = 0; j < cells[i].size(); ++j)
 				{
-					int j = ee.first;
-					map<int,int> m;
-					for (auto e : ee.second)
+					for (int v : { std::get<0>(cells[i][j]), std::get<1>(cells[i][j]), std::get<2>(cells[i][j]) })
 					{
-						if (m.find(e.first) == m.end())
-						{
-							m[e.first] = 0;
-						}
-						if (m.find(e.second) == m.end())
-						{
-							m[e.second] = 0;
-						}
-						m[e.first]++;
-						m[e.second]++;
+						_Point3 p = level.get_RVD().vertex_(v);
+						if ((p - sites[i]).sqlength_() > (farthest - sites[i]).sqlength_())
+							farthest = p;
 					}
-					vector<int> EdgPts;
-					for (auto e : m)
-					{
-						if (e.second == 1)
-						{
-							EdgPts.push_back(e.first);
-						}
-					}
-					if (EdgPts.size() != 2)
-					{
-						cout << "Error!!" << endl;
-					}
-					
-					double tmp = (CellAreas[i]  - CellAreas[j]) / (_sites[j] - _sites[i]).length_();
-					auto Epts1 = _RVD.vertex_(EdgPts[0]);
-					auto Epts2 = _RVD.vertex_(EdgPts[1]);
-					double l = (Epts1 - Epts2).length_();
-					auto vecx = l * ((Epts1.x() + Epts2.x()) / 2.0 - _sites[i].x());
-					auto vecy = l * ((Epts1.y() + Epts2.y()) / 2.0 - _sites[i].y());
-					auto vecz = l * ((Epts1.z() + Epts2.z()) / 2.0 - _sites[i].z());
-					sumx += tmp*vecx;
-					sumy += tmp*vecy;
-					sumz += tmp*vecz;
 				}
-				
-				
-				g(i * 3) += 2.0*sumx;
-				g(i * 3 + 1) += 2.0*sumy;
-				g(i * 3 + 2) += 2.0*sumz;
+				sites.push_back((sites[i] + farthest) * 0.5);
 			}
-			bool projection = 1;
-			if (projection)
+		}
+		calculate_(sites);
+	}
+
+	void _CVT3D::cell_areas_(std::vector<double>& out_areas) const
+	{
+		const std::vector<std::vector<std::tuple<int, int, int>>>& cells = _RVD.get_cells_();
+		const std::vector<_Point3>& vertices = _RVD.get_vertices_();
+		out_areas.resize(cells.size());
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < cells.size(); ++i)
+		{
+			double area = 0;
+			for (auto& t : cells[i])
+			{
+				const _Point3& a = vertices[std::get<0>(t)];
+				const _Point3& b = vertices[std::get<1>(t)];
+				const _Point3& c = vertices[std::get<2>(t)];
+				const Eigen::Vector3d ab(b.x() - a.x(), b.y() - a.y(), b.z() - a.z());
+				const Eigen::Vector3d ac(c.x() - a.x(), c.y() - a.y(), c.z() - a.z());
+				area += ab.cross(ac).norm();
+			}
+			out_areas[i] = area * 0.5;
+		}
+	}
+	void _CVT3D::calculate_CapVT(std::vector<BGAL::_Point3>& sites)
+	{
+		_sites = sites;
+		optimize_CapVT_();
+	}
+	void _CVT3D::optimize_CapVT_()
+	{
+		const int num = _sites.size();
+		double total_area = 0;
+#pragma omp parallel for reduction(+ : total_area) schedule(static)
+		for (int f = 0; f < _model.number_faces_(); ++f)
+		{
+			const _Model::_MFace& face = _model.face_(f);
+			total_area += (face.point(1) - face.point(0)).cross_(face.point(2) - face.point(0)).length_() * 0.5;
+		}
+		const double target = total_area / num;
+		std::vector<double> areas;
+		std::vector<int> site_faces(num);
+		// the sites follow the iterate projected on the model
+		std::function<void(const Eigen::VectorXd& X)> project
+			= [&](const Eigen::VectorXd& X)
+		{
+#pragma omp parallel for schedule(dynamic, 256)
+			for (int i = 0; i < num; ++i)
 			{
-#pragma omp parallel for schedule(dynamic, 20)
-				for (int i = 0; i < num; i++)
+				std::tuple<_Point3, double, int> nearest = _model.nearest_point_(_Point3(X(i * 3), X(i * 3 + 1), X(i * 3 + 2)));
+				_sites[i] = std::get<0>(nearest);
+				site_faces[i] = std::get<2>(nearest);
+			}
+		};
+		std::function<double(const Eigen::VectorXd& X, Eigen::VectorXd& g)> fg
+			= [&](const Eigen::VectorXd& X, Eigen::VectorXd& g)
+		{
+			project(X);
+			_RVD.calculate_(_sites);
+			cell_areas_(areas);
+			const std::vector<std::map<int, std::vector<std::pair<int, int>>>>& edges = _RVD.get_edges_();
+			const std::vector<_Point3>& vertices = _RVD.get_vertices_();
+			double energy = 0;
+			// E = sum (A_i - A)^2. Moving x_i moves the boundary with x_j by (p - x_i) / |x_j - x_i|
+			// at p, so dE/dx_i = 2 sum_j (A_i - A_j) / |x_j - x_i| * integral of (p - x_i) over it.
+			// Every site writes its own gradient.
+#pragma omp parallel for reduction(+ : energy) schedule(dynamic, 256)
+			for (int i = 0; i < num; ++i)
+			{
+				energy += (areas[i] - target) * (areas[i] - target);
+				const Eigen::Vector3d xi(_sites[i].x(), _sites[i].y(), _sites[i].z());
+				Eigen::Vector3d gi = Eigen::Vector3d::Zero();
+				for (auto& kv : edges[i])
 				{
-					Point_T query(_sites[i].x(), _sites[i].y(), _sites[i].z());
-					Point_and_primitive_id pp = tree.closest_point_and_primitive(query);
-					Point_T closest = pp.first;
-					Polyhedron::Face_handle f = pp.second;
-
-					Plane pl(f->halfedge()->vertex()->point(), f->halfedge()->next()->vertex()->point(), f->halfedge()->next()->next()->vertex()->point());
-					auto nn = pl.orthogonal_vector();
-					Eigen::Vector3d n(nn.x(), nn.y(), nn.z());
-					Eigen::Vector3d u(g(i * 3), g(i * 3 + 1), g(i * 3 + 2));
-					Eigen::Vector3d newG = u - n * ((u.dot(n)) / n.squaredNorm());
-					g(i * 3) = newG.x();
-					g(i * 3 + 1) = newG.y();
-					g(i * 3 + 2) = newG.z();
+					const int j = kv.first;
+					const Eigen::Vector3d xj(_sites[j].x(), _sites[j].y(), _sites[j].z());
+					Eigen::Vector3d moment = Eigen::Vector3d::Zero();
+					for (auto& e : kv.second)
+					{
+						const _Point3& a = vertices[e.first];
+						const _Point3& b = vertices[e.second];
+						const Eigen::Vector3d pa(a.x(), a.y(), a.z()), pb(b.x(), b.y(), b.z());
+						moment += (pb - pa).norm() * ((pa + pb) * 0.5 - xi);
+					}
+					const double d = (xj - xi).norm();
+					if (d > 0)
+						gi += (areas[i] - areas[j]) / d * moment;
 				}
+				// tangent to the face under the site
+				const _Point3& nf = _model.normal_face_(site_faces[i]);
+				const Eigen::Vector3d n(nf.x(), nf.y(), nf.z());
+				gi *= 2;
+				gi -= n * (gi.dot(n) / n.squaredNorm());
+				g.segment<3>(i * 3) = gi;
 			}
-			
-
-			
 			return energy;
 		};
-		//_para.epsilon = 1e-6;
 		BGAL::_LBFGS lbfgs(_para);
 		Eigen::VectorXd iterX(num * 3);
 		for (int i = 0; i < num; ++i)
@@ -281,23 +275,8 @@ namespace BGAL
 			iterX(i * 3 + 2) = _sites[i].z();
 		}
 		lbfgs.minimize(fg, iterX);
-		for (int i = 0; i < num; ++i)
-		{
-			Point_T query(iterX(i * 3), iterX(i * 3 + 1), iterX(i * 3 + 2));
-			Point_T closest = tree.closest_point(query);
-
-			BGAL::_Point3 p(closest.x(), closest.y(), closest.z());
-			//BGAL::_Point3 p(X(i * 3), X(i * 3 + 1), X(i * 3 + 2));
-			_sites[i] = p;
-			//_sites[i] = BGAL::_Point3(iterX(i * 3), iterX(i * 3 + 1), iterX(i * 3 + 2));
-
-
-			
-		}
+		project(iterX);
 		_RVD.calculate_(_sites);
-
-
-		
 	}
 
 
@@ -0,0 +1,198 @@
+#include "BGAL/CVTLike/SiteSampler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <omp.h>
+
+namespace BGAL
+{
+	_Site_Sampler::_Site_Sampler(const _Model& model) : _model(model)
+	{
+		std::function<double(_Point3& p)> rho = [](_Point3& p)
+		{
+			return 1.0;
+		};
+		build_(rho);
+	}
+	_Site_Sampler::_Site_Sampler(const _Model& model, std::function<double(_Point3& p)>& rho) : _model(model)
+	{
+		build_(rho);
+	}
+	void _Site_Sampler::build_(std::function<double(_Point3& p)>& rho)
+	{
+		const int n = _model.number_faces_();
+		if (n == 0)
+			throw std::runtime_error("the model has no face!");
+		std::vector<double> mass(n);
+		double area = 0, total = 0;
+#pragma omp parallel for reduction(+ : area, total) schedule(static)
+		for (int f = 0; f < n; ++f)
+		{
+			const _Point3& a = _model.vertex_(_model.face_(f)[0]);
+			const _Point3& b = _model.vertex_(_model.face_(f)[1]);
+			const _Point3& c = _model.vertex_(_model.face_(f)[2]);
+			double s = (b - a).cross_(c - a).length_() * 0.5;
+			_Point3 centroid = (a + b + c) / 3.0;
+			mass[f] = s * std::max(rho(centroid), 0.0);
+			area += s;
+			total += mass[f];
+		}
+		if (total <= 0)
+			throw std::runtime_error("the density vanishes on the model!");
+		_area = area;
+		// Vose's alias method
+		_probability.resize(n);
+		_alias.assign(n, 0);
+		std::vector<int> small, large;
+		for (int f = 0; f < n; ++f)
+		{
+			_probability[f] = mass[f] * n / total;
+			if (_probability[f] < 1)
+				small.push_back(f);
+			else
+				large.push_back(f);
+		}
+		while (!small.empty() && !large.empty())
+		{
+			int s = small.back();
+			int l = large.back();
+			small.pop_back();
+			large.pop_back();
+			_alias[s] = l;
+			_probability[l] -= 1 - _probability[s];
+			if (_probability[l] < 1)
+				small.push_back(l);
+			else
+				large.push_back(l);
+		}
+		for (int f : small)
+			_probability[f] = 1;
+		for (int f : large)
+			_probability[f] = 1;
+	}
+	std::vector<_Point3> _Site_Sampler::sample_(int num, unsigned int seed) const
+	{
+		const int block_size = 1024;
+		const int num_blocks = (num + block_size - 1) / block_size;
+		const int n = _probability.size();
+		std::vector<_Point3> sites(num);
+#pragma omp parallel for schedule(static)
+		for (int b = 0; b < num_blocks; ++b)
+		{
+			std::seed_seq sequence{ seed, (unsigned int)b };
+			std::mt19937 generator(sequence);
+			std::uniform_real_distribution<double> uniform(0.0, 1.0);
+			const int end = std::min(num, (b + 1) * block_size);
+			for (int i = b * block_size; i < end; ++i)
+			{
+				double u = uniform(generator) * n;
+				int f = std::min((int)u, n - 1);
+				if (u - f >= _probability[f])
+					f = _alias[f];
+				// uniform barycentric coordinates
+				double r1 = sqrt(uniform(generator));
+				double r2 = uniform(generator);
+				double l0 = 1 - r1, l1 = r1 * (1 - r2), l2 = r1 * r2;
+				const _Point3& p0 = _model.vertex_(_model.face_(f)[0]);
+				const _Point3& p1 = _model.vertex_(_model.face_(f)[1]);
+				const _Point3& p2 = _model.vertex_(_model.face_(f)[2]);
+				sites[i] = _Point3(l0 * p0.x() + l1 * p1.x() + l2 * p2.x(),
+					l0 * p0.y() + l1 * p1.y() + l2 * p2.y(),
+					l0 * p0.z() + l1 * p1.z() + l2 * p2.z());
+			}
+		}
+		return sites;
+	}
+	std::vector<_Point3> _Site_Sampler::sample_blue_noise_(int num, unsigned int seed, int candidate_ratio) const
+	{
+		if (candidate_ratio <= 1)
+			return sample_(num, seed);
+		const int m = num * candidate_ratio;
+		std::vector<_Point3> candidates = sample_(m, seed);
+		// Yuksel's parameters for a surface: the radius of a hexagonal packing of num sites
+		const double r_max = sqrt(_area / (2 * sqrt(3.0) * num));
+		const double r_min = r_max * 0.65 * (1 - pow(1.0 / candidate_ratio, 1.5));
+		const double radius = 2 * r_max;
+		std::pair<_Point3, _Point3> box = _model.bounding_box_();
+		const long long nx = (long long)((box.second.x() - box.first.x()) / radius) + 1;
+		const long long ny = (long long)((box.second.y() - box.first.y()) / radius) + 1;
+		const long long nz = (long long)((box.second.z() - box.first.z()) / radius) + 1;
+		auto cell = [&](const _Point3& p, long long& ix, long long& iy, long long& iz)
+		{
+			ix = std::min(std::max((long long)((p.x() - box.first.x()) / radius), 0LL), nx - 1);
+			iy = std::min(std::max((long long)((p.y() - box.first.y()) / radius), 0LL), ny - 1);
+			iz = std::min(std::max((long long)((p.z() - box.first.z()) / radius), 0LL), nz - 1);
+		};
+		std::unordered_map<long long, std::vector<int>> grid;
+		for (int i = 0; i < m; ++i)
+		{
+			long long ix, iy, iz;
+			cell(candidates[i], ix, iy, iz);
+			grid[(ix * ny + iy) * nz + iz].push_back(i);
+		}
+		std::vector<std::vector<std::pair<int, double>>> neighbors(m);
+		std::vector<double> weights(m, 0);
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < m; ++i)
+		{
+			long long ix, iy, iz;
+			cell(candidates[i], ix, iy, iz);
+			for (long long x = std::max(ix - 1, 0LL); x <= std::min(ix + 1, nx - 1); ++x)
+			{
+				for (long long y = std::max(iy - 1, 0LL); y <= std::min(iy + 1, ny - 1); ++y)
+				{
+					for (long long z = std::max(iz - 1, 0LL); z <= std::min(iz + 1, nz - 1); ++z)
+					{
+						auto it = grid.find((x * ny + y) * nz + z);
+						if (it == grid.end())
+							continue;
+						for (int j : it->second)
+						{
+							if (j == i)
+								continue;
+							double d = (candidates[i] - candidates[j]).length_();
+							if (d >= radius)
+								continue;
+							double w = pow(1 - std::max(d, r_min) / radius, 8);
+							neighbors[i].push_back(std::make_pair(j, w));
+							weights[i] += w;
+						}
+					}
+				}
+			}
+		}
+		// remove the candidate with the largest weight until num are left
+		std::set<std::pair<double, int>> heap;
+		for (int i = 0; i < m; ++i)
+		{
+			heap.insert(std::make_pair(weights[i], i));
+		}
+		std::vector<bool> alive(m, true);
+		for (int count = m; count > num; --count)
+		{
+			int i = std::prev(heap.end())->second;
+			heap.erase(std::prev(heap.end()));
+			alive[i] = false;
+			for (const std::pair<int, double>& nw : neighbors[i])
+			{
+				int j = nw.first;
+				if (!alive[j])
+					continue;
+				heap.erase(std::make_pair(weights[j], j));
+				weights[j] -= nw.second;
+				heap.insert(std::make_pair(weights[j], j));
+			}
+		}
+		std::vector<_Point3> sites;
+		sites.reserve(num);
+		for (int i = 0; i < m; ++i)
+		{
+			if (alive[i])
+				sites.push_back(candidates[i]);
+		}
+		return sites;
+	}
+} // namespace BGAL
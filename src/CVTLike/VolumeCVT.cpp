@@ -0,0 +1,134 @@
+#include <Eigen/Dense>
+
+#include "BGAL/CVTLike/VolumeCVT.h"
+#include "BGAL/Algorithm/BOC/BOC.h"
+#include "BGAL/Integral/Integral.h"
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+#include <stdexcept>
+
+namespace BGAL
+{
+	_Volume_CVT3D::_Volume_CVT3D(const _ManifoldModel& model) : _CVD(model), _para()
+	{
+		_rho = [](BGAL::_Point3& p)
+		{
+			return 1;
+		};
+		_para.is_show = true;
+		_para.epsilon = 5e-5;
+	}
+	_Volume_CVT3D::_Volume_CVT3D(const _ManifoldModel& model, std::function<double(_Point3& p)>& rho, _LBFGS::_Parameter para) : _CVD(model), _rho(rho), _para(para)
+	{
+
+	}
+	void _Volume_CVT3D::calculate_(int num_sites)
+	{
+		// a domain tetrahedron by its volume, then a uniform point in it
+		const std::vector<_Point3>& vertices = _CVD.get_domain_vertices_();
+		const std::vector<std::array<int, 4>>& tets = _CVD.get_domain_tets_();
+		std::vector<int> positive;
+		std::vector<double> cumulative;
+		double total = 0;
+		bool folded = false;
+		for (int t = 0; t < tets.size(); ++t)
+		{
+			const double volume = _Clipped_Tessellation3D::signed_volume_(vertices[tets[t][0]], vertices[tets[t][1]], vertices[tets[t][2]], vertices[tets[t][3]]);
+			if (volume > 0)
+			{
+				total += volume;
+				positive.push_back(t);
+				cumulative.push_back(total);
+			}
+			else if (volume < 0)
+			{
+				folded = true;
+			}
+		}
+		if (positive.empty())
+			throw std::runtime_error("The domain is empty!");
+		std::vector<_Point3> sites;
+		sites.reserve(num_sites);
+		while ((int)sites.size() < num_sites)
+		{
+			const int k = std::min<int>(std::lower_bound(cumulative.begin(), cumulative.end(), _BOC::rand_() * total) - cumulative.begin(), positive.size() - 1);
+			const std::array<int, 4>& tet = tets[positive[k]];
+			// normalized exponential variables are uniform barycentric coordinates
+			double l[4], sum = 0;
+			for (int j = 0; j < 4; ++j)
+			{
+				l[j] = -log(1 - _BOC::rand_() * (1 - 1e-12));
+				sum += l[j];
+			}
+			_Point3 p = vertices[tet[0]] * (l[0] / sum) + vertices[tet[1]] * (l[1] / sum) + vertices[tet[2]] * (l[2] / sum) + vertices[tet[3]] * (l[3] / sum);
+			// where the surface of a cone decomposition folds back, positive tetrahedra also
+			// cover the outside; only such domains pay for the inside test
+			if (folded && !_CVD.is_inside_(p))
+				continue;
+			sites.push_back(p);
+		}
+		calculate_(sites);
+	}
+	void _Volume_CVT3D::calculate_(const std::vector<_Point3>& sites)
+	{
+		int num = sites.size();
+		_sites = sites;
+		std::function<double(const Eigen::VectorXd& X, Eigen::VectorXd& g)> fg
+			= [&](const Eigen::VectorXd& X, Eigen::VectorXd& g)
+		{
+			for (int i = 0; i < num; ++i)
+			{
+				_sites[i] = BGAL::_Point3(X(i * 3), X(i * 3 + 1), X(i * 3 + 2));
+			}
+			_CVD.calculate_(_sites);
+			const std::vector<std::vector<std::tuple<int, int, int, int>>>& cells = _CVD.get_cells_();
+			const std::vector<_Point3>& vertices = _CVD.get_vertices_();
+			double energy = 0;
+			g.setZero();
+#pragma omp parallel for reduction(+ : energy) schedule(dynamic, 20)
+			for (int i = 0; i < num; ++i)
+			{
+				const Eigen::Vector3d site(_sites[i].x(), _sites[i].y(), _sites[i].z());
+				for (int j = 0; j < cells[i].size(); ++j)
+				{
+					const _Point3& q1 = vertices[std::get<0>(cells[i][j])];
+					const _Point3& q2 = vertices[std::get<1>(cells[i][j])];
+					const _Point3& q3 = vertices[std::get<2>(cells[i][j])];
+					const _Point3& q4 = vertices[std::get<3>(cells[i][j])];
+					// the quadrature uses the unsigned volume, the orientation gives the sign
+					double sign = _Clipped_Tessellation3D::signed_volume_(q1, q2, q3, q4) < 0 ? -1 : 1;
+					Eigen::Vector4d inte = BGAL::_Integral::integral_tetrahedron(
+						[&](const Eigen::Vector3d& p)
+						{
+							_Point3 q(p.x(), p.y(), p.z());
+							const double rho = _rho(q);
+							Eigen::Vector4d r;
+							r << rho * (site - p).squaredNorm(), 2 * rho * (site - p);
+							return r;
+						}, Eigen::Vector3d(q1.x(), q1.y(), q1.z()), Eigen::Vector3d(q2.x(), q2.y(), q2.z()),
+						Eigen::Vector3d(q3.x(), q3.y(), q3.z()), Eigen::Vector3d(q4.x(), q4.y(), q4.z()));
+					energy += sign * inte(0);
+					g(i * 3) += sign * inte(1);
+					g(i * 3 + 1) += sign * inte(2);
+					g(i * 3 + 2) += sign * inte(3);
+				}
+			}
+			return energy;
+		};
+		BGAL::_LBFGS lbfgs(_para);
+		Eigen::VectorXd iterX(num * 3);
+		for (int i = 0; i < num; ++i)
+		{
+			iterX(i * 3) = _sites[i].x();
+			iterX(i * 3 + 1) = _sites[i].y();
+			iterX(i * 3 + 2) = _sites[i].z();
+		}
+		lbfgs.minimize(fg, iterX);
+		for (int i = 0; i < num; ++i)
+		{
+			_sites[i] = BGAL::_Point3(iterX(i * 3), iterX(i * 3 + 1), iterX(i * 3 + 2));
+		}
+		_CVD.calculate_(_sites);
+	}
+} // namespace BGAL
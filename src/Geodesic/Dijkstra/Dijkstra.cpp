@@ -1,4 +1,5 @@
 #include "BGAL/Geodesic/Dijkstra/Dijkstra.h"
+#include "BGAL/Algorithm/Profiler/Profiler.h"
 #include <queue>
 namespace BGAL
 {
@@ -10,6 +11,7 @@ namespace BGAL
 		}
 		void _Dijkstra::implement_()
 		{
+			BGAL_PROFILE_SCOPE("dijkstra");
 			struct _Event : std::tuple<double, int, int, int, int>
 			{
 				_Event(double dis, int self, int parent, int root, int level)
@@ -73,6 +75,7 @@ namespace BGAL
 						continue;
 					_Event evt(topEvt.get_distance_() + (*veit).length_(), v, topEvt.get_id_(), topEvt.get_root_(), topEvt.get_level_() + 1);
 					evtQue.push(evt);
+					BGAL_PROFILE_COUNT("dijkstra/heap_pushes", 1);
 				}
 			}
 			for (int i = 0; i < _model.number_vertices_(); ++i)
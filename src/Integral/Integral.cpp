@@ -1,6 +1,138 @@
 #include "BGAL/Integral/Integral.h"
+#include <stdexcept>
 
 namespace BGAL
 {
-
-}
\ No newline at end of file
+	static std::vector<_Quadrature_Rule> build_tetrahedron_rules_()
+	{
+		std::vector<_Quadrature_Rule> rules;
+		for (int k = 1; k <= keast_rule_num(); ++k)
+		{
+			_Quadrature_Rule rule;
+			rule.degree = keast_degree(k);
+			rule.num = keast_order_num(k);
+			std::vector<double> xyz(3 * rule.num);
+			rule.weights.resize(rule.num);
+			keast_rule(k, rule.num, xyz.data(), rule.weights.data());
+			rule.nodes.resize(4 * rule.num);
+			bool positive = true;
+			for (int i = 0; i < rule.num; ++i)
+			{
+				rule.nodes[4 * i] = 1.0 - xyz[3 * i] - xyz[3 * i + 1] - xyz[3 * i + 2];
+				rule.nodes[4 * i + 1] = xyz[3 * i];
+				rule.nodes[4 * i + 2] = xyz[3 * i + 1];
+				rule.nodes[4 * i + 3] = xyz[3 * i + 2];
+				positive = positive && rule.weights[i] > 0;
+			}
+			// a rule with negative weights is only kept if nothing better reaches its degree
+			if (!positive && k < keast_rule_num() - 1)
+				continue;
+			if (!rules.empty() && rules.back().degree >= rule.degree)
+				continue;
+			rules.push_back(rule);
+		}
+		return rules;
+	}
+	static _Quadrature_Rule triangle_rule_(int degree, const std::vector<std::vector<double>>& orbits)
+	{
+		// every orbit is {weight, a, b}: the permutations of (a, b, 1 - a - b)
+		_Quadrature_Rule rule;
+		rule.degree = degree;
+		for (const std::vector<double>& o : orbits)
+		{
+			double c = 1.0 - o[1] - o[2];
+			std::vector<std::array<double, 3>> points;
+			if (o[1] == o[2] && fabs(o[2] - c) < 1e-15)
+				points = { { o[1], o[2], c } };
+			else if (o[1] == o[2])
+				points = { { c, o[1], o[2] }, { o[1], c, o[2] }, { o[1], o[2], c } };
+			else
+				throw std::runtime_error("unsupported orbit!");
+			for (const std::array<double, 3>& p : points)
+			{
+				rule.nodes.insert(rule.nodes.end(), p.begin(), p.end());
+				rule.weights.push_back(o[0]);
+			}
+		}
+		rule.num = rule.weights.size();
+		return rule;
+	}
+	static std::vector<_Quadrature_Rule> build_triangle_rules_()
+	{
+		std::vector<_Quadrature_Rule> rules;
+		rules.push_back(triangle_rule_(1, { { 1.0, 1.0 / 3, 1.0 / 3 } }));
+		rules.push_back(triangle_rule_(2, { { 1.0 / 3, 1.0 / 6, 1.0 / 6 } }));
+		rules.push_back(triangle_rule_(3, { { 1.0 / 30, 0.5, 0.5 }, { 9.0 / 30, 1.0 / 6, 1.0 / 6 } }));
+		rules.push_back(triangle_rule_(5, {
+			{ 0.225, 1.0 / 3, 1.0 / 3 },
+			{ 0.132394152788506, 0.470142064105115, 0.470142064105115 },
+			{ 0.125939180544827, 0.101286507323456, 0.101286507323456 } }));
+		return rules;
+	}
+	static const _Quadrature_Rule& select_rule_(const std::vector<_Quadrature_Rule>& rules, int in_degree)
+	{
+		for (const _Quadrature_Rule& rule : rules)
+		{
+			if (rule.degree >= in_degree)
+				return rule;
+		}
+		throw std::runtime_error("no quadrature rule of this degree!");
+	}
+	const _Quadrature_Rule& _Integral::tetrahedron_rule(int in_degree)
+	{
+		static const std::vector<_Quadrature_Rule> rules = build_tetrahedron_rules_();
+		return select_rule_(rules, in_degree);
+	}
+	const _Quadrature_Rule& _Integral::triangle_rule(int in_degree)
+	{
+		static const std::vector<_Quadrature_Rule> rules = build_triangle_rules_();
+		return select_rule_(rules, in_degree);
+	}
+	Eigen::Matrix<double, 6, 1> _Integral::polygon_moments(const _Polygon& poly)
+	{
+		Eigen::Matrix<double, 6, 1> m = Eigen::Matrix<double, 6, 1>::Zero();
+		const int n = poly.num_();
+		if (n < 3)
+			return m;
+		// around the first vertex, then moved back
+		const double x0 = poly[0].x(), y0 = poly[0].y();
+		for (int i = 1; i + 1 < n; ++i)
+		{
+			const double xa = poly[i].x() - x0, ya = poly[i].y() - y0;
+			const double xb = poly[i + 1].x() - x0, yb = poly[i + 1].y() - y0;
+			const double c = xa * yb - xb * ya;
+			m(0) += c;
+			m(1) += (xa + xb) * c;
+			m(2) += (ya + yb) * c;
+			m(3) += (xa * xa + xa * xb + xb * xb) * c;
+			m(4) += (xa * yb + 2 * xa * ya + 2 * xb * yb + xb * ya) * c;
+			m(5) += (ya * ya + ya * yb + yb * yb) * c;
+		}
+		m(0) /= 2;
+		m(1) /= 6;
+		m(2) /= 6;
+		m(3) /= 12;
+		m(4) /= 24;
+		m(5) /= 12;
+		if (m(0) < 0)
+			m = -m;
+		Eigen::Matrix<double, 6, 1> r;
+		r(0) = m(0);
+		r(1) = m(1) + x0 * m(0);
+		r(2) = m(2) + y0 * m(0);
+		r(3) = m(3) + 2 * x0 * m(1) + x0 * x0 * m(0);
+		r(4) = m(4) + x0 * m(2) + y0 * m(1) + x0 * y0 * m(0);
+		r(5) = m(5) + 2 * y0 * m(2) + y0 * y0 * m(0);
+		return r;
+	}
+	void _Integral::polygon_moments(const std::vector<_Polygon>& cells, std::vector<Eigen::Matrix<double, 6, 1>>& out)
+	{
+		const int n = cells.size();
+		out.resize(n);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			out[i] = polygon_moments(cells[i]);
+		}
+	}
+}
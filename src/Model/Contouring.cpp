@@ -0,0 +1,255 @@
+#include "BGAL/Model/Contouring.h"
+#include "BGAL/Model/Model_Iterator.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <omp.h>
+#include <tuple>
+
+namespace BGAL
+{
+  _Mesh_Contouring::_Mesh_Contouring(const _ManifoldModel &in_model) : _model(in_model)
+  {
+    const int num_faces = in_model.number_faces_();
+    const int num_edges = in_model.number_edges_() / 2;
+    _face_edges.assign(3 * num_faces, -1);
+    _edge_vertices.assign(2 * num_edges, -1);
+    _edge_faces.assign(2 * num_edges, -1);
+    // the ends of undirected edge k, as seen from half-edge 2k
+#pragma omp parallel for schedule(static)
+    for (int k = 0; k < num_edges; ++k)
+    {
+      const _ManifoldModel::_MMEdge e = in_model.edge_(2 * k);
+      _edge_vertices[2 * k] = e._id_left_vertex;
+      _edge_vertices[2 * k + 1] = e._id_right_vertex;
+    }
+    // a face writes its own slots and those of its own half-edges only
+#pragma omp parallel for schedule(static)
+    for (int f = 0; f < num_faces; ++f)
+    {
+      const _Model::_MFace &face = in_model.face_(f);
+      for (auto it = in_model.fe_begin(f); it != in_model.fe_end(f); ++it)
+      {
+        const _ManifoldModel::_MMEdge &e = *it;
+        const int eid = it.id();
+        for (int k = 0; k < 3; ++k)
+        {
+          if (face[k] == e._id_opposite_vertex)
+            _face_edges[3 * f + k] = eid / 2;
+        }
+        _edge_faces[eid] = f;
+      }
+    }
+  }
+  _Point3 _Mesh_Contouring::crossing_(const std::vector<double> &in_field, const int &eid, const double &in_value) const
+  {
+    const int v1 = _edge_vertices[2 * eid], v2 = _edge_vertices[2 * eid + 1];
+    const double proportion = (in_field[v2] - in_value) / (in_field[v2] - in_field[v1]);
+    return _model.vertex_(v1) * proportion + _model.vertex_(v2) * (1 - proportion);
+  }
+  std::vector<std::vector<_Point3>> _Mesh_Contouring::isolines_(const std::vector<double> &in_field, const double &in_value) const
+  {
+    return isolines_(in_field, std::vector<double>(1, in_value))[0];
+  }
+  std::vector<std::vector<std::vector<_Point3>>> _Mesh_Contouring::isolines_(const std::vector<double> &in_field,
+                                                                             const std::vector<double> &in_values) const
+  {
+    if (in_field.size() != _model.number_vertices_())
+      throw std::runtime_error("The field doesn't match the model!");
+    const int num_edges = _edge_vertices.size() / 2;
+    const int num_levels = in_values.size();
+    std::vector<int> order(num_levels);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const int &a, const int &b)
+              { return in_values[a] < in_values[b]; });
+    std::vector<double> levels(num_levels);
+    for (int l = 0; l < num_levels; ++l)
+      levels[l] = in_values[order[l]];
+
+    // An edge is crossed by the levels in [min, max) of its ends, a range of the sorted
+    // levels. The crossings are gathered per thread and bucketed by level.
+    std::vector<std::vector<std::pair<int, int>>> thread_crossings(omp_get_max_threads());
+#pragma omp parallel
+    {
+      std::vector<std::pair<int, int>> &crossings = thread_crossings[omp_get_thread_num()];
+#pragma omp for schedule(static)
+      for (int e = 0; e < num_edges; ++e)
+      {
+        const double a = in_field[_edge_vertices[2 * e]], b = in_field[_edge_vertices[2 * e + 1]];
+        const int first = std::lower_bound(levels.begin(), levels.end(), std::min(a, b)) - levels.begin();
+        const int last = std::lower_bound(levels.begin(), levels.end(), std::max(a, b)) - levels.begin();
+        for (int l = first; l < last; ++l)
+          crossings.push_back(std::make_pair(l, e));
+      }
+    }
+    std::vector<int> level_offsets(num_levels + 1, 0);
+    for (auto &crossings : thread_crossings)
+      for (auto &c : crossings)
+        ++level_offsets[c.first + 1];
+    std::partial_sum(level_offsets.begin(), level_offsets.end(), level_offsets.begin());
+    std::vector<int> level_edges(level_offsets.back());
+    {
+      std::vector<int> cursor(level_offsets.begin(), level_offsets.end() - 1);
+      for (auto &crossings : thread_crossings)
+        for (auto &c : crossings)
+          level_edges[cursor[c.first]++] = c.second;
+    }
+    thread_crossings.clear();
+
+    std::vector<std::vector<std::vector<_Point3>>> lines(num_levels);
+#pragma omp parallel
+    {
+      std::vector<char> visited(num_edges, 0);
+#pragma omp for schedule(dynamic, 1)
+      for (int l = 0; l < num_levels; ++l)
+      {
+        const double value = levels[l];
+        auto is_crossed = [&](const int &e)
+        {
+          return (in_field[_edge_vertices[2 * e]] > value) != (in_field[_edge_vertices[2 * e + 1]] > value);
+        };
+        // follows the crossed edges face by face from e, entering face f
+        auto walk = [&](int e, int f)
+        {
+          std::vector<_Point3> line(1, crossing_(in_field, e, value));
+          visited[e] = 1;
+          while (f != -1)
+          {
+            int next = -1;
+            for (int k = 0; k < 3; ++k)
+            {
+              const int ek = _face_edges[3 * f + k];
+              if (ek != e && is_crossed(ek))
+                next = ek;
+            }
+            e = next;
+            line.push_back(crossing_(in_field, e, value));
+            if (visited[e])
+              break;
+            visited[e] = 1;
+            f = _edge_faces[2 * e] == f ? _edge_faces[2 * e + 1] : _edge_faces[2 * e];
+          }
+          return line;
+        };
+        std::vector<std::vector<_Point3>> &level_lines = lines[order[l]];
+        // open polylines start on the boundary, the remaining crossings are closed loops
+        for (int i = level_offsets[l]; i < level_offsets[l + 1]; ++i)
+        {
+          const int e = level_edges[i];
+          if (!visited[e] && _edge_faces[2 * e + 1] == -1)
+            level_lines.push_back(walk(e, _edge_faces[2 * e]));
+        }
+        for (int i = level_offsets[l]; i < level_offsets[l + 1]; ++i)
+        {
+          const int e = level_edges[i];
+          if (!visited[e])
+            level_lines.push_back(walk(e, _edge_faces[2 * e]));
+        }
+        for (int i = level_offsets[l]; i < level_offsets[l + 1]; ++i)
+          visited[level_edges[i]] = 0;
+      }
+    }
+    return lines;
+  }
+  std::pair<_ManifoldModel, _ManifoldModel> _Mesh_Contouring::split_(const std::vector<double> &in_field, const double &in_value) const
+  {
+    if (in_field.size() != _model.number_vertices_())
+      throw std::runtime_error("The field doesn't match the model!");
+    const int num_vertices = _model.number_vertices_();
+    const int num_faces = _model.number_faces_();
+    const int num_edges = _edge_vertices.size() / 2;
+    // crossed edges get the new vertices num_vertices, num_vertices + 1, ...
+    std::vector<int> edge_vertex(num_edges);
+#pragma omp parallel for schedule(static)
+    for (int e = 0; e < num_edges; ++e)
+      edge_vertex[e] = (in_field[_edge_vertices[2 * e]] > in_value) != (in_field[_edge_vertices[2 * e + 1]] > in_value);
+    int num_crossings = 0;
+    for (int e = 0; e < num_edges; ++e)
+      edge_vertex[e] = edge_vertex[e] ? num_vertices + num_crossings++ : -1;
+    std::vector<_Point3> vertices(num_vertices + num_crossings);
+#pragma omp parallel for schedule(static)
+    for (int v = 0; v < num_vertices; ++v)
+      vertices[v] = _model.vertex_(v);
+#pragma omp parallel for schedule(static)
+    for (int e = 0; e < num_edges; ++e)
+    {
+      if (edge_vertex[e] != -1)
+        vertices[edge_vertex[e]] = crossing_(in_field, e, in_value);
+    }
+
+    // a face is kept whole on the side of its vertices or cut into the triangle of its lone
+    // vertex and the quad of the two others
+    std::vector<std::array<int, 2>> face_counts(num_faces + 1);
+    face_counts[0] = {0, 0};
+#pragma omp parallel for schedule(static)
+    for (int f = 0; f < num_faces; ++f)
+    {
+      const _Model::_MFace &face = _model.face_(f);
+      const bool above[3] = {in_field[face[0]] > in_value, in_field[face[1]] > in_value, in_field[face[2]] > in_value};
+      if (above[0] == above[1] && above[1] == above[2])
+        face_counts[f + 1] = {above[0] ? 0 : 1, above[0] ? 1 : 0};
+      else
+      {
+        const int k = above[0] != above[1] ? (above[0] != above[2] ? 0 : 1) : 2;
+        face_counts[f + 1] = {above[k] ? 2 : 1, above[k] ? 1 : 2};
+      }
+    }
+    for (int f = 0; f < num_faces; ++f)
+    {
+      face_counts[f + 1][0] += face_counts[f][0];
+      face_counts[f + 1][1] += face_counts[f][1];
+    }
+    std::vector<std::array<int, 3>> faces[2];
+    faces[0].resize(face_counts[num_faces][0]);
+    faces[1].resize(face_counts[num_faces][1]);
+#pragma omp parallel for schedule(static)
+    for (int f = 0; f < num_faces; ++f)
+    {
+      const _Model::_MFace &face = _model.face_(f);
+      const bool above[3] = {in_field[face[0]] > in_value, in_field[face[1]] > in_value, in_field[face[2]] > in_value};
+      int cursor[2] = {face_counts[f][0], face_counts[f][1]};
+      if (above[0] == above[1] && above[1] == above[2])
+      {
+        faces[above[0]][cursor[above[0]]] = {face[0], face[1], face[2]};
+        continue;
+      }
+      const int k = above[0] != above[1] ? (above[0] != above[2] ? 0 : 1) : 2;
+      const int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+      // p on the edge from k to k1, q on the edge from k2 to k
+      const int p = edge_vertex[_face_edges[3 * f + k2]];
+      const int q = edge_vertex[_face_edges[3 * f + k1]];
+      const int lone = above[k], other = !above[k];
+      faces[lone][cursor[lone]] = {face[k], p, q};
+      faces[other][cursor[other]++] = {p, face[k1], face[k2]};
+      faces[other][cursor[other]] = {p, face[k2], q};
+    }
+
+    std::vector<_Point3> side_vertices[2];
+    std::vector<_Model::_MFace> side_faces[2];
+    for (int s = 0; s < 2; ++s)
+    {
+      std::vector<int> new_ids(vertices.size(), -1);
+      side_faces[s].reserve(faces[s].size());
+      for (auto &face : faces[s])
+      {
+        for (auto &v : face)
+        {
+          if (new_ids[v] == -1)
+          {
+            new_ids[v] = side_vertices[s].size();
+            side_vertices[s].push_back(vertices[v]);
+          }
+        }
+        const int a = new_ids[face[0]], b = new_ids[face[1]], c = new_ids[face[2]];
+        _Model::_MFace side_face(a, b, c, side_vertices[s][a], side_vertices[s][b], side_vertices[s][c]);
+        side_face.id = side_faces[s].size();
+        side_faces[s].push_back(side_face);
+      }
+    }
+    // _ManifoldModel has no move, build both sides in place
+    std::pair<_ManifoldModel, _ManifoldModel> sides(std::piecewise_construct,
+                                                    std::forward_as_tuple(side_vertices[0], side_faces[0]),
+                                                    std::forward_as_tuple(side_vertices[1], side_faces[1]));
+    return sides;
+  }
+} // namespace BGAL
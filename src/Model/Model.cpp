@@ -1,5 +1,6 @@
 #pragma once
 #include "BGAL/Model/Model.h"
+#include "BGAL/Algorithm/Profiler/Profiler.h"
 #include "BGAL/Model/Model_Iterator.h"
 namespace BGAL
 {
@@ -190,12 +191,12 @@ namespace BGAL
     }
     _pqp_model.EndModel();
   }
-  std::tuple<_Point3, double, int> _Model::nearest_point_(const _Point3 &in_point)
+  std::tuple<_Point3, double, int> _Model::nearest_point_(const _Point3 &in_point) const
   {
     _PQP_Query_Resutl query_res = proximity_query_(in_point);
     return std::make_tuple(query_res._nearest_point, query_res._distance, query_res._triangle_id);
   }
-  double _Model::signed_distance_(const _Point3 &in_point)
+  double _Model::signed_distance_(const _Point3 &in_point) const
   {
     _PQP_Query_Resutl query_res = proximity_query_(in_point);
     double dis1 = (query_res._nearest_point - vertex_(face_(query_res._triangle_id)[0])).length_();
@@ -214,7 +215,7 @@ namespace BGAL
     }
     return query_res._distance;
   }
-  double _Model::signed_distance_(const _Point3 &in_point, _Point3 &gradient)
+  double _Model::signed_distance_(const _Point3 &in_point, _Point3 &gradient) const
   {
     _PQP_Query_Resutl query_res = proximity_query_(in_point);
     double dis1 = (query_res._nearest_point - vertex_(face_(query_res._triangle_id)[0])).length_();
@@ -235,7 +236,7 @@ namespace BGAL
     gradient = v;
     return query_res._distance;
   }
-  bool _Model::is_in_(const _Point3 &in_point)
+  bool _Model::is_in_(const _Point3 &in_point) const
   {
     _PQP_Query_Resutl query_res = proximity_query_(in_point);
     double dis1 = (query_res._nearest_point - vertex_(face_(query_res._triangle_id)[0])).length_();
@@ -366,7 +367,7 @@ namespace BGAL
     }
     _bounding_box = std::make_pair(ptDown, ptUp);
   }
-  _Model::_PQP_Query_Resutl _Model::proximity_query_(const _Point3 &in_point)
+  _Model::_PQP_Query_Resutl _Model::proximity_query_(const _Point3 &in_point) const
   {
     PQP_DistanceResult dres;
     dres.last_tri = _pqp_model.last_tri;
@@ -374,7 +375,12 @@ namespace BGAL
     p[0] = in_point.x();
     p[1] = in_point.y();
     p[2] = in_point.z();
-    PQP_Distance(&dres, &_pqp_model, p, 0.0, 0.0);
+    // the tree is built by initialization_PQP_; PQP checks its build state first
+    if (PQP_Distance(&dres, &_pqp_model, p, 0.0, 0.0) == PQP_ERR_UNPROCESSED_MODEL)
+      throw std::runtime_error("The PQP tree isn't built, call initialization_PQP_() first!");
+    BGAL_PROFILE_COUNT("pqp/queries", 1);
+    BGAL_PROFILE_COUNT("pqp/bv_tests", dres.num_bv_tests);
+    BGAL_PROFILE_COUNT("pqp/tri_tests", dres.num_tri_tests);
     _PQP_Query_Resutl res;
     res._pos_flag = dres.pos_flag;
     res._triangle_id = dres.last_tri->id;
@@ -0,0 +1,345 @@
+#include "BGAL/Model/SDFGrid.h"
+#include "BGAL/Algorithm/Profiler/Profiler.h"
+#include "BGAL/Model/Model_Iterator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <omp.h>
+
+namespace BGAL
+{
+  // Fast sweeping (Zhao 2005) of |grad d| = h on a lattice: Gauss-Seidel passes in the
+  // eight diagonal orders, frozen points keep their values.
+  static void fast_sweep_(std::vector<double> &io_d, const std::vector<char> &frozen, const int n[3], const double &h)
+  {
+    auto id = [&](const int &i, const int &j, const int &k)
+    {
+      return ((long long)i * n[1] + j) * n[2] + k;
+    };
+    auto neighbour_min = [&](const int &i, const int &j, const int &k, const int &axis)
+    {
+      int c[3] = {i, j, k};
+      double m = std::numeric_limits<double>::max();
+      for (int s = -1; s <= 1; s += 2)
+      {
+        c[axis] += s;
+        if (c[axis] >= 0 && c[axis] < n[axis])
+          m = std::min(m, io_d[id(c[0], c[1], c[2])]);
+        c[axis] -= s;
+      }
+      return m;
+    };
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      for (int dir = 0; dir < 8; ++dir)
+      {
+        const int si = (dir & 1) ? -1 : 1;
+        const int sj = (dir & 2) ? -1 : 1;
+        const int sk = (dir & 4) ? -1 : 1;
+        for (int a = 0; a < n[0]; ++a)
+        {
+          const int i = si > 0 ? a : n[0] - 1 - a;
+          for (int b = 0; b < n[1]; ++b)
+          {
+            const int j = sj > 0 ? b : n[1] - 1 - b;
+            for (int c = 0; c < n[2]; ++c)
+            {
+              const int k = sk > 0 ? c : n[2] - 1 - c;
+              const long long p = id(i, j, k);
+              if (frozen[p])
+                continue;
+              double m[3] = {neighbour_min(i, j, k, 0), neighbour_min(i, j, k, 1), neighbour_min(i, j, k, 2)};
+              std::sort(m, m + 3);
+              if (m[0] == std::numeric_limits<double>::max())
+                continue;
+              double u = m[0] + h;
+              if (u > m[1])
+              {
+                u = 0.5 * (m[0] + m[1] + sqrt(2 * h * h - (m[0] - m[1]) * (m[0] - m[1])));
+                if (u > m[2])
+                {
+                  const double s = m[0] + m[1] + m[2];
+                  const double q = m[0] * m[0] + m[1] * m[1] + m[2] * m[2] - h * h;
+                  u = (s + sqrt(std::max(0.0, s * s - 3 * q))) / 3;
+                }
+              }
+              io_d[p] = std::min(io_d[p], u);
+            }
+          }
+        }
+      }
+    }
+  }
+  // marks the points connected to the lattice boundary through non frozen points
+  static std::vector<char> flood_outside_(const std::vector<char> &frozen, const int n[3])
+  {
+    std::vector<char> outside(frozen.size(), 0);
+    std::vector<long long> queue;
+    for (int i = 0; i < n[0]; ++i)
+      for (int j = 0; j < n[1]; ++j)
+        for (int k = 0; k < n[2]; ++k)
+        {
+          if (i != 0 && j != 0 && k != 0 && i != n[0] - 1 && j != n[1] - 1 && k != n[2] - 1)
+            continue;
+          const long long p = ((long long)i * n[1] + j) * n[2] + k;
+          if (!frozen[p] && !outside[p])
+          {
+            outside[p] = 1;
+            queue.push_back(p);
+          }
+        }
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+      const long long p = queue[head];
+      int c[3] = {(int)(p / ((long long)n[1] * n[2])), (int)(p / n[2] % n[1]), (int)(p % n[2])};
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        for (int s = -1; s <= 1; s += 2)
+        {
+          c[axis] += s;
+          if (c[axis] >= 0 && c[axis] < n[axis])
+          {
+            const long long q = ((long long)c[0] * n[1] + c[1]) * n[2] + c[2];
+            if (!frozen[q] && !outside[q])
+            {
+              outside[q] = 1;
+              queue.push_back(q);
+            }
+          }
+          c[axis] -= s;
+        }
+      }
+    }
+    return outside;
+  }
+
+  _Signed_Distance_Grid::_Signed_Distance_Grid()
+      : _step(1), _band(1), _num_queries(0)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      _size[a] = 0;
+      _num_blocks[a] = 0;
+    }
+  }
+  _Signed_Distance_Grid::_Signed_Distance_Grid(_Model &in_model, const double &in_step, const double &in_band, const bool &in_dense)
+      : _step(in_step), _band(in_band), _num_queries(0)
+  {
+    if (in_step <= 0)
+      throw std::runtime_error("error! step<=0");
+    if (in_band < 1)
+      throw std::runtime_error("error! band<1");
+    BGAL_PROFILE_SCOPE("sdf_grid");
+    const int B = block_size;
+    // one far block of margin keeps the outer layer of blocks off the band
+    const double radius = (in_band + 0.5) * in_step;
+    const double pad = in_band * in_step + B * in_step;
+    const std::pair<_Point3, _Point3> bbox = in_model.bounding_box_();
+    _origin = bbox.first - _Point3(pad, pad, pad);
+    const _Point3 extent = bbox.second - bbox.first;
+    for (int a = 0; a < 3; ++a)
+    {
+      _num_blocks[a] = (int)ceil((extent[a] + 2 * pad) / (B * in_step)) + 1;
+      _size[a] = _num_blocks[a] * B;
+    }
+    const int num_blocks = _num_blocks[0] * _num_blocks[1] * _num_blocks[2];
+
+    // a block covers the box from its first sample to the first sample of the next one
+    std::vector<char> band(num_blocks, 0);
+    for (auto f_it = in_model.face_begin(); f_it != in_model.face_end(); ++f_it)
+    {
+      _Point3 lo = in_model.vertex_((*f_it)[0]), hi = lo;
+      for (int v = 1; v < 3; ++v)
+      {
+        const _Point3 &p = in_model.vertex_((*f_it)[v]);
+        for (int a = 0; a < 3; ++a)
+        {
+          lo[a] = std::min(lo[a], p[a]);
+          hi[a] = std::max(hi[a], p[a]);
+        }
+      }
+      int b0[3], b1[3];
+      for (int a = 0; a < 3; ++a)
+      {
+        b0[a] = std::max(0, (int)floor((lo[a] - radius - _origin[a]) / (B * in_step)));
+        b1[a] = std::min(_num_blocks[a] - 1, (int)floor((hi[a] + radius - _origin[a]) / (B * in_step)));
+      }
+      for (int i = b0[0]; i <= b1[0]; ++i)
+        for (int j = b0[1]; j <= b1[1]; ++j)
+          for (int k = b0[2]; k <= b1[2]; ++k)
+            band[(i * _num_blocks[1] + j) * _num_blocks[2] + k] = 1;
+    }
+    _block_offsets.assign(num_blocks, -1);
+    _block_values.assign(num_blocks, 0);
+    std::vector<int> band_blocks;
+    int num_stored = 0;
+    for (int b = 0; b < num_blocks; ++b)
+    {
+      if (band[b])
+        band_blocks.push_back(b);
+      if (band[b] || in_dense)
+      {
+        _block_offsets[b] = num_stored;
+        num_stored += B * B * B;
+      }
+    }
+    _values.assign(num_stored, 0);
+
+    BGAL_PROFILE_BEGIN(band, "band");
+    // exact distances in the band; point queries only read the PQP model
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int e = 0; e < band_blocks.size(); ++e)
+    {
+      const int b = band_blocks[e];
+      const int bi = b / (_num_blocks[1] * _num_blocks[2]), bj = b / _num_blocks[2] % _num_blocks[1], bk = b % _num_blocks[2];
+      float *values = &_values[_block_offsets[b]];
+      for (int i = 0; i < B; ++i)
+        for (int j = 0; j < B; ++j)
+          for (int k = 0; k < B; ++k)
+          {
+            values[(i * B + j) * B + k] = in_model.signed_distance_(position_(bi * B + i, bj * B + j, bk * B + k));
+          }
+    }
+    _num_queries = band_blocks.size() * B * B * B;
+    BGAL_PROFILE_END(band);
+
+    // sweep the unsigned distance away from the band, on the samples or on the blocks
+    int n[3];
+    double h;
+    if (in_dense)
+    {
+      for (int a = 0; a < 3; ++a)
+        n[a] = _size[a];
+      h = in_step;
+    }
+    else
+    {
+      for (int a = 0; a < 3; ++a)
+        n[a] = _num_blocks[a];
+      h = B * in_step;
+    }
+    const long long num_points = (long long)n[0] * n[1] * n[2];
+    std::vector<double> d(num_points, std::numeric_limits<double>::max());
+    std::vector<char> frozen(num_points, 0);
+#pragma omp parallel for schedule(static)
+    for (long long p = 0; p < num_points; ++p)
+    {
+      const int i = p / ((long long)n[1] * n[2]), j = p / n[2] % n[1], k = p % n[2];
+      // a block is represented by its middle sample
+      const int si = in_dense ? i : i * B + B / 2;
+      const int sj = in_dense ? j : j * B + B / 2;
+      const int sk = in_dense ? k : k * B + B / 2;
+      if (band[block_id_(si, sj, sk)])
+      {
+        frozen[p] = 1;
+        d[p] = fabs(value_(si, sj, sk));
+        if (!in_dense)
+          _block_values[p] = value_(si, sj, sk);
+      }
+    }
+    BGAL_PROFILE_BEGIN(sweep, "sweep");
+    fast_sweep_(d, frozen, n, h);
+    BGAL_PROFILE_END(sweep);
+    BGAL_PROFILE_BEGIN(flood, "flood");
+    const std::vector<char> outside = flood_outside_(frozen, n);
+    BGAL_PROFILE_END(flood);
+#pragma omp parallel for schedule(static)
+    for (long long p = 0; p < num_points; ++p)
+    {
+      if (frozen[p])
+        continue;
+      const double value = outside[p] ? d[p] : -d[p];
+      if (in_dense)
+      {
+        const int i = p / ((long long)n[1] * n[2]), j = p / n[2] % n[1], k = p % n[2];
+        _values[_block_offsets[block_id_(i, j, k)] + ((i % B) * B + j % B) * B + k % B] = value;
+      }
+      else
+      {
+        _block_values[p] = value;
+      }
+    }
+  }
+  double _Signed_Distance_Grid::value_(const int &i, const int &j, const int &k) const
+  {
+    const int b = block_id_(i, j, k);
+    if (_block_offsets[b] < 0)
+      return far_value_(i, j, k, b);
+    return _values[_block_offsets[b] + ((i % block_size) * block_size + j % block_size) * block_size + k % block_size];
+  }
+  // Trilinear interpolation of the middle samples of the blocks around. A far block is at
+  // least band steps away from the surface, which keeps its sign and bounds its distance.
+  double _Signed_Distance_Grid::far_value_(const int &i, const int &j, const int &k, const int &b) const
+  {
+    const int s[3] = {i, j, k};
+    int c[3];
+    double t[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      const double x = std::min(std::max((s[a] - block_size / 2) / (double)block_size, 0.0), _num_blocks[a] - 1.0);
+      c[a] = std::min((int)x, std::max(_num_blocks[a] - 2, 0));
+      t[a] = x - c[a];
+    }
+    double v = 0;
+    for (int e = 0; e < 8; ++e)
+    {
+      const int ci = std::min(c[0] + (e & 1), _num_blocks[0] - 1);
+      const int cj = std::min(c[1] + ((e >> 1) & 1), _num_blocks[1] - 1);
+      const int ck = std::min(c[2] + ((e >> 2) & 1), _num_blocks[2] - 1);
+      const double w = ((e & 1) ? t[0] : 1 - t[0]) * (((e >> 1) & 1) ? t[1] : 1 - t[1]) * (((e >> 2) & 1) ? t[2] : 1 - t[2]);
+      v += w * _block_values[(ci * _num_blocks[1] + cj) * _num_blocks[2] + ck];
+    }
+    const double magnitude = std::max(fabs(v), _band * _step);
+    return _block_values[b] < 0 ? -magnitude : magnitude;
+  }
+  double _Signed_Distance_Grid::sample_(const _Point3 &in_point) const
+  {
+    _Point3 gradient;
+    return sample_(in_point, gradient);
+  }
+  std::pair<double, _Point3> _Signed_Distance_Grid::field_(const _Point3 &in_point) const
+  {
+    _Point3 gradient;
+    const double value = sample_(in_point, gradient);
+    const double length = gradient.sqlength_();
+    if (length == 0)
+      return std::make_pair(value, in_point);
+    return std::make_pair(value, in_point - gradient * (value / length));
+  }
+  double _Signed_Distance_Grid::sample_(const _Point3 &in_point, _Point3 &gradient) const
+  {
+    int c[3];
+    double t[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      const double x = std::min(std::max((in_point[a] - _origin[a]) / _step, 0.0), _size[a] - 1.0);
+      c[a] = std::min((int)x, _size[a] - 2);
+      t[a] = x - c[a];
+    }
+    double v[2][2][2];
+    for (int i = 0; i < 2; ++i)
+      for (int j = 0; j < 2; ++j)
+        for (int k = 0; k < 2; ++k)
+          v[i][j][k] = value_(c[0] + i, c[1] + j, c[2] + k);
+    // interpolate along z, then y, then x
+    double vy[2][2], dvy[2][2];
+    for (int i = 0; i < 2; ++i)
+      for (int j = 0; j < 2; ++j)
+      {
+        vy[i][j] = v[i][j][0] + (v[i][j][1] - v[i][j][0]) * t[2];
+        dvy[i][j] = v[i][j][1] - v[i][j][0];
+      }
+    double vx[2], dvx_y[2], dvx_z[2];
+    for (int i = 0; i < 2; ++i)
+    {
+      vx[i] = vy[i][0] + (vy[i][1] - vy[i][0]) * t[1];
+      dvx_y[i] = vy[i][1] - vy[i][0];
+      dvx_z[i] = dvy[i][0] + (dvy[i][1] - dvy[i][0]) * t[1];
+    }
+    gradient = _Point3(vx[1] - vx[0],
+                       dvx_y[0] + (dvx_y[1] - dvx_y[0]) * t[0],
+                       dvx_z[0] + (dvx_z[1] - dvx_z[0]) * t[0]) /
+               _step;
+    return vx[0] + (vx[1] - vx[0]) * t[0];
+  }
+} // namespace BGAL
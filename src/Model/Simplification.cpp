@@ -0,0 +1,220 @@
+#include "BGAL/Model/Simplification.h"
+#include "BGAL/Algorithm/Profiler/Profiler.h"
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <tuple>
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+  typedef std::tuple<double, int, int, int, int> _Collapse; // cost, u, v, version of u, version of v
+
+  // optimal position of the collapse of an edge and its cost
+  static double collapse_position_(const Eigen::Matrix4d &q,
+                                   const Eigen::Vector3d &pu,
+                                   const Eigen::Vector3d &pv,
+                                   Eigen::Vector3d &out_p)
+  {
+    auto cost = [&](const Eigen::Vector3d &p)
+    {
+      Eigen::Vector4d h(p.x(), p.y(), p.z(), 1);
+      return h.dot(q * h);
+    };
+    Eigen::Matrix3d a = q.topLeftCorner<3, 3>();
+    double scale = a.norm();
+    if (scale > 0 && fabs(a.determinant()) > 1e-12 * scale * scale * scale)
+    {
+      out_p = a.ldlt().solve(-q.topRightCorner<3, 1>());
+      // keep the optimum near the edge, far points come from almost flat regions
+      if ((out_p - 0.5 * (pu + pv)).norm() <= (pu - pv).norm())
+        return cost(out_p);
+    }
+    Eigen::Vector3d pm = 0.5 * (pu + pv);
+    double cu = cost(pu), cv = cost(pv), cm = cost(pm);
+    if (cm <= cu && cm <= cv)
+    {
+      out_p = pm;
+      return cm;
+    }
+    out_p = cu <= cv ? pu : pv;
+    return std::min(cu, cv);
+  }
+  _ManifoldModel _Mesh_Simplification::simplify_(const _ManifoldModel &in_model, const int &in_num_faces)
+  {
+    const int nv = in_model.number_vertices_();
+    const int nf = in_model.number_faces_();
+    std::vector<Eigen::Vector3d> vertices(nv);
+    std::vector<std::array<int, 3>> faces(nf);
+    for (int i = 0; i < nv; ++i)
+    {
+      const _Point3 &p = in_model.vertex_(i);
+      vertices[i] = Eigen::Vector3d(p.x(), p.y(), p.z());
+    }
+    for (int f = 0; f < nf; ++f)
+    {
+      faces[f] = {in_model.face_(f)[0], in_model.face_(f)[1], in_model.face_(f)[2]};
+    }
+    std::vector<Eigen::Matrix4d> face_quadrics(nf);
+#pragma omp parallel for schedule(static)
+    for (int f = 0; f < nf; ++f)
+    {
+      Eigen::Vector3d n = (vertices[faces[f][1]] - vertices[faces[f][0]]).cross(vertices[faces[f][2]] - vertices[faces[f][0]]);
+      double area = n.norm() * 0.5;
+      Eigen::Vector4d plane = Eigen::Vector4d::Zero();
+      if (area > 0)
+      {
+        n.normalize();
+        plane << n, -n.dot(vertices[faces[f][0]]);
+      }
+      face_quadrics[f] = area * plane * plane.transpose();
+    }
+    std::vector<Eigen::Matrix4d> quadrics(nv, Eigen::Matrix4d::Zero());
+    std::vector<std::vector<int>> vertex_faces(nv);
+    for (int f = 0; f < nf; ++f)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        quadrics[faces[f][k]] += face_quadrics[f];
+        vertex_faces[faces[f][k]].push_back(f);
+      }
+    }
+    std::vector<bool> face_alive(nf, true), vertex_alive(nv, true);
+    std::vector<int> version(nv, 0);
+    auto neighbors = [&](const int &v)
+    {
+      std::vector<int> ns;
+      for (int f : vertex_faces[v])
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          if (faces[f][k] != v)
+            ns.push_back(faces[f][k]);
+        }
+      }
+      std::sort(ns.begin(), ns.end());
+      ns.erase(std::unique(ns.begin(), ns.end()), ns.end());
+      return ns;
+    };
+    std::priority_queue<_Collapse, std::vector<_Collapse>, std::greater<_Collapse>> heap;
+    auto push = [&](const int &u, const int &v)
+    {
+      Eigen::Vector3d p;
+      double c = collapse_position_(quadrics[u] + quadrics[v], vertices[u], vertices[v], p);
+      heap.push(std::make_tuple(c, u, v, version[u], version[v]));
+      BGAL_PROFILE_COUNT("simplification/heap_pushes", 1);
+    };
+    for (int f = 0; f < nf; ++f)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        int u = faces[f][k], v = faces[f][(k + 1) % 3];
+        if (u < v)
+          push(u, v);
+      }
+    }
+    int num_faces = nf;
+    const int target = std::max(in_num_faces, 4);
+    while (num_faces > target && !heap.empty())
+    {
+      int u = std::get<1>(heap.top());
+      int v = std::get<2>(heap.top());
+      bool is_current = vertex_alive[u] && vertex_alive[v] && version[u] == std::get<3>(heap.top()) && version[v] == std::get<4>(heap.top());
+      heap.pop();
+      if (!is_current)
+        continue;
+      // link condition: u and v only share the opposite vertices of their two common faces
+      std::vector<int> shared_faces;
+      for (int f : vertex_faces[u])
+      {
+        if (faces[f][0] == v || faces[f][1] == v || faces[f][2] == v)
+          shared_faces.push_back(f);
+      }
+      if (shared_faces.size() != 2)
+        continue;
+      std::vector<int> nu = neighbors(u), nvs = neighbors(v), common;
+      std::set_intersection(nu.begin(), nu.end(), nvs.begin(), nvs.end(), std::back_inserter(common));
+      if (common.size() != 2)
+        continue;
+      Eigen::Vector3d p;
+      collapse_position_(quadrics[u] + quadrics[v], vertices[u], vertices[v], p);
+      // no face around the edge may flip or degenerate
+      bool is_valid = true;
+      for (int w : {u, v})
+      {
+        for (int f : vertex_faces[w])
+        {
+          if (f == shared_faces[0] || f == shared_faces[1])
+            continue;
+          Eigen::Vector3d a = vertices[faces[f][0]], b = vertices[faces[f][1]], c = vertices[faces[f][2]];
+          Eigen::Vector3d n0 = (b - a).cross(c - a);
+          for (int k = 0; k < 3; ++k)
+          {
+            if (faces[f][k] == w)
+              (k == 0 ? a : (k == 1 ? b : c)) = p;
+          }
+          Eigen::Vector3d n1 = (b - a).cross(c - a);
+          if (n1.dot(n0) <= 0.2 * n0.norm() * n1.norm())
+          {
+            is_valid = false;
+            break;
+          }
+        }
+        if (!is_valid)
+          break;
+      }
+      if (!is_valid)
+        continue;
+      // collapse v into u
+      for (int f : shared_faces)
+      {
+        face_alive[f] = false;
+        for (int k = 0; k < 3; ++k)
+        {
+          std::vector<int> &vf = vertex_faces[faces[f][k]];
+          vf.erase(std::remove(vf.begin(), vf.end(), f), vf.end());
+        }
+      }
+      num_faces -= 2;
+      for (int f : vertex_faces[v])
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          if (faces[f][k] == v)
+            faces[f][k] = u;
+        }
+        vertex_faces[u].push_back(f);
+      }
+      vertex_faces[v].clear();
+      vertex_alive[v] = false;
+      vertices[u] = p;
+      quadrics[u] += quadrics[v];
+      ++version[u];
+      for (int w : neighbors(u))
+      {
+        push(std::min(u, w), std::max(u, w));
+      }
+    }
+    std::vector<int> new_ids(nv, -1);
+    std::vector<_Point3> new_vertices;
+    for (int i = 0; i < nv; ++i)
+    {
+      if (vertex_alive[i] && !vertex_faces[i].empty())
+      {
+        new_ids[i] = new_vertices.size();
+        new_vertices.push_back(_Point3(vertices[i].x(), vertices[i].y(), vertices[i].z()));
+      }
+    }
+    std::vector<_Model::_MFace> new_faces;
+    for (int f = 0; f < nf; ++f)
+    {
+      if (!face_alive[f])
+        continue;
+      int a = new_ids[faces[f][0]], b = new_ids[faces[f][1]], c = new_ids[faces[f][2]];
+      _Model::_MFace face(a, b, c, new_vertices[a], new_vertices[b], new_vertices[c]);
+      face.id = new_faces.size();
+      new_faces.push_back(face);
+    }
+    return _ManifoldModel(new_vertices, new_faces);
+  }
+} // namespace BGAL
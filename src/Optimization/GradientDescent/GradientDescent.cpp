@@ -13,13 +13,16 @@ namespace BGAL
     is_show = false;
     wolfe = 0.9;
     init_step = 1.0;
+    armijo = 1e-4;
+    max_step = 1e20;
+    more_thuente = true;
   }
   _GradientDescent::_GradientDescent()
-      : _parameter()
+      : _parameter(), _num_evaluations(0)
   {
   }
   _GradientDescent::_GradientDescent(const _Parameter &in_parameter)
-      : _parameter(in_parameter)
+      : _parameter(in_parameter), _num_evaluations(0)
   {
   }
 } // namespace BGAL
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "BGAL/Optimization/LBFGS/LBFGS.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 namespace BGAL
 {
+  static const char checkpoint_magic[8] = {'B', 'G', 'A', 'L', 'L', 'B', 'F', 'G'};
+  static const int32_t checkpoint_version = 1;
   _LBFGS::_Parameter::_Parameter()
   {
     m = 6;
@@ -12,7 +17,11 @@ namespace BGAL
     epsilon = 1e-6;
     is_show = false;
     wolfe = 0.9;
+    armijo = 1e-4;
+    max_step = 1e20;
+    more_thuente = true;
     max_time = -1.0;
+    checkpoint_interval = 10;
   }
   _LBFGS::_Parameter::_Parameter(const _Parameter &in_parameter)
   {
@@ -25,14 +34,143 @@ namespace BGAL
     epsilon = in_parameter.epsilon;
     is_show = in_parameter.is_show;
     wolfe = in_parameter.wolfe;
+    armijo = in_parameter.armijo;
+    max_step = in_parameter.max_step;
+    more_thuente = in_parameter.more_thuente;
     max_time = in_parameter.max_time;
+    callback = in_parameter.callback;
+    checkpoint_file = in_parameter.checkpoint_file;
+    checkpoint_interval = in_parameter.checkpoint_interval;
+    checkpoint_data = in_parameter.checkpoint_data;
   }
   _LBFGS::_LBFGS()
+      : _num_evaluations(0)
   {
     //_parameter = _Parameter();
   }
   _LBFGS::_LBFGS(const _Parameter &in_parameter)
-      : _parameter(in_parameter)
+      : _parameter(in_parameter), _num_evaluations(0)
   {
   }
+  void _LBFGS::allocate_(const int &n)
+  {
+    const int m = _parameter.m;
+    if (_s.rows() != n || _s.cols() != m)
+    {
+      _s.resize(n, m);
+      _y.resize(n, m);
+      _alpha.resize(m);
+      _ys.resize(m);
+      _gradient.resize(n);
+      _old_x.resize(n);
+      _old_gradient.resize(n);
+      _direction.resize(n);
+    }
+  }
+  bool _LBFGS::save_checkpoint_(const Eigen::VectorXd &iterX, const int &k, const int &l, const int &cursor,
+                                const std::chrono::steady_clock::time_point &start_t) const
+  {
+    const int32_t header[7] = {checkpoint_version, (int32_t)iterX.size(), (int32_t)_parameter.m, k, l, cursor,
+                               _num_evaluations};
+    const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_t).count();
+    const double step = 1.0;
+    Eigen::VectorXd data;
+    if (_parameter.checkpoint_data)
+      data = _parameter.checkpoint_data();
+    const int32_t data_size = data.size();
+    // written next to the old checkpoint and renamed over it, a preempted write leaves the old one intact
+    const std::string temp_file = _parameter.checkpoint_file + ".tmp";
+    {
+      std::ofstream out(temp_file, std::ios::binary);
+      if (!out)
+        return false;
+      out.write(checkpoint_magic, sizeof(checkpoint_magic));
+      out.write((const char *)header, sizeof(header));
+      out.write((const char *)&time, sizeof(double));
+      out.write((const char *)&step, sizeof(double));
+      out.write((const char *)iterX.data(), sizeof(double) * iterX.size());
+      out.write((const char *)_direction.data(), sizeof(double) * _direction.size());
+      out.write((const char *)_ys.data(), sizeof(double) * _ys.size());
+      out.write((const char *)_s.data(), sizeof(double) * _s.size());
+      out.write((const char *)_y.data(), sizeof(double) * _y.size());
+      out.write((const char *)&data_size, sizeof(int32_t));
+      out.write((const char *)data.data(), sizeof(double) * data.size());
+      if (!out)
+        return false;
+    }
+#ifdef _WIN32
+    // rename doesn't replace an existing file here, so the old one goes first;
+    // load_checkpoint_ falls back to the temporary file if we stop in between
+    std::remove(_parameter.checkpoint_file.c_str());
+#endif
+    return std::rename(temp_file.c_str(), _parameter.checkpoint_file.c_str()) == 0;
+  }
+  bool _LBFGS::load_checkpoint_(const std::string &in_file, _Checkpoint &out_checkpoint)
+  {
+    std::ifstream in(in_file, std::ios::binary);
+#ifdef _WIN32
+    if (!in)
+      in.open(in_file + ".tmp", std::ios::binary);
+#endif
+    if (!in)
+      return false;
+    char magic[8];
+    int32_t header[7];
+    in.read(magic, sizeof(magic));
+    in.read((char *)header, sizeof(header));
+    if (!in || !std::equal(magic, magic + 8, checkpoint_magic) || header[0] != checkpoint_version)
+      return false;
+    const int n = header[1], m = header[2];
+    if (n < 0 || m <= 0)
+      return false;
+    out_checkpoint.iteration = header[3];
+    out_checkpoint.total_linear_search = header[4];
+    out_checkpoint.cursor = header[5];
+    out_checkpoint.evaluations = header[6];
+    in.read((char *)&out_checkpoint.time, sizeof(double));
+    in.read((char *)&out_checkpoint.step, sizeof(double));
+    out_checkpoint.x.resize(n);
+    out_checkpoint.direction.resize(n);
+    out_checkpoint.ys.resize(m);
+    out_checkpoint.s.resize(n, m);
+    out_checkpoint.y.resize(n, m);
+    in.read((char *)out_checkpoint.x.data(), sizeof(double) * n);
+    in.read((char *)out_checkpoint.direction.data(), sizeof(double) * n);
+    in.read((char *)out_checkpoint.ys.data(), sizeof(double) * m);
+    in.read((char *)out_checkpoint.s.data(), sizeof(double) * n * m);
+    in.read((char *)out_checkpoint.y.data(), sizeof(double) * n * m);
+    int32_t data_size = 0;
+    in.read((char *)&data_size, sizeof(int32_t));
+    if (!in || data_size < 0)
+      return false;
+    out_checkpoint.data.resize(data_size);
+    in.read((char *)out_checkpoint.data.data(), sizeof(double) * data_size);
+    return (bool)in;
+  }
+  bool _LBFGS::report_(const int &k, const int &num_linear, const int &l, const double &fval, const double &gnorm,
+                       const std::chrono::steady_clock::time_point &start_t) const
+  {
+    const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_t).count();
+    if (_parameter.is_show)
+    {
+      std::cout << k << "\t" << l << "\t" << time << "\t" << gnorm << "\t" << fval << std::endl;
+    }
+    if (!_parameter.callback)
+      return true;
+    _Iteration_Info info;
+    info.iteration = k;
+    info.energy = fval;
+    info.gradient_norm = gnorm;
+    info.linear_search = num_linear;
+    info.total_linear_search = l;
+    info.evaluations = _num_evaluations;
+    info.time = time;
+    if (_parameter.callback(info))
+      return true;
+    if (_parameter.is_show)
+    {
+      std::cout << "stopped by the callback" << std::endl;
+    }
+    return false;
+  }
 } // namespace BGAL
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "BGAL/Optimization/LineSearch/LineSearch.h"
+#include <algorithm>
+
+namespace BGAL
+{
+  // minimizer of the cubic interpolating (u, fu, du) and (v, fv, dv)
+  static double cubic_minimizer_(const double &u, const double &fu, const double &du,
+                                 const double &v, const double &fv, const double &dv)
+  {
+    const double d = v - u;
+    const double theta = (fu - fv) * 3 / d + du + dv;
+    const double s = std::max(std::max(fabs(theta), fabs(du)), fabs(dv));
+    const double a = theta / s;
+    double gamma = s * sqrt(a * a - (du / s) * (dv / s));
+    if (v < u)
+      gamma = -gamma;
+    const double p = gamma - du + theta;
+    const double q = gamma - du + gamma + dv;
+    return u + p / q * d;
+  }
+  // same, but clipped to [tmin, tmax] when the cubic has no minimizer between the points
+  static double cubic_minimizer_(const double &u, const double &fu, const double &du,
+                                 const double &v, const double &fv, const double &dv,
+                                 const double &tmin, const double &tmax)
+  {
+    const double d = v - u;
+    const double theta = (fu - fv) * 3 / d + du + dv;
+    const double s = std::max(std::max(fabs(theta), fabs(du)), fabs(dv));
+    const double a = theta / s;
+    double gamma = s * sqrt(std::max(0.0, a * a - (du / s) * (dv / s)));
+    if (u < v)
+      gamma = -gamma;
+    const double p = gamma - dv + theta;
+    const double q = gamma - dv + gamma + du;
+    const double r = p / q;
+    if (r < 0 && gamma != 0)
+      return v - r * d;
+    return a < 0 ? tmax : tmin;
+  }
+  // minimizer of the quadratic interpolating (u, fu, du) and (v, fv)
+  static double quadratic_minimizer_(const double &u, const double &fu, const double &du,
+                                     const double &v, const double &fv)
+  {
+    const double a = v - u;
+    return u + du / ((fu - fv) / a + du) / 2 * a;
+  }
+  // minimizer of the quadratic interpolating the derivatives (u, du) and (v, dv)
+  static double quadratic_minimizer_(const double &u, const double &du, const double &v, const double &dv)
+  {
+    const double a = u - v;
+    return v + dv / (dv - du) * a;
+  }
+  _More_Thuente::_Parameter::_Parameter()
+  {
+    armijo = 1e-4;
+    wolfe = 0.9;
+    xtol = 1e-16;
+    min_step = 1e-20;
+    max_step = 1e20;
+    max_evaluation = 20;
+  }
+  bool _More_Thuente::update_interval_(double &x, double &fx, double &dx,
+                                       double &y, double &fy, double &dy,
+                                       double &t, const double &ft, const double &dt,
+                                       const double &tmin, const double &tmax, bool &brackt)
+  {
+    const bool dsign = dt * (dx / fabs(dx)) < 0;
+    if (brackt)
+    {
+      if (t <= std::min(x, y) || std::max(x, y) <= t)
+        return false;
+      if (0 <= dx * (t - x))
+        return false;
+      if (tmax < tmin)
+        return false;
+    }
+    bool bound;
+    double newt;
+    if (fx < ft)
+    {
+      // higher function value: the minimum is bracketed
+      brackt = true;
+      bound = true;
+      const double mc = cubic_minimizer_(x, fx, dx, t, ft, dt);
+      const double mq = quadratic_minimizer_(x, fx, dx, t, ft);
+      newt = fabs(mc - x) < fabs(mq - x) ? mc : mc + 0.5 * (mq - mc);
+    }
+    else if (dsign)
+    {
+      // derivatives of opposite sign: the minimum is bracketed
+      brackt = true;
+      bound = false;
+      const double mc = cubic_minimizer_(x, fx, dx, t, ft, dt);
+      const double mq = quadratic_minimizer_(x, dx, t, dt);
+      newt = fabs(mc - t) > fabs(mq - t) ? mc : mq;
+    }
+    else if (fabs(dt) < fabs(dx))
+    {
+      // lower value, same sign, smaller derivative
+      bound = true;
+      const double mc = cubic_minimizer_(x, fx, dx, t, ft, dt, tmin, tmax);
+      const double mq = quadratic_minimizer_(x, dx, t, dt);
+      if (brackt)
+        newt = fabs(t - mc) < fabs(t - mq) ? mc : mq;
+      else
+        newt = fabs(t - mc) > fabs(t - mq) ? mc : mq;
+    }
+    else
+    {
+      // lower value, same sign, larger derivative
+      bound = false;
+      if (brackt)
+        newt = cubic_minimizer_(t, ft, dt, y, fy, dy);
+      else
+        newt = x < t ? tmax : tmin;
+    }
+    if (fx < ft)
+    {
+      y = t;
+      fy = ft;
+      dy = dt;
+    }
+    else
+    {
+      if (dsign)
+      {
+        y = x;
+        fy = fx;
+        dy = dx;
+      }
+      x = t;
+      fx = ft;
+      dx = dt;
+    }
+    newt = std::min(newt, tmax);
+    newt = std::max(newt, tmin);
+    if (brackt && bound)
+    {
+      const double mq = x + 0.66 * (y - x);
+      if (x < y)
+        newt = std::min(newt, mq);
+      else
+        newt = std::max(newt, mq);
+    }
+    t = newt;
+    return true;
+  }
+} // namespace BGAL
@@ -0,0 +1,101 @@
+#include "BGAL/Optimization/VectorKernel/VectorKernel.h"
+#include <omp.h>
+
+namespace BGAL
+{
+  double _Vector_Kernel::dot_(const Eigen::Ref<const Eigen::VectorXd> &a, const Eigen::Ref<const Eigen::VectorXd> &b)
+  {
+    const int n = a.size();
+    const double *pa = a.data();
+    const double *pb = b.data();
+    double sum = 0;
+#pragma omp parallel for reduction(+ : sum) schedule(static) if (n >= parallel_size)
+    for (int i = 0; i < n; ++i)
+    {
+      sum += pa[i] * pb[i];
+    }
+    return sum;
+  }
+  void _Vector_Kernel::axpy_(const double &a, const Eigen::Ref<const Eigen::VectorXd> &x, Eigen::Ref<Eigen::VectorXd> y)
+  {
+    const int n = x.size();
+    const double *px = x.data();
+    double *py = y.data();
+#pragma omp parallel for schedule(static) if (n >= parallel_size)
+    for (int i = 0; i < n; ++i)
+    {
+      py[i] += a * px[i];
+    }
+  }
+  double _Vector_Kernel::axpy_dot_(const double &a,
+                                   const Eigen::Ref<const Eigen::VectorXd> &x,
+                                   Eigen::Ref<Eigen::VectorXd> y,
+                                   const Eigen::Ref<const Eigen::VectorXd> &z)
+  {
+    const int n = x.size();
+    const double *px = x.data();
+    const double *pz = z.data();
+    double *py = y.data();
+    double sum = 0;
+#pragma omp parallel for reduction(+ : sum) schedule(static) if (n >= parallel_size)
+    for (int i = 0; i < n; ++i)
+    {
+      py[i] += a * px[i];
+      sum += pz[i] * py[i];
+    }
+    return sum;
+  }
+  void _Vector_Kernel::add_scaled_(Eigen::Ref<Eigen::VectorXd> out,
+                                   const Eigen::Ref<const Eigen::VectorXd> &x,
+                                   const double &a,
+                                   const Eigen::Ref<const Eigen::VectorXd> &d)
+  {
+    const int n = x.size();
+    const double *px = x.data();
+    const double *pd = d.data();
+    double *po = out.data();
+#pragma omp parallel for schedule(static) if (n >= parallel_size)
+    for (int i = 0; i < n; ++i)
+    {
+      po[i] = px[i] + a * pd[i];
+    }
+  }
+  void _Vector_Kernel::scale_(const double &a, Eigen::Ref<Eigen::VectorXd> y)
+  {
+    const int n = y.size();
+    double *py = y.data();
+#pragma omp parallel for schedule(static) if (n >= parallel_size)
+    for (int i = 0; i < n; ++i)
+    {
+      py[i] *= a;
+    }
+  }
+  double _Vector_Kernel::difference_(Eigen::Ref<Eigen::VectorXd> s,
+                                     Eigen::Ref<Eigen::VectorXd> y,
+                                     const Eigen::Ref<const Eigen::VectorXd> &x,
+                                     const Eigen::Ref<const Eigen::VectorXd> &old_x,
+                                     const Eigen::Ref<const Eigen::VectorXd> &g,
+                                     const Eigen::Ref<const Eigen::VectorXd> &old_g,
+                                     double &out_yy)
+  {
+    const int n = x.size();
+    const double *px = x.data();
+    const double *pox = old_x.data();
+    const double *pg = g.data();
+    const double *pog = old_g.data();
+    double *ps = s.data();
+    double *py = y.data();
+    double ys = 0;
+    double yy = 0;
+#pragma omp parallel for reduction(+ : ys, yy) schedule(static) if (n >= parallel_size)
+    for (int i = 0; i < n; ++i)
+    {
+      ps[i] = px[i] - pox[i];
+      py[i] = pg[i] - pog[i];
+      ys += py[i] * ps[i];
+      yy += py[i] * py[i];
+    }
+    out_yy = yy;
+    return ys;
+  }
+} // namespace BGAL
@@ -0,0 +1,130 @@
+#include "BGAL/PointCloudProcessing/Denoiser/Denoiser.h"
+#include "BGAL/PointCloudProcessing/Neighborhood/Neighborhood.h"
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <omp.h>
+
+namespace BGAL
+{
+	_PointCloudDenoiser::_Parameter::_Parameter()
+	{
+		k = 16;
+		normal_iteration = 5;
+		position_iteration = 10;
+		sigma_s = -1;
+		sigma_r = 0.35;
+		step = 0.5;
+	}
+	_PointCloudDenoiser::_PointCloudDenoiser() : _time(0)
+	{
+	}
+	_PointCloudDenoiser::_PointCloudDenoiser(const _Parameter& in_parameter)
+		: _parameter(in_parameter), _time(0)
+	{
+	}
+	void _PointCloudDenoiser::denoise_(const std::vector<Eigen::Vector3d>& in_points,
+	                                   const std::vector<Eigen::Vector3d>& in_normals)
+	{
+		_Neighborhood nbh;
+		nbh._parameter.k = _parameter.k;
+		nbh._parameter.max_k = _parameter.k;
+		nbh._parameter.include_self = false;
+		nbh.build_(in_points);
+		denoise_(in_points, in_normals, nbh.get_offsets_(), nbh.get_indices_());
+	}
+	void _PointCloudDenoiser::denoise_(const std::vector<Eigen::Vector3d>& in_points,
+	                                   const std::vector<Eigen::Vector3d>& in_normals,
+	                                   const std::vector<int>& in_offsets,
+	                                   const std::vector<int>& in_indices)
+	{
+		const int num = in_points.size();
+		if ((int)in_normals.size() != num || (int)in_offsets.size() != num + 1)
+			throw std::runtime_error("sizes of the inputs don't match!");
+		auto start = std::chrono::steady_clock::now();
+		// per-point spatial kernel width
+		std::vector<double> inv_s(num, 0);
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < num; ++i)
+		{
+			double s = _parameter.sigma_s;
+			if (s <= 0)
+			{
+				s = 0;
+				for (int j = in_offsets[i]; j < in_offsets[i + 1]; ++j)
+				{
+					s += (in_points[in_indices[j]] - in_points[i]).norm();
+				}
+				s = in_offsets[i + 1] > in_offsets[i] ? s / (in_offsets[i + 1] - in_offsets[i]) : 0;
+			}
+			inv_s[i] = s > 0 ? 1.0 / (2 * s * s) : 0;
+		}
+		const double inv_r = _parameter.sigma_r > 0 ? 1.0 / (2 * _parameter.sigma_r * _parameter.sigma_r) : 0;
+
+		std::vector<Eigen::Vector3d> normals[2];
+		normals[0].resize(num);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < num; ++i)
+		{
+			const double len = in_normals[i].norm();
+			normals[0][i] = len > 0 ? Eigen::Vector3d(in_normals[i] / len) : in_normals[i];
+		}
+		normals[1] = normals[0];
+		int cur = 0;
+		for (int it = 0; it < _parameter.normal_iteration; ++it)
+		{
+			const std::vector<Eigen::Vector3d>& src = normals[cur];
+			std::vector<Eigen::Vector3d>& dst = normals[1 - cur];
+#pragma omp parallel for schedule(dynamic, 256)
+			for (int i = 0; i < num; ++i)
+			{
+				const Eigen::Vector3d& ni = src[i];
+				Eigen::Vector3d sum = ni;
+				for (int j = in_offsets[i]; j < in_offsets[i + 1]; ++j)
+				{
+					const int pj = in_indices[j];
+					const double c = ni.dot(src[pj]);
+					// |n_i - n_j|^2 of unit normals after the flip
+					const double w = exp(-(in_points[pj] - in_points[i]).squaredNorm() * inv_s[i]
+						- (2 - 2 * fabs(c)) * inv_r);
+					sum += c < 0 ? Eigen::Vector3d(-w * src[pj]) : Eigen::Vector3d(w * src[pj]);
+				}
+				const double len = sum.norm();
+				dst[i] = len > 1e-12 ? Eigen::Vector3d(sum / len) : ni;
+			}
+			cur = 1 - cur;
+		}
+		_normals.swap(normals[cur]);
+
+		std::vector<Eigen::Vector3d> points[2];
+		points[0] = in_points;
+		points[1] = in_points;
+		cur = 0;
+		for (int it = 0; it < _parameter.position_iteration; ++it)
+		{
+			const std::vector<Eigen::Vector3d>& src = points[cur];
+			std::vector<Eigen::Vector3d>& dst = points[1 - cur];
+#pragma omp parallel for schedule(dynamic, 256)
+			for (int i = 0; i < num; ++i)
+			{
+				const Eigen::Vector3d& pi = src[i];
+				const Eigen::Vector3d& ni = _normals[i];
+				Eigen::Vector3d move(0, 0, 0);
+				double wsum = 0;
+				for (int j = in_offsets[i]; j < in_offsets[i + 1]; ++j)
+				{
+					const int pj = in_indices[j];
+					const Eigen::Vector3d& nj = _normals[pj];
+					const Eigen::Vector3d d = src[pj] - pi;
+					const double w = exp(-d.squaredNorm() * inv_s[i] - (2 - 2 * fabs(ni.dot(nj))) * inv_r);
+					move += 0.5 * w * (d.dot(nj) * nj + d.dot(ni) * ni);
+					wsum += w;
+				}
+				dst[i] = wsum > 0 ? Eigen::Vector3d(pi + _parameter.step * move / wsum) : pi;
+			}
+			cur = 1 - cur;
+		}
+		_points.swap(points[cur]);
+		_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+} // namespace BGAL
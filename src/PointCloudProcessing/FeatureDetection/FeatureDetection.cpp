@@ -0,0 +1,147 @@
+#include "BGAL/PointCloudProcessing/FeatureDetection/FeatureDetection.h"
+#include <algorithm>
+#include <stdexcept>
+#include <omp.h>
+
+namespace BGAL
+{
+	_Feature_Detection::_Parameter::_Parameter()
+	{
+		min_neighbors = 5;
+		max_iteration = 10;
+		smooth_threshold = 0.3;
+	}
+	_Feature_Detection::_Feature_Detection()
+	{
+	}
+	_Feature_Detection::_Feature_Detection(const _Parameter& in_parameter)
+		: _parameter(in_parameter)
+	{
+	}
+	double _Feature_Detection::two_normals_(const std::vector<Eigen::Vector3d>& in_normals,
+	                                        const int* in_neighbors,
+	                                        const int& k,
+	                                        const int& max_iteration,
+	                                        double* d,
+	                                        int* order,
+	                                        Eigen::Vector3d& n1,
+	                                        Eigen::Vector3d& n2)
+	{
+		// seed with the first normal and the normal farthest from it
+		n1 = in_normals[in_neighbors[0]];
+		n2 = n1;
+		double maxd = -1;
+		for (int j = 1; j < k; ++j)
+		{
+			double dj = (in_normals[in_neighbors[j]] - n1).squaredNorm();
+			if (dj > maxd)
+			{
+				maxd = dj;
+				n2 = in_normals[in_neighbors[j]];
+			}
+		}
+		if (n1.norm() > 1e-12)
+			n1.normalize();
+		if (n2.norm() > 1e-12)
+			n2.normalize();
+		// the balanced constraint puts k/2 normals in the first cluster; for odd k the
+		// median normal is shared half and half
+		const int nfull = k / 2;
+		const bool odd = (k % 2) == 1;
+		// closed-form update of the assignment x for fixed n1, n2: take the nfull normals
+		// with the smallest d_j = |N_j - n1|^2 - |N_j - n2|^2
+		auto assign = [&]() -> double
+		{
+			double e = 0;
+			for (int j = 0; j < k; ++j)
+			{
+				const Eigen::Vector3d& nj = in_normals[in_neighbors[j]];
+				const double e2 = (nj - n2).squaredNorm();
+				d[j] = (nj - n1).squaredNorm() - e2;
+				e += e2;
+				order[j] = j;
+			}
+			std::nth_element(order, order + nfull, order + k, [&](int lhs, int rhs)
+			{
+				return d[lhs] < d[rhs];
+			});
+			for (int j = 0; j < nfull; ++j)
+			{
+				e += d[order[j]];
+			}
+			if (odd)
+			{
+				e += 0.5 * d[order[nfull]];
+			}
+			return e;
+		};
+		double energy = assign();
+		for (int it = 0; it < max_iteration; ++it)
+		{
+			// closed-form update of n1, n2 for fixed x: normalized cluster means
+			Eigen::Vector3d s1(0, 0, 0);
+			Eigen::Vector3d s2(0, 0, 0);
+			for (int j = 0; j < nfull; ++j)
+			{
+				s1 += in_normals[in_neighbors[order[j]]];
+			}
+			for (int j = nfull + (odd ? 1 : 0); j < k; ++j)
+			{
+				s2 += in_normals[in_neighbors[order[j]]];
+			}
+			if (odd)
+			{
+				s1 += 0.5 * in_normals[in_neighbors[order[nfull]]];
+				s2 += 0.5 * in_normals[in_neighbors[order[nfull]]];
+			}
+			const Eigen::Vector3d o1 = n1;
+			const Eigen::Vector3d o2 = n2;
+			if (s1.norm() > 1e-12)
+				n1 = s1.normalized();
+			if (s2.norm() > 1e-12)
+				n2 = s2.normalized();
+			energy = assign();
+			if ((n1 - o1).squaredNorm() + (n2 - o2).squaredNorm() < 1e-24)
+				break;
+		}
+		return energy;
+	}
+	void _Feature_Detection::detect_(const std::vector<Eigen::Vector3d>& in_normals,
+	                                 const std::vector<int>& in_offsets,
+	                                 const std::vector<int>& in_indices)
+	{
+		if (in_offsets.empty() || (int)in_offsets.size() - 1 != (int)in_normals.size())
+			throw std::runtime_error("offsets don't match the normals!");
+		const int num = in_normals.size();
+		_is_valid.assign(num, 0);
+		_is_smooth.assign(num, 0);
+		_normals1.assign(num, Eigen::Vector3d::Zero());
+		_normals2.assign(num, Eigen::Vector3d::Zero());
+		_energies.assign(num, 0);
+		int max_k = 0;
+		for (int i = 0; i < num; ++i)
+		{
+			max_k = std::max(max_k, in_offsets[i + 1] - in_offsets[i]);
+		}
+		const int min_k = std::max(_parameter.min_neighbors, 1);
+#pragma omp parallel
+		{
+			std::vector<double> d(max_k);
+			std::vector<int> order(max_k);
+#pragma omp for schedule(dynamic, 256)
+			for (int i = 0; i < num; ++i)
+			{
+				const int k = in_offsets[i + 1] - in_offsets[i];
+				if (k < min_k)
+					continue;
+				Eigen::Vector3d n1, n2;
+				_energies[i] = two_normals_(in_normals, in_indices.data() + in_offsets[i], k, _parameter.max_iteration,
+				                            d.data(), order.data(), n1, n2);
+				_normals1[i] = n1;
+				_normals2[i] = n2;
+				_is_valid[i] = 1;
+				_is_smooth[i] = (n1 - n2).norm() < _parameter.smooth_threshold ? 1 : 0;
+			}
+		}
+	}
+} // namespace BGAL
@@ -0,0 +1,169 @@
+#include "BGAL/PointCloudProcessing/FeatureProjection/FeatureProjection.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <omp.h>
+
+namespace BGAL
+{
+	_Feature_Projection::_Parameter::_Parameter()
+	{
+		mu = 0.01;
+		min_displacement = 1e-4;
+		max_displacement = -1.0;
+		degenerate_eps = 1e-12;
+		block_size = 64;
+	}
+	_Feature_Projection::_Feature_Projection() : _num_projected(0), _num_degenerate(0)
+	{
+	}
+	_Feature_Projection::_Feature_Projection(const _Parameter& in_parameter)
+		: _parameter(in_parameter), _num_projected(0), _num_degenerate(0)
+	{
+	}
+	Eigen::Vector3d _Feature_Projection::solve_degenerate_(const double* a, const Eigen::Vector3d& b,
+	                                                       const Eigen::Vector3d& in_origin, const double& eps)
+	{
+		Eigen::Matrix3d A;
+		A << a[0], a[1], a[2],
+			a[1], a[3], a[4],
+			a[2], a[4], a[5];
+		Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> es;
+		es.computeDirect(A);
+		const Eigen::Vector3d& lambda = es.eigenvalues();
+		const double lmax = lambda.cwiseAbs().maxCoeff();
+		if (!(lmax > 0))
+			return in_origin;
+		const Eigen::Vector3d r = b - A * in_origin;
+		Eigen::Vector3d dz(0, 0, 0);
+		for (int l = 0; l < 3; ++l)
+		{
+			if (fabs(lambda(l)) > eps * lmax)
+			{
+				const Eigen::Vector3d v = es.eigenvectors().col(l);
+				dz += v * (v.dot(r) / lambda(l));
+			}
+		}
+		return in_origin + dz;
+	}
+	void _Feature_Projection::project_(const std::vector<Eigen::Vector3d>& in_points,
+	                                   const std::vector<Eigen::Vector3d>& in_normals,
+	                                   const std::vector<int>& in_offsets,
+	                                   const std::vector<int>& in_indices,
+	                                   const std::vector<int>& in_is_candidate)
+	{
+		const int num = in_points.size();
+		if ((int)in_normals.size() != num || (int)in_is_candidate.size() != num || (int)in_offsets.size() != num + 1)
+			throw std::runtime_error("sizes of the inputs don't match!");
+		_points = in_points;
+		_is_projected.assign(num, 0);
+		std::vector<int> candidates;
+		for (int i = 0; i < num; ++i)
+		{
+			if (in_is_candidate[i] && in_offsets[i + 1] > in_offsets[i])
+				candidates.push_back(i);
+		}
+		const int nc = candidates.size();
+		const int B = std::max(_parameter.block_size, 1);
+		const int nblocks = (nc + B - 1) / B;
+		const double mu = _parameter.mu;
+		const double eps = _parameter.degenerate_eps;
+		int num_projected = 0;
+		int num_degenerate = 0;
+#pragma omp parallel reduction(+ : num_projected, num_degenerate)
+		{
+			// structure-of-arrays block: the six upper entries of A, b and the solution z
+			std::vector<double> soa(12 * B);
+			std::vector<int> degenerate(B);
+			double* a00 = soa.data();
+			double* a01 = a00 + B;
+			double* a02 = a01 + B;
+			double* a11 = a02 + B;
+			double* a12 = a11 + B;
+			double* a22 = a12 + B;
+			double* b0 = a22 + B;
+			double* b1 = b0 + B;
+			double* b2 = b1 + B;
+			double* z0 = b2 + B;
+			double* z1 = z0 + B;
+			double* z2 = z1 + B;
+			int* deg = degenerate.data();
+#pragma omp for schedule(dynamic, 1)
+			for (int blk = 0; blk < nblocks; ++blk)
+			{
+				const int begin = blk * B;
+				const int cnt = std::min(B, nc - begin);
+				for (int t = 0; t < cnt; ++t)
+				{
+					const int i = candidates[begin + t];
+					const Eigen::Vector3d& pi = in_points[i];
+					double s00 = mu, s01 = 0, s02 = 0, s11 = mu, s12 = 0, s22 = mu;
+					double r0 = mu * pi.x(), r1 = mu * pi.y(), r2 = mu * pi.z();
+					for (int j = in_offsets[i]; j < in_offsets[i + 1]; ++j)
+					{
+						const Eigen::Vector3d& n = in_normals[in_indices[j]];
+						const double d = n.dot(in_points[in_indices[j]]);
+						s00 += n.x() * n.x();
+						s01 += n.x() * n.y();
+						s02 += n.x() * n.z();
+						s11 += n.y() * n.y();
+						s12 += n.y() * n.z();
+						s22 += n.z() * n.z();
+						r0 += d * n.x();
+						r1 += d * n.y();
+						r2 += d * n.z();
+					}
+					a00[t] = s00;
+					a01[t] = s01;
+					a02[t] = s02;
+					a11[t] = s11;
+					a12[t] = s12;
+					a22[t] = s22;
+					b0[t] = r0;
+					b1[t] = r1;
+					b2[t] = r2;
+				}
+				// branch-free cofactor solve of the whole block
+#pragma omp simd
+				for (int t = 0; t < cnt; ++t)
+				{
+					const double c00 = a11[t] * a22[t] - a12[t] * a12[t];
+					const double c01 = a02[t] * a12[t] - a01[t] * a22[t];
+					const double c02 = a01[t] * a12[t] - a02[t] * a11[t];
+					const double c11 = a00[t] * a22[t] - a02[t] * a02[t];
+					const double c12 = a01[t] * a02[t] - a00[t] * a12[t];
+					const double c22 = a00[t] * a11[t] - a01[t] * a01[t];
+					const double det = a00[t] * c00 + a01[t] * c01 + a02[t] * c02;
+					const double scale = std::max(std::max(fabs(a00[t]), fabs(a11[t])), fabs(a22[t]));
+					const int is_deg = !(fabs(det) > eps * scale * scale * scale);
+					const double inv = is_deg ? 0.0 : 1.0 / det;
+					deg[t] = is_deg;
+					z0[t] = (c00 * b0[t] + c01 * b1[t] + c02 * b2[t]) * inv;
+					z1[t] = (c01 * b0[t] + c11 * b1[t] + c12 * b2[t]) * inv;
+					z2[t] = (c02 * b0[t] + c12 * b1[t] + c22 * b2[t]) * inv;
+				}
+				for (int t = 0; t < cnt; ++t)
+				{
+					const int i = candidates[begin + t];
+					Eigen::Vector3d z(z0[t], z1[t], z2[t]);
+					if (deg[t])
+					{
+						const double a[6] = { a00[t], a01[t], a02[t], a11[t], a12[t], a22[t] };
+						z = solve_degenerate_(a, Eigen::Vector3d(b0[t], b1[t], b2[t]), in_points[i], eps);
+						++num_degenerate;
+					}
+					const double dis = (z - in_points[i]).norm();
+					if (dis > _parameter.min_displacement
+						&& (_parameter.max_displacement <= 0 || dis <= _parameter.max_displacement))
+					{
+						_points[i] = z;
+						_is_projected[i] = 1;
+						++num_projected;
+					}
+				}
+			}
+		}
+		_num_projected = num_projected;
+		_num_degenerate = num_degenerate;
+	}
+} // namespace BGAL
@@ -0,0 +1,567 @@
+#include "BGAL/PointCloudProcessing/IO/PointCloudIO.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <omp.h>
+
+namespace BGAL
+{
+	static std::string lower_extension_(const std::string& in_file_name)
+	{
+		size_t dot = in_file_name.rfind('.');
+		std::string ext = dot == std::string::npos ? "" : in_file_name.substr(dot + 1);
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c)
+		{
+			return std::tolower(c);
+		});
+		return ext;
+	}
+	static bool is_little_endian_()
+	{
+		const int one = 1;
+		return *(const char*)&one == 1;
+	}
+	// PLY scalar types: 0 int8, 1 uint8, 2 int16, 3 uint16, 4 int32, 5 uint32, 6 float32, 7 float64
+	static int ply_type_(const std::string& in_name)
+	{
+		static const char* names[8][2] = {
+			{ "char", "int8" }, { "uchar", "uint8" }, { "short", "int16" }, { "ushort", "uint16" },
+			{ "int", "int32" }, { "uint", "uint32" }, { "float", "float32" }, { "double", "float64" } };
+		for (int t = 0; t < 8; ++t)
+		{
+			if (in_name == names[t][0] || in_name == names[t][1])
+				return t;
+		}
+		throw std::runtime_error("unknown PLY property type: " + in_name);
+	}
+	static int ply_type_size_(const int& in_type)
+	{
+		static const int sizes[8] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+		return sizes[in_type];
+	}
+	static double ply_value_(const char* in_p, const int& in_type)
+	{
+		switch (in_type)
+		{
+		case 0:
+		{
+			int8_t v;
+			memcpy(&v, in_p, 1);
+			return v;
+		}
+		case 1:
+		{
+			uint8_t v;
+			memcpy(&v, in_p, 1);
+			return v;
+		}
+		case 2:
+		{
+			int16_t v;
+			memcpy(&v, in_p, 2);
+			return v;
+		}
+		case 3:
+		{
+			uint16_t v;
+			memcpy(&v, in_p, 2);
+			return v;
+		}
+		case 4:
+		{
+			int32_t v;
+			memcpy(&v, in_p, 4);
+			return v;
+		}
+		case 5:
+		{
+			uint32_t v;
+			memcpy(&v, in_p, 4);
+			return v;
+		}
+		case 6:
+		{
+			float v;
+			memcpy(&v, in_p, 4);
+			return v;
+		}
+		default:
+		{
+			double v;
+			memcpy(&v, in_p, 8);
+			return v;
+		}
+		}
+	}
+
+	_PointCloud_Reader::_PointCloud_Reader()
+		: _format(_Format::XYZ), _chunk_bytes(64 << 20), _has_normals(false), _num_points(-1), _num_read(0),
+		  _num_columns(0), _stride(0)
+	{
+	}
+	_PointCloud_Reader::_PointCloud_Reader(const std::string& in_file_name, const size_t& in_chunk_bytes)
+		: _PointCloud_Reader()
+	{
+		open_(in_file_name, in_chunk_bytes);
+	}
+	_PointCloud_Reader::~_PointCloud_Reader()
+	{
+		close_();
+	}
+	void _PointCloud_Reader::close_()
+	{
+		if (_in.is_open())
+			_in.close();
+		_rest.clear();
+		std::vector<char>().swap(_buffer);
+		_has_normals = false;
+		_num_points = -1;
+		_num_read = 0;
+	}
+	void _PointCloud_Reader::open_(const std::string& in_file_name, const size_t& in_chunk_bytes)
+	{
+		close_();
+		_chunk_bytes = std::max<size_t>(in_chunk_bytes, 1 << 10);
+		_in.open(in_file_name, std::ios::binary);
+		if (_in.fail())
+			throw std::runtime_error("fail to read file: " + in_file_name);
+		if (lower_extension_(in_file_name) == "ply")
+		{
+			read_ply_header_();
+			return;
+		}
+		// the first data line tells whether the file has normals
+		_format = _Format::XYZ;
+		std::string line;
+		int count = 0;
+		while (count < 3 && std::getline(_in, line))
+		{
+			std::istringstream sline(line);
+			double v;
+			count = 0;
+			while (sline >> v)
+			{
+				++count;
+			}
+		}
+		_has_normals = count >= 6;
+		_num_columns = _has_normals ? 6 : 3;
+		for (int c = 0; c < 6; ++c)
+		{
+			_columns[c] = c < _num_columns ? c : -1;
+		}
+		_in.clear();
+		_in.seekg(0);
+	}
+	void _PointCloud_Reader::read_ply_header_()
+	{
+		std::string line;
+		std::getline(_in, line);
+		if (line.compare(0, 3, "ply") != 0)
+			throw std::runtime_error("not a PLY file!");
+		static const char* names[6] = { "x", "y", "z", "nx", "ny", "nz" };
+		for (int c = 0; c < 6; ++c)
+		{
+			_columns[c] = -1;
+			_offsets[c] = -1;
+			_types[c] = -1;
+		}
+		_num_columns = 0;
+		_stride = 0;
+		bool is_ascii = false, in_vertex = false, found_vertex = false;
+		// elements in front of the vertices have to be skipped
+		long long skip_bytes = 0, skip_lines = 0, element_count = 0, element_size = 0;
+		auto close_element = [&]()
+		{
+			if (!in_vertex && !found_vertex)
+			{
+				skip_bytes += element_count * element_size;
+				skip_lines += element_count;
+			}
+		};
+		while (std::getline(_in, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+			std::istringstream sline(line);
+			std::string word;
+			sline >> word;
+			if (word == "format")
+			{
+				std::string format;
+				sline >> format;
+				if (format == "ascii")
+					is_ascii = true;
+				else if (format != "binary_little_endian")
+					throw std::runtime_error("unsupported PLY format: " + format);
+			}
+			else if (word == "element")
+			{
+				close_element();
+				if (in_vertex)
+					found_vertex = true;
+				std::string name;
+				sline >> name >> element_count;
+				element_size = 0;
+				in_vertex = !found_vertex && name == "vertex";
+				if (in_vertex)
+					_num_points = element_count;
+			}
+			else if (word == "property")
+			{
+				std::string type, name;
+				sline >> type;
+				if (type == "list")
+				{
+					if (in_vertex || !found_vertex)
+						throw std::runtime_error("list properties in front of the PLY vertex data are unsupported!");
+					continue;
+				}
+				sline >> name;
+				const int t = ply_type_(type);
+				if (in_vertex)
+				{
+					for (int c = 0; c < 6; ++c)
+					{
+						if (name == names[c])
+						{
+							_columns[c] = _num_columns;
+							_offsets[c] = _stride;
+							_types[c] = t;
+						}
+					}
+					++_num_columns;
+					_stride += ply_type_size_(t);
+				}
+				else
+				{
+					element_size += ply_type_size_(t);
+				}
+			}
+			else if (word == "end_header")
+			{
+				break;
+			}
+		}
+		close_element();
+		if (_num_points < 0 || _columns[0] < 0 || _columns[1] < 0 || _columns[2] < 0)
+			throw std::runtime_error("the PLY file has no vertex positions!");
+		_has_normals = _columns[3] >= 0 && _columns[4] >= 0 && _columns[5] >= 0;
+		if (is_ascii)
+		{
+			_format = _Format::PLY_ASCII;
+			for (long long l = 0; l < skip_lines; ++l)
+			{
+				std::getline(_in, line);
+			}
+		}
+		else
+		{
+			if (!is_little_endian_())
+				throw std::runtime_error("binary PLY needs a little-endian host!");
+			_format = _Format::PLY_BINARY;
+			_in.seekg(skip_bytes, std::ios::cur);
+		}
+	}
+	int _PointCloud_Reader::parse_ascii_(const char* in_begin, const char* in_end,
+	                                     std::vector<Eigen::Vector3d>& out_points,
+	                                     std::vector<Eigen::Vector3d>& out_normals) const
+	{
+		int required = 0;
+		for (int c = 0; c < (_has_normals ? 6 : 3); ++c)
+		{
+			required = std::max(required, _columns[c] + 1);
+		}
+		const int num_seg = std::max(1, omp_get_max_threads());
+		// segments start at line beginnings
+		std::vector<const char*> seg(num_seg + 1, in_end);
+		seg[0] = in_begin;
+		for (int s = 1; s < num_seg; ++s)
+		{
+			const char* p = in_begin + (in_end - in_begin) * s / num_seg;
+			p = std::max(p, seg[s - 1]);
+			while (p > in_begin && p < in_end && p[-1] != '\n')
+			{
+				++p;
+			}
+			seg[s] = p;
+		}
+		std::vector<std::vector<double>> values(num_seg);
+#pragma omp parallel for schedule(static, 1)
+		for (int s = 0; s < num_seg; ++s)
+		{
+			std::vector<double>& vals = values[s];
+			std::vector<double> line(required);
+			const char* p = seg[s];
+			while (p < seg[s + 1])
+			{
+				int col = 0;
+				while (col < required)
+				{
+					while (p < seg[s + 1] && (*p == ' ' || *p == '\t' || *p == '\r' || *p == ','))
+					{
+						++p;
+					}
+					if (p >= seg[s + 1] || *p == '\n')
+						break;
+					char* q;
+					double v = strtod(p, &q);
+					if (q == p)
+						break;
+					line[col++] = v;
+					p = q;
+				}
+				if (col == required)
+				{
+					for (int c = 0; c < (_has_normals ? 6 : 3); ++c)
+					{
+						vals.push_back(line[_columns[c]]);
+					}
+				}
+				while (p < seg[s + 1] && *p != '\n')
+				{
+					++p;
+				}
+				++p;
+			}
+		}
+		const int dim = _has_normals ? 6 : 3;
+		std::vector<int> start(num_seg + 1, 0);
+		for (int s = 0; s < num_seg; ++s)
+		{
+			start[s + 1] = start[s] + values[s].size() / dim;
+		}
+		out_points.resize(start[num_seg]);
+		out_normals.resize(_has_normals ? start[num_seg] : 0);
+#pragma omp parallel for schedule(static, 1)
+		for (int s = 0; s < num_seg; ++s)
+		{
+			const std::vector<double>& vals = values[s];
+			for (int i = start[s]; i < start[s + 1]; ++i)
+			{
+				const double* v = vals.data() + (i - start[s]) * dim;
+				out_points[i] = Eigen::Vector3d(v[0], v[1], v[2]);
+				if (_has_normals)
+					out_normals[i] = Eigen::Vector3d(v[3], v[4], v[5]);
+			}
+		}
+		return start[num_seg];
+	}
+	int _PointCloud_Reader::read_(std::vector<Eigen::Vector3d>& out_points, std::vector<Eigen::Vector3d>& out_normals)
+	{
+		out_points.clear();
+		out_normals.clear();
+		if (!_in.is_open())
+			return 0;
+		if (_format != _Format::XYZ && _num_read >= _num_points)
+			return 0;
+		if (_format == _Format::PLY_BINARY)
+		{
+			const int n = std::min<long long>(_num_points - _num_read, std::max<size_t>(_chunk_bytes / _stride, 1));
+			_buffer.resize((size_t)n * _stride);
+			_in.read(_buffer.data(), (size_t)n * _stride);
+			if (_in.gcount() != (std::streamsize)n * _stride)
+				throw std::runtime_error("unexpected end of the PLY file!");
+			out_points.resize(n);
+			out_normals.resize(_has_normals ? n : 0);
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < n; ++i)
+			{
+				const char* base = _buffer.data() + (size_t)i * _stride;
+				out_points[i] = Eigen::Vector3d(ply_value_(base + _offsets[0], _types[0]),
+				                                ply_value_(base + _offsets[1], _types[1]),
+				                                ply_value_(base + _offsets[2], _types[2]));
+				if (_has_normals)
+					out_normals[i] = Eigen::Vector3d(ply_value_(base + _offsets[3], _types[3]),
+					                                 ply_value_(base + _offsets[4], _types[4]),
+					                                 ply_value_(base + _offsets[5], _types[5]));
+			}
+			_num_read += n;
+			return n;
+		}
+		// ascii: parse every complete line of the next chunk, keep the broken last line
+		while (true)
+		{
+			const size_t rest = _rest.size();
+			_buffer.resize(rest + _chunk_bytes + 1);
+			memcpy(_buffer.data(), _rest.data(), rest);
+			_in.read(_buffer.data() + rest, _chunk_bytes);
+			const size_t size = rest + _in.gcount();
+			const bool at_end = _in.gcount() < (std::streamsize)_chunk_bytes;
+			_buffer[size] = '\0';
+			size_t end = size;
+			if (!at_end)
+			{
+				while (end > 0 && _buffer[end - 1] != '\n')
+				{
+					--end;
+				}
+			}
+			if (end == 0 && !at_end)
+			{
+				// a line longer than the chunk
+				_rest.assign(_buffer.data(), size);
+				continue;
+			}
+			_rest.assign(_buffer.data() + end, size - end);
+			int n = parse_ascii_(_buffer.data(), _buffer.data() + end, out_points, out_normals);
+			if (_format == _Format::PLY_ASCII && _num_read + n > _num_points)
+			{
+				n = _num_points - _num_read;
+				out_points.resize(n);
+				out_normals.resize(_has_normals ? n : 0);
+			}
+			_num_read += n;
+			if (at_end)
+				_in.close();
+			if (n > 0 || at_end)
+				return n;
+		}
+	}
+
+	_PointCloud_Writer::_PointCloud_Writer()
+		: _precision(9), _is_ply(false), _with_normals(false), _num_written(0)
+	{
+	}
+	_PointCloud_Writer::_PointCloud_Writer(const std::string& in_file_name, const bool& in_with_normals)
+		: _PointCloud_Writer()
+	{
+		open_(in_file_name, in_with_normals);
+	}
+	_PointCloud_Writer::~_PointCloud_Writer()
+	{
+		close_();
+	}
+	void _PointCloud_Writer::open_(const std::string& in_file_name, const bool& in_with_normals)
+	{
+		close_();
+		_out.open(in_file_name, std::ios::binary);
+		if (_out.fail())
+			throw std::runtime_error("fail to write file: " + in_file_name);
+		_is_ply = lower_extension_(in_file_name) == "ply";
+		_with_normals = in_with_normals;
+		_num_written = 0;
+		if (_is_ply)
+		{
+			if (!is_little_endian_())
+				throw std::runtime_error("binary PLY needs a little-endian host!");
+			_out << "ply\nformat binary_little_endian 1.0\nelement vertex ";
+			_count_pos = _out.tellp();
+			// room for the count, patched in close_()
+			_out << std::string(20, ' ') << "\n";
+			_out << "property double x\nproperty double y\nproperty double z\n";
+			if (_with_normals)
+				_out << "property double nx\nproperty double ny\nproperty double nz\n";
+			_out << "end_header\n";
+		}
+	}
+	void _PointCloud_Writer::write_(const std::vector<Eigen::Vector3d>& in_points,
+	                                const std::vector<Eigen::Vector3d>& in_normals)
+	{
+		if (!_out.is_open())
+			throw std::runtime_error("the writer is not open!");
+		if (_with_normals && in_normals.size() != in_points.size())
+			throw std::runtime_error("sizes of points and normals don't match!");
+		const int num = in_points.size();
+		if (_is_ply)
+		{
+			const int dim = _with_normals ? 6 : 3;
+			std::vector<double> buffer((size_t)num * dim);
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < num; ++i)
+			{
+				double* v = buffer.data() + (size_t)i * dim;
+				v[0] = in_points[i].x();
+				v[1] = in_points[i].y();
+				v[2] = in_points[i].z();
+				if (_with_normals)
+				{
+					v[3] = in_normals[i].x();
+					v[4] = in_normals[i].y();
+					v[5] = in_normals[i].z();
+				}
+			}
+			_out.write((const char*)buffer.data(), buffer.size() * sizeof(double));
+		}
+		else
+		{
+			const int B = 4096;
+			const int nblocks = (num + B - 1) / B;
+			std::vector<std::string> text(nblocks);
+#pragma omp parallel for schedule(dynamic, 1)
+			for (int blk = 0; blk < nblocks; ++blk)
+			{
+				// %f of a large coordinate can outgrow any fixed line, the buffer grows to fit
+				std::vector<char> line(256);
+				const auto print = [&](int i)
+				{
+					if (_with_normals)
+						return snprintf(line.data(), line.size(), "%.*f %.*f %.*f %.*f %.*f %.*f\n",
+						                _precision, in_points[i].x(), _precision, in_points[i].y(), _precision, in_points[i].z(),
+						                _precision, in_normals[i].x(), _precision, in_normals[i].y(), _precision, in_normals[i].z());
+					return snprintf(line.data(), line.size(), "%.*f %.*f %.*f\n",
+					                _precision, in_points[i].x(), _precision, in_points[i].y(), _precision, in_points[i].z());
+				};
+				const int end = std::min(num, (blk + 1) * B);
+				text[blk].reserve((size_t)(end - blk * B) * (_with_normals ? 80 : 40));
+				for (int i = blk * B; i < end; ++i)
+				{
+					int len = print(i);
+					if (len >= (int)line.size())
+					{
+						line.resize(len + 1);
+						len = print(i);
+					}
+					text[blk].append(line.data(), len);
+				}
+			}
+			for (int blk = 0; blk < nblocks; ++blk)
+			{
+				_out.write(text[blk].data(), text[blk].size());
+			}
+		}
+		_num_written += num;
+	}
+	void _PointCloud_Writer::close_()
+	{
+		if (!_out.is_open())
+			return;
+		if (_is_ply)
+		{
+			_out.seekp(_count_pos);
+			_out << std::to_string(_num_written);
+		}
+		_out.close();
+	}
+
+	void _PointCloud_IO::read_(const std::string& in_file_name,
+	                           std::vector<Eigen::Vector3d>& out_points, std::vector<Eigen::Vector3d>& out_normals)
+	{
+		_PointCloud_Reader reader(in_file_name);
+		out_points.clear();
+		out_normals.clear();
+		if (reader.number_points_() > 0)
+		{
+			out_points.reserve(reader.number_points_());
+			if (reader.has_normals_())
+				out_normals.reserve(reader.number_points_());
+		}
+		std::vector<Eigen::Vector3d> points, normals;
+		while (reader.read_(points, normals) > 0)
+		{
+			out_points.insert(out_points.end(), points.begin(), points.end());
+			out_normals.insert(out_normals.end(), normals.begin(), normals.end());
+		}
+	}
+	void _PointCloud_IO::write_(const std::string& in_file_name,
+	                            const std::vector<Eigen::Vector3d>& in_points, const std::vector<Eigen::Vector3d>& in_normals)
+	{
+		_PointCloud_Writer writer(in_file_name, !in_normals.empty());
+		writer.write_(in_points, in_normals);
+		writer.close_();
+	}
+} // namespace BGAL
@@ -0,0 +1,220 @@
+#include "BGAL/PointCloudProcessing/Neighborhood/Neighborhood.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <omp.h>
+
+namespace BGAL
+{
+	// interleaves the low 21 bits of v with two zero bits
+	static unsigned long long spread_bits_(unsigned long long v)
+	{
+		v &= 0x1fffffULL;
+		v = (v | v << 32) & 0x1f00000000ffffULL;
+		v = (v | v << 16) & 0x1f0000ff0000ffULL;
+		v = (v | v << 8) & 0x100f00f00f00f00fULL;
+		v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+		v = (v | v << 2) & 0x1249249249249249ULL;
+		return v;
+	}
+	_Neighborhood::_Parameter::_Parameter()
+	{
+		k = 16;
+		radius = 0;
+		max_k = -1;
+		include_self = true;
+		block_size = 1024;
+	}
+	_Neighborhood::_Neighborhood()
+		: _min_k(0), _max_k(0), _mean_k(0), _max_radius(0), _mean_radius(0)
+	{
+	}
+	_Neighborhood::_Neighborhood(const _Parameter& in_parameter)
+		: _parameter(in_parameter), _min_k(0), _max_k(0), _mean_k(0), _max_radius(0), _mean_radius(0)
+	{
+	}
+	void _Neighborhood::build_(const std::vector<_Point3>& in_points)
+	{
+		_KDTree tree(in_points);
+		build_(tree, in_points);
+	}
+	void _Neighborhood::build_(const std::vector<Eigen::Vector3d>& in_points)
+	{
+		std::vector<_Point3> pts;
+		pts.reserve(in_points.size());
+		for (const auto& p : in_points)
+		{
+			pts.push_back(_Point3(p.x(), p.y(), p.z()));
+		}
+		build_(pts);
+	}
+	void _Neighborhood::build_(const _KDTree& in_tree, const std::vector<_Point3>& in_points)
+	{
+		const int num = in_points.size();
+		if (in_tree.number_points_() != num)
+			throw std::runtime_error("the tree doesn't match the points!");
+		_offsets.assign(num + 1, 0);
+		_indices.clear();
+		_radii.assign(num, 0);
+		_min_k = _max_k = 0;
+		_mean_k = _max_radius = _mean_radius = 0;
+		if (num == 0)
+			return;
+		const int B = std::max(_parameter.block_size, 1);
+		const int nblocks = (num + B - 1) / B;
+		const int kq = std::min(std::max(_parameter.k, 0) + (_parameter.include_self ? 0 : 1), num);
+		double radius = _parameter.radius;
+		// queries are issued in Morton order so that consecutive searches walk the same
+		// part of the tree; without it the search is dominated by cache misses
+		std::vector<int> order(num);
+		{
+			double lo[3], hi[3];
+			for (int d = 0; d < 3; ++d)
+			{
+				lo[d] = hi[d] = in_points[0][d];
+			}
+			for (int i = 1; i < num; ++i)
+			{
+				for (int d = 0; d < 3; ++d)
+				{
+					lo[d] = std::min(lo[d], in_points[i][d]);
+					hi[d] = std::max(hi[d], in_points[i][d]);
+				}
+			}
+			const double extent = std::max(std::max(hi[0] - lo[0], hi[1] - lo[1]), hi[2] - lo[2]);
+			const double scale = extent > 0 ? 2097151.0 / extent : 0;
+			std::vector<std::pair<unsigned long long, int>> codes(num);
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < num; ++i)
+			{
+				unsigned long long code = 0;
+				for (int d = 0; d < 3; ++d)
+				{
+					code |= spread_bits_((unsigned long long)((in_points[i][d] - lo[d]) * scale)) << d;
+				}
+				codes[i] = std::make_pair(code, i);
+			}
+			std::sort(codes.begin(), codes.end());
+			for (int i = 0; i < num; ++i)
+			{
+				order[i] = codes[i].second;
+			}
+		}
+		// with a radius rule the k-NN searches run first and are kept, the rule needs the
+		// distances of all points before any neighbourhood can be cut
+		std::vector<int> knn_ids;
+		std::vector<double> knn_r2;
+		if (_parameter.radius_rule)
+		{
+			knn_ids.resize((size_t)num * kq);
+			knn_r2.resize(num);
+#pragma omp parallel
+			{
+				std::vector<int> ids;
+				std::vector<double> sqdists;
+#pragma omp for schedule(dynamic, 1)
+				for (int blk = 0; blk < nblocks; ++blk)
+				{
+					const int end = std::min(num, (blk + 1) * B);
+					for (int t = blk * B; t < end; ++t)
+					{
+						const int i = order[t];
+						in_tree.knn_search_(in_points[i], kq, ids, sqdists);
+						std::copy(ids.begin(), ids.end(), knn_ids.begin() + (size_t)i * kq);
+						knn_r2[i] = sqdists.empty() ? 0 : sqdists.back();
+						_radii[i] = sqrt(knn_r2[i]);
+					}
+				}
+			}
+			radius = _parameter.radius_rule(_radii);
+		}
+		const double radius2 = radius > 0 ? radius * radius : 0;
+		// every block collects the neighbours of its points into its own buffer; the
+		// buffers are scattered behind a prefix sum, so the cloud is searched only once
+		std::vector<std::vector<int>> block_indices(nblocks);
+		std::vector<int> block_start(num);
+#pragma omp parallel
+		{
+			std::vector<int> ids;
+			std::vector<double> sqdists;
+			std::vector<std::pair<double, int>> sorted;
+#pragma omp for schedule(dynamic, 1)
+			for (int blk = 0; blk < nblocks; ++blk)
+			{
+				std::vector<int>& out = block_indices[blk];
+				const int end = std::min(num, (blk + 1) * B);
+				for (int t = blk * B; t < end; ++t)
+				{
+					const int i = order[t];
+					double r2;
+					if (_parameter.radius_rule)
+					{
+						ids.assign(knn_ids.begin() + (size_t)i * kq, knn_ids.begin() + (size_t)(i + 1) * kq);
+						r2 = knn_r2[i];
+					}
+					else
+					{
+						in_tree.knn_search_(in_points[i], kq, ids, sqdists);
+						r2 = sqdists.empty() ? 0 : sqdists.back();
+					}
+					if (radius2 > r2)
+					{
+						r2 = radius2;
+						in_tree.radius_search_(in_points[i], radius, ids, sqdists);
+						sorted.resize(ids.size());
+						for (int j = 0; j < (int)ids.size(); ++j)
+						{
+							sorted[j] = std::make_pair(sqdists[j], ids[j]);
+						}
+						std::sort(sorted.begin(), sorted.end());
+						for (int j = 0; j < (int)ids.size(); ++j)
+						{
+							ids[j] = sorted[j].second;
+						}
+					}
+					block_start[i] = out.size();
+					int cnt = 0;
+					for (int j = 0; j < (int)ids.size(); ++j)
+					{
+						if (_parameter.max_k > 0 && cnt >= _parameter.max_k)
+							break;
+						if (!_parameter.include_self && ids[j] == i)
+							continue;
+						out.push_back(ids[j]);
+						++cnt;
+					}
+					_offsets[i + 1] = cnt;
+					_radii[i] = sqrt(r2);
+				}
+			}
+		}
+		for (int i = 0; i < num; ++i)
+		{
+			_offsets[i + 1] += _offsets[i];
+		}
+		_indices.resize(_offsets[num]);
+#pragma omp parallel for schedule(dynamic, 1)
+		for (int blk = 0; blk < nblocks; ++blk)
+		{
+			const std::vector<int>& out = block_indices[blk];
+			const int end = std::min(num, (blk + 1) * B);
+			for (int t = blk * B; t < end; ++t)
+			{
+				const int i = order[t];
+				std::copy(out.begin() + block_start[i], out.begin() + block_start[i] + (_offsets[i + 1] - _offsets[i]),
+				          _indices.begin() + _offsets[i]);
+			}
+		}
+		_min_k = _offsets[1] - _offsets[0];
+		for (int i = 0; i < num; ++i)
+		{
+			const int k = _offsets[i + 1] - _offsets[i];
+			_min_k = std::min(_min_k, k);
+			_max_k = std::max(_max_k, k);
+			_max_radius = std::max(_max_radius, _radii[i]);
+			_mean_radius += _radii[i];
+		}
+		_mean_k = (double)_offsets[num] / num;
+		_mean_radius /= num;
+	}
+} // namespace BGAL
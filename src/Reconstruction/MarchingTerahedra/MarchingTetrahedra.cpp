@@ -1,15 +1,190 @@
 #include "BGAL/Reconstruction/MarchingTetrahedra/MarchingTetrahedra.h"
+#include <array>
 #include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <omp.h>
 namespace BGAL
 {
   _Marching_Tetrahedra::_Marching_Tetrahedra()
-      : _depth(1), _method(0)
+      : _depth(1), _method(0), _num_evaluations(0)
   {
   }
+  // the uniform lattice is built by the first reconstruction_, the adaptive one doesn't need it
   _Marching_Tetrahedra::_Marching_Tetrahedra(const std::pair<_Point3, _Point3> &in_boundingbox, const int &in_depth)
-      : _boundingbox(in_boundingbox), _depth(in_depth), _method(0)
+      : _boundingbox(in_boundingbox), _depth(in_depth), _method(0), _num_evaluations(0)
   {
-    tiling_();
+  }
+  void _Marching_Tetrahedra::adaptive_tiling_(const std::function<double(const _Point3 &)> &field,
+                                              const double &in_band,
+                                              std::vector<_Point3> &out_vertices,
+                                              std::vector<std::tuple<int, int, int, int>> &out_tetras,
+                                              std::vector<double> &out_values)
+  {
+    if (_depth < 1 || _depth > 20)
+      throw std::runtime_error("depth must be in [1, 20]");
+    // cube around the bounding box, with the same margin as the uniform lattice
+    const _Point3 &lo = _boundingbox.first;
+    const _Point3 &hi = _boundingbox.second;
+    const double size = 1.1 * std::max(std::max(hi.x() - lo.x(), hi.y() - lo.y()), hi.z() - lo.z());
+    const _Point3 origin = (lo + hi) * 0.5 - _Point3(size, size, size) * 0.5;
+    const int n = 1 << _depth;
+    const double step = size / n;
+    const long long stride = n + 1;
+    // lattice points are keyed by their integer coordinates at the finest level
+    std::unordered_map<long long, int> ids;
+    out_vertices.clear();
+    out_values.clear();
+    auto corner_ = [&](const int &x, const int &y, const int &z)
+    {
+      const long long key = (x * stride + y) * stride + z;
+      auto it = ids.find(key);
+      if (it != ids.end())
+        return it->second;
+      const int id = out_vertices.size();
+      ids[key] = id;
+      out_vertices.push_back(origin + _Point3(x * step, y * step, z * step));
+      return id;
+    };
+    auto evaluate_ = [&]()
+    {
+      const int first = out_values.size();
+      const int last = out_vertices.size();
+      out_values.resize(last);
+#pragma omp parallel for schedule(dynamic, 64)
+      for (int i = first; i < last; ++i)
+      {
+        out_values[i] = field(out_vertices[i]);
+      }
+    };
+    // corners of a cube of side s in finest units, bit k of the index is the offset along axis k
+    auto corners_ = [&](const std::array<int, 3> &c, const int &s, std::array<int, 8> &ids8)
+    {
+      for (int k = 0; k < 8; ++k)
+      {
+        ids8[k] = corner_(c[0] + (k & 1) * s, c[1] + ((k >> 1) & 1) * s, c[2] + ((k >> 2) & 1) * s);
+      }
+    };
+    auto sign_change_ = [&](const std::array<int, 8> &ids8)
+    {
+      const bool neg = out_values[ids8[0]] < 0;
+      for (int k = 1; k < 8; ++k)
+      {
+        if ((out_values[ids8[k]] < 0) != neg)
+          return true;
+      }
+      return false;
+    };
+
+    // coarse to fine, every level evaluates all its new corners in one parallel batch
+    int level = std::min(_depth, 2);
+    std::vector<std::array<int, 3>> cells;
+    const int s0 = n >> level;
+    for (int i = 0; i < (1 << level); ++i)
+      for (int j = 0; j < (1 << level); ++j)
+        for (int k = 0; k < (1 << level); ++k)
+          cells.push_back({i * s0, j * s0, k * s0});
+    std::vector<std::array<int, 8>> cell_corners;
+    while (1)
+    {
+      const int s = n >> level;
+      cell_corners.resize(cells.size());
+      for (int c = 0; c < cells.size(); ++c)
+      {
+        corners_(cells[c], s, cell_corners[c]);
+      }
+      evaluate_();
+      if (level == _depth)
+        break;
+      const double threshold = in_band * s * step * sqrt(3.0);
+      std::vector<std::array<int, 3>> children;
+      for (int c = 0; c < cells.size(); ++c)
+      {
+        bool refine = sign_change_(cell_corners[c]);
+        for (int k = 0; k < 8 && !refine; ++k)
+        {
+          refine = fabs(out_values[cell_corners[c][k]]) < threshold;
+        }
+        if (!refine)
+          continue;
+        const int h = s / 2;
+        for (int k = 0; k < 8; ++k)
+        {
+          children.push_back({cells[c][0] + (k & 1) * h, cells[c][1] + ((k >> 1) & 1) * h, cells[c][2] + ((k >> 2) & 1) * h});
+        }
+      }
+      cells.swap(children);
+      ++level;
+    }
+
+    // keep the finest cubes the surface crosses, and close the band: a sign change on a
+    // face means the surface goes on into the neighbouring cube
+    std::vector<std::array<int, 3>> active;
+    std::vector<std::array<int, 8>> active_corners;
+    std::unordered_set<long long> visited;
+    auto cell_key_ = [&](const std::array<int, 3> &c)
+    {
+      return ((long long)c[0] * n + c[1]) * n + c[2];
+    };
+    for (int c = 0; c < cells.size(); ++c)
+    {
+      visited.insert(cell_key_(cells[c]));
+    }
+    std::vector<std::array<int, 3>> wave = cells;
+    std::vector<std::array<int, 8>> wave_corners = cell_corners;
+    // the four corners of face f, f / 2 is the normal axis and f % 2 the side
+    static const int face_corners[6][4] = {{0, 2, 4, 6}, {1, 3, 5, 7}, {0, 1, 4, 5}, {2, 3, 6, 7}, {0, 1, 2, 3}, {4, 5, 6, 7}};
+    while (!wave.empty())
+    {
+      std::vector<std::array<int, 3>> next;
+      for (int c = 0; c < wave.size(); ++c)
+      {
+        if (!sign_change_(wave_corners[c]))
+          continue;
+        active.push_back(wave[c]);
+        active_corners.push_back(wave_corners[c]);
+        for (int f = 0; f < 6; ++f)
+        {
+          const bool neg = out_values[wave_corners[c][face_corners[f][0]]] < 0;
+          bool change = false;
+          for (int k = 1; k < 4; ++k)
+          {
+            change = change || (out_values[wave_corners[c][face_corners[f][k]]] < 0) != neg;
+          }
+          std::array<int, 3> nc = wave[c];
+          nc[f / 2] += (f % 2) ? 1 : -1;
+          if (!change || nc[f / 2] < 0 || nc[f / 2] >= n)
+            continue;
+          if (visited.insert(cell_key_(nc)).second)
+            next.push_back(nc);
+        }
+      }
+      wave.swap(next);
+      wave_corners.resize(wave.size());
+      for (int c = 0; c < wave.size(); ++c)
+      {
+        corners_(wave[c], 1, wave_corners[c]);
+      }
+      evaluate_();
+    }
+    _num_evaluations = out_values.size();
+
+    // six tetrahedra around the diagonal from corner 0 to corner 7, one per axis order
+    static const int paths[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    out_tetras.clear();
+    for (int c = 0; c < active.size(); ++c)
+    {
+      for (int t = 0; t < 6; ++t)
+      {
+        const int a = 1 << paths[t][0];
+        const int b = a | (1 << paths[t][1]);
+        // odd axis orders are mirrored, swap two vertices to keep one orientation
+        if (t == 1 || t == 2 || t == 5)
+          out_tetras.push_back(std::make_tuple(active_corners[c][0], active_corners[c][b], active_corners[c][a], active_corners[c][7]));
+        else
+          out_tetras.push_back(std::make_tuple(active_corners[c][0], active_corners[c][a], active_corners[c][b], active_corners[c][7]));
+      }
+    }
   }
   void _Marching_Tetrahedra::tiling_()
   {
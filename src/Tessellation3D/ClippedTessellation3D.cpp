@@ -0,0 +1,482 @@
+#include "BGAL/Tessellation3D/ClippedTessellation3D.h"
+#include "BGAL/Algorithm/Profiler/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <omp.h>
+#include <Eigen/Dense>
+
+namespace BGAL
+{
+  // convex polyhedron being clipped; every face is a loop of vertex ids and remembers
+  // the neighbouring site whose bisector created it, -1 for faces of the domain tetrahedron
+  struct _Convex_Piece
+  {
+    std::vector<Eigen::Vector3d> v;
+    std::vector<std::vector<int>> faces;
+    std::vector<int> planes;
+    // scratch buffers of clip_piece_
+    std::vector<double> side;
+    std::vector<int> new_id;
+    std::vector<Eigen::Vector3d> nv;
+    std::vector<std::vector<int>> nfaces;
+    std::vector<int> nplanes;
+    std::vector<std::pair<std::pair<int, int>, int>> cuts;
+    void tetrahedron_(const Eigen::Vector3d &a, const Eigen::Vector3d &b, const Eigen::Vector3d &c, const Eigen::Vector3d &d)
+    {
+      v.assign({a, b, c, d});
+      faces.assign({{0, 1, 2}, {0, 1, 3}, {0, 2, 3}, {1, 2, 3}});
+      planes.assign(4, -1);
+    }
+  };
+  static double oriented_volume_(const Eigen::Vector3d &a, const Eigen::Vector3d &b, const Eigen::Vector3d &c,
+                               const Eigen::Vector3d &d)
+  {
+    return (b - a).cross(c - a).dot(d - a) / 6.0;
+  }
+  // Keeps the part with n.x <= c. Returns false if nothing is left.
+  static bool clip_piece_(_Convex_Piece &io_piece, const Eigen::Vector3d &n, const double &c, const int &plane)
+  {
+    const int nv = io_piece.v.size();
+    std::vector<double> &side = io_piece.side;
+    side.resize(nv);
+    bool any_in = false, any_out = false;
+    for (int i = 0; i < nv; ++i)
+    {
+      side[i] = n.dot(io_piece.v[i]) - c;
+      if (side[i] > 0)
+        any_out = true;
+      else
+        any_in = true;
+    }
+    if (!any_out)
+      return true;
+    if (!any_in)
+    {
+      io_piece.v.clear();
+      io_piece.faces.clear();
+      io_piece.planes.clear();
+      return false;
+    }
+    // kept vertices keep their order, every cut edge gets one new vertex
+    std::vector<int> &new_id = io_piece.new_id;
+    std::vector<Eigen::Vector3d> &nvs = io_piece.nv;
+    std::vector<std::pair<std::pair<int, int>, int>> &cuts = io_piece.cuts;
+    new_id.assign(nv, -1);
+    nvs.clear();
+    cuts.clear();
+    for (int i = 0; i < nv; ++i)
+    {
+      if (side[i] <= 0)
+      {
+        new_id[i] = nvs.size();
+        nvs.push_back(io_piece.v[i]);
+      }
+    }
+    std::vector<std::vector<int>> &nfaces = io_piece.nfaces;
+    std::vector<int> &nplanes = io_piece.nplanes;
+    int num_faces = 0;
+    nplanes.clear();
+    for (int f = 0; f < io_piece.faces.size(); ++f)
+    {
+      const std::vector<int> &face = io_piece.faces[f];
+      if (nfaces.size() <= num_faces)
+        nfaces.resize(num_faces + 1);
+      std::vector<int> &nface = nfaces[num_faces];
+      nface.clear();
+      for (int k = 0; k < face.size(); ++k)
+      {
+        const int a = face[k];
+        const int b = face[(k + 1) % face.size()];
+        if (side[a] <= 0)
+          nface.push_back(new_id[a]);
+        if ((side[a] <= 0) != (side[b] <= 0))
+        {
+          // a convex piece has only a handful of cut edges
+          const std::pair<int, int> key(std::min(a, b), std::max(a, b));
+          int id = -1;
+          for (int e = 0; e < cuts.size(); ++e)
+          {
+            if (cuts[e].first == key)
+            {
+              id = cuts[e].second;
+              break;
+            }
+          }
+          if (id < 0)
+          {
+            const double t = side[key.first] / (side[key.first] - side[key.second]);
+            id = nvs.size();
+            nvs.push_back(io_piece.v[key.first] + t * (io_piece.v[key.second] - io_piece.v[key.first]));
+            cuts.push_back(std::make_pair(key, id));
+          }
+          nface.push_back(id);
+        }
+      }
+      if (nface.size() >= 3)
+      {
+        nplanes.push_back(io_piece.planes[f]);
+        ++num_faces;
+      }
+    }
+    if (cuts.size() >= 3)
+    {
+      // the new face: cut vertices sorted by angle around their center in the plane
+      Eigen::Vector3d center(0, 0, 0);
+      for (int e = 0; e < cuts.size(); ++e)
+      {
+        center += nvs[cuts[e].second];
+      }
+      center /= cuts.size();
+      const Eigen::Vector3d u = fabs(n.x()) < fabs(n.y()) ? n.cross(Eigen::Vector3d(1, 0, 0)) : n.cross(Eigen::Vector3d(0, 1, 0));
+      const Eigen::Vector3d w = n.cross(u);
+      std::vector<std::pair<double, int>> angles(cuts.size());
+      for (int e = 0; e < cuts.size(); ++e)
+      {
+        const Eigen::Vector3d d = nvs[cuts[e].second] - center;
+        angles[e] = std::make_pair(atan2(d.dot(w), d.dot(u)), cuts[e].second);
+      }
+      std::sort(angles.begin(), angles.end());
+      if (nfaces.size() <= num_faces)
+        nfaces.resize(num_faces + 1);
+      nfaces[num_faces].clear();
+      for (int e = 0; e < angles.size(); ++e)
+      {
+        nfaces[num_faces].push_back(angles[e].second);
+      }
+      nplanes.push_back(plane);
+      ++num_faces;
+    }
+    io_piece.v.swap(nvs);
+    io_piece.faces.resize(num_faces);
+    for (int f = 0; f < num_faces; ++f)
+    {
+      io_piece.faces[f].swap(nfaces[f]);
+    }
+    io_piece.planes.swap(nplanes);
+    return num_faces > 0;
+  }
+  // Fans the piece from the center of its vertices into tetrahedra with the sign of
+  // in_sign, appended to io_vertices/io_tets, and returns the volume times in_sign. The
+  // signed area of every face created by a bisector is added to io_facets.
+  static double tetrahedralize_piece_(const _Convex_Piece &in_piece,
+                                      const double &in_sign,
+                                      std::vector<Eigen::Vector3d> &io_vertices,
+                                      std::vector<std::tuple<int, int, int, int>> &io_tets,
+                                      std::vector<std::pair<int, double>> &io_facets)
+  {
+    const int base = io_vertices.size();
+    Eigen::Vector3d center(0, 0, 0);
+    for (int i = 0; i < in_piece.v.size(); ++i)
+    {
+      center += in_piece.v[i];
+      io_vertices.push_back(in_piece.v[i]);
+    }
+    center /= in_piece.v.size();
+    const int ic = io_vertices.size();
+    io_vertices.push_back(center);
+    double volume = 0;
+    for (int f = 0; f < in_piece.faces.size(); ++f)
+    {
+      const std::vector<int> &face = in_piece.faces[f];
+      double area = 0;
+      for (int k = 1; k + 1 < face.size(); ++k)
+      {
+        int a = face[0], b = face[k], c = face[k + 1];
+        const Eigen::Vector3d &pa = in_piece.v[a];
+        area += (in_piece.v[b] - pa).cross(in_piece.v[c] - pa).norm() * 0.5;
+        double vol = oriented_volume_(center, pa, in_piece.v[b], in_piece.v[c]);
+        if (vol * in_sign < 0)
+        {
+          std::swap(b, c);
+          vol = -vol;
+        }
+        volume += fabs(vol);
+        io_tets.push_back(std::make_tuple(ic, base + a, base + b, base + c));
+      }
+      if (in_piece.planes[f] >= 0)
+        io_facets.push_back(std::make_pair(in_piece.planes[f], area * in_sign));
+    }
+    return volume * in_sign;
+  }
+  _Clipped_Tessellation3D::_Clipped_Tessellation3D(const _ManifoldModel &in_model)
+      : _domain_volume(0), _num_sites(0)
+  {
+    std::pair<_Point3, _Point3> bbox = in_model.bounding_box_();
+    _domain_vertices.resize(in_model.number_vertices_() + 1);
+    for (int i = 0; i < in_model.number_vertices_(); ++i)
+    {
+      _domain_vertices[i] = in_model.vertex_(i);
+    }
+    const int apex = in_model.number_vertices_();
+    _domain_vertices[apex] = (bbox.first + bbox.second) * 0.5;
+    for (int f = 0; f < in_model.number_faces_(); ++f)
+    {
+      const _Model::_MFace &face = in_model.face_(f);
+      std::array<int, 4> tet = {apex, face[0], face[1], face[2]};
+      _domain_tets.push_back(tet);
+      _domain_volume += signed_volume_(_domain_vertices[tet[0]], _domain_vertices[tet[1]],
+                                       _domain_vertices[tet[2]], _domain_vertices[tet[3]]);
+    }
+    // faces oriented inwards
+    if (_domain_volume < 0)
+    {
+      for (int t = 0; t < _domain_tets.size(); ++t)
+      {
+        std::swap(_domain_tets[t][2], _domain_tets[t][3]);
+      }
+      _domain_volume = -_domain_volume;
+    }
+  }
+  _Clipped_Tessellation3D::_Clipped_Tessellation3D(const std::vector<_Point3> &in_vertices,
+                                                   const std::vector<std::array<int, 4>> &in_tets)
+      : _domain_vertices(in_vertices), _domain_tets(in_tets), _domain_volume(0), _num_sites(0)
+  {
+    for (int t = 0; t < _domain_tets.size(); ++t)
+    {
+      for (int k = 0; k < 4; ++k)
+      {
+        if (_domain_tets[t][k] < 0 || _domain_tets[t][k] >= _domain_vertices.size())
+          throw std::runtime_error("Beyond the index!");
+      }
+      _domain_volume += signed_volume_(_domain_vertices[_domain_tets[t][0]], _domain_vertices[_domain_tets[t][1]],
+                                       _domain_vertices[_domain_tets[t][2]], _domain_vertices[_domain_tets[t][3]]);
+    }
+  }
+  std::pair<_Point3, _Point3> _Clipped_Tessellation3D::domain_bounding_box_() const
+  {
+    if (_domain_vertices.empty())
+      return std::make_pair(_Point3(0, 0, 0), _Point3(0, 0, 0));
+    _Point3 lo = _domain_vertices[0], hi = _domain_vertices[0];
+    for (int i = 1; i < _domain_vertices.size(); ++i)
+    {
+      const _Point3 &p = _domain_vertices[i];
+      lo = _Point3(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z()));
+      hi = _Point3(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z()));
+    }
+    return std::make_pair(lo, hi);
+  }
+  bool _Clipped_Tessellation3D::is_inside_(const _Point3 &in_p) const
+  {
+    int count = 0;
+    for (int t = 0; t < _domain_tets.size(); ++t)
+    {
+      const _Point3 &a = _domain_vertices[_domain_tets[t][0]];
+      const _Point3 &b = _domain_vertices[_domain_tets[t][1]];
+      const _Point3 &c = _domain_vertices[_domain_tets[t][2]];
+      const _Point3 &d = _domain_vertices[_domain_tets[t][3]];
+      const double vol = signed_volume_(a, b, c, d);
+      if (vol == 0)
+        continue;
+      // in_p is inside if it is on the same side of all four faces as the tetrahedron
+      if (signed_volume_(in_p, b, c, d) * vol >= 0 && signed_volume_(a, in_p, c, d) * vol >= 0 &&
+          signed_volume_(a, b, in_p, d) * vol >= 0 && signed_volume_(a, b, c, in_p) * vol >= 0)
+        count += vol > 0 ? 1 : -1;
+    }
+    return count > 0;
+  }
+  void _Clipped_Tessellation3D::calculate_()
+  {
+    BGAL_PROFILE_SCOPE("clipped_tessellation");
+    std::vector<std::pair<Weighted_point, int>> wps(_num_sites);
+    double min_weight = _weights.empty() ? 0 : *(std::min_element(_weights.begin(), _weights.end()));
+    for (int i = 0; i < _num_sites; ++i)
+    {
+      wps[i] = std::make_pair(Weighted_point(Point(_sites[i].x(), _sites[i].y(), _sites[i].z()), _weights[i]), i);
+    }
+    // eight far points keep every cell of the domain bounded
+    std::pair<_Point3, _Point3> bbox = domain_bounding_box_();
+    const _Point3 &min_p = bbox.first;
+    const _Point3 &max_p = bbox.second;
+    for (int k = 0; k < 8; ++k)
+    {
+      const double x = (k & 1) ? 3 * max_p.x() - 2 * min_p.x() : 3 * min_p.x() - 2 * max_p.x();
+      const double y = (k & 2) ? 3 * max_p.y() - 2 * min_p.y() : 3 * min_p.y() - 2 * max_p.y();
+      const double z = (k & 4) ? 3 * max_p.z() - 2 * min_p.z() : 3 * min_p.z() - 2 * max_p.z();
+      wps.push_back(std::make_pair(Weighted_point(Point(x, y, z), min_weight), -1));
+    }
+    BGAL_PROFILE_BEGIN(triangulation, "triangulation");
+    Rt rt(wps.begin(), wps.end());
+    BGAL_PROFILE_END(triangulation);
+    BGAL_PROFILE_BEGIN(skeleton, "skeleton");
+    _skeleton = _Tessellation3D_Skeleton(rt, _num_sites);
+    _skeleton.sort_by_distance_(_sites);
+    BGAL_PROFILE_END(skeleton);
+    const double max_weight = _weights.empty() ? 0 : *std::max_element(_weights.begin(), _weights.end());
+
+    const int num_tets = _domain_tets.size();
+    std::vector<Eigen::Vector3d> dv(_domain_vertices.size());
+    for (int i = 0; i < dv.size(); ++i)
+    {
+      dv[i] = Eigen::Vector3d(_domain_vertices[i].x(), _domain_vertices[i].y(), _domain_vertices[i].z());
+    }
+    std::vector<Eigen::Vector3d> sites(_num_sites);
+    std::vector<double> sqlengths(_num_sites);
+    for (int i = 0; i < _num_sites; ++i)
+    {
+      sites[i] = Eigen::Vector3d(_sites[i].x(), _sites[i].y(), _sites[i].z());
+      sqlengths[i] = sites[i].squaredNorm();
+    }
+    std::vector<int> seeds(num_tets, -1);
+    for (int t = 0; t < num_tets; ++t)
+    {
+      const Eigen::Vector3d c = (dv[_domain_tets[t][0]] + dv[_domain_tets[t][1]] + dv[_domain_tets[t][2]] + dv[_domain_tets[t][3]]) / 4;
+      seeds[t] = rt.nearest_power_vertex(Point(c.x(), c.y(), c.z()))->info();
+      // a far point owns the center: start from the site of least power distance to it,
+      // whose cell, clipped by the other sites only, contains it
+      if (seeds[t] < 0)
+      {
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < _num_sites; ++i)
+        {
+          const double power = (c - sites[i]).squaredNorm() - _weights[i];
+          if (power < best)
+          {
+            best = power;
+            seeds[t] = i;
+          }
+        }
+      }
+    }
+
+    BGAL_PROFILE_BEGIN(clipping, "clipping");
+    // every domain tetrahedron floods the cells it overlaps into its own buffers
+    std::vector<std::vector<Eigen::Vector3d>> tet_vertices(num_tets);
+    std::vector<std::vector<std::tuple<int, int, int, int>>> tet_tets(num_tets);
+    std::vector<std::vector<std::pair<int, int>>> tet_cells(num_tets);
+    std::vector<std::vector<std::tuple<int, int, double>>> tet_facets(num_tets);
+#pragma omp parallel
+    {
+      _Convex_Piece piece;
+      std::vector<int> queue;
+      std::vector<char> queued(_num_sites, 0);
+      std::vector<std::pair<int, double>> facets;
+#pragma omp for schedule(dynamic, 16)
+      for (int t = 0; t < num_tets; ++t)
+      {
+        const Eigen::Vector3d &a = dv[_domain_tets[t][0]];
+        const Eigen::Vector3d &b = dv[_domain_tets[t][1]];
+        const Eigen::Vector3d &c = dv[_domain_tets[t][2]];
+        const Eigen::Vector3d &d = dv[_domain_tets[t][3]];
+        const double vol = oriented_volume_(a, b, c, d);
+        // no seed only without sites
+        if (vol == 0 || seeds[t] < 0)
+          continue;
+        const double sign = vol > 0 ? 1 : -1;
+        queue.assign(1, seeds[t]);
+        queued[seeds[t]] = 1;
+        for (int head = 0; head < queue.size(); ++head)
+        {
+          const int i = queue[head];
+          piece.tetrahedron_(a, b, c, d);
+          bool is_empty = false;
+          const _Tessellation3D_Skeleton::_Neighbours planes = _skeleton.neight_(i);
+          for (auto p = planes.begin(); p != planes.end(); ++p)
+          {
+            const int j = *p;
+            // Security radius: the bisector of a neighbour at distance d lies at least
+            // (d^2 + w_i - max_weight) / 2d from s_i, which grows with d. Once that exceeds
+            // the radius of the piece around s_i, no farther neighbour can clip it.
+            const double d = (sites[j] - sites[i]).norm();
+            double radius = 0;
+            for (int k = 0; k < piece.v.size(); ++k)
+            {
+              radius = std::max(radius, (piece.v[k] - sites[i]).squaredNorm());
+            }
+            if (d * d + _weights[i] - max_weight > 2 * d * std::sqrt(radius))
+              break;
+            // power bisector: |x - s_i|^2 - w_i <= |x - s_j|^2 - w_j
+            const Eigen::Vector3d n = 2 * (sites[j] - sites[i]);
+            const double cj = sqlengths[j] - sqlengths[i] - _weights[j] + _weights[i];
+            if (!clip_piece_(piece, n, cj, j))
+            {
+              is_empty = true;
+              break;
+            }
+          }
+          if (is_empty)
+            continue;
+          const int first_tet = tet_tets[t].size();
+          facets.clear();
+          tetrahedralize_piece_(piece, sign, tet_vertices[t], tet_tets[t], facets);
+          tet_cells[t].push_back(std::make_pair(i, (int)tet_tets[t].size() - first_tet));
+          for (int k = 0; k < facets.size(); ++k)
+          {
+            const int j = facets[k].first;
+            tet_facets[t].push_back(std::make_tuple(i, j, facets[k].second));
+            if (!queued[j])
+            {
+              queued[j] = 1;
+              queue.push_back(j);
+            }
+          }
+        }
+        for (int i : queue)
+          queued[i] = 0;
+      }
+    }
+
+    BGAL_PROFILE_END(clipping);
+    BGAL_PROFILE_SCOPE("gather");
+    // gather in the order of the domain tetrahedra, independent of the thread count
+    _vertices.clear();
+    _cells.assign(_num_sites, std::vector<std::tuple<int, int, int, int>>());
+    _volumes.assign(_num_sites, 0);
+    _facets.assign(_num_sites, std::map<int, double>());
+    for (int t = 0; t < num_tets; ++t)
+    {
+      const int base = _vertices.size();
+      for (int k = 0; k < tet_vertices[t].size(); ++k)
+      {
+        const Eigen::Vector3d &p = tet_vertices[t][k];
+        _vertices.push_back(_Point3(p.x(), p.y(), p.z()));
+      }
+      int k = 0;
+      for (int c = 0; c < tet_cells[t].size(); ++c)
+      {
+        const int i = tet_cells[t][c].first;
+        for (int e = 0; e < tet_cells[t][c].second; ++e, ++k)
+        {
+          const std::tuple<int, int, int, int> &tet = tet_tets[t][k];
+          const int p0 = base + std::get<0>(tet), p1 = base + std::get<1>(tet);
+          const int p2 = base + std::get<2>(tet), p3 = base + std::get<3>(tet);
+          _cells[i].push_back(std::make_tuple(p0, p1, p2, p3));
+          _volumes[i] += oriented_volume_(tet_vertices[t][p0 - base], tet_vertices[t][p1 - base],
+                                        tet_vertices[t][p2 - base], tet_vertices[t][p3 - base]);
+        }
+      }
+      for (int f = 0; f < tet_facets[t].size(); ++f)
+      {
+        _facets[std::get<0>(tet_facets[t][f])][std::get<1>(tet_facets[t][f])] += std::get<2>(tet_facets[t][f]);
+      }
+    }
+    // facets of opposite signs cancel outside the volume
+    const double eps = 1e-12 * std::pow(std::max(_domain_volume, 1e-300), 2.0 / 3.0);
+    for (int i = 0; i < _num_sites; ++i)
+    {
+      for (auto it = _facets[i].begin(); it != _facets[i].end();)
+      {
+        if (it->second <= eps)
+          it = _facets[i].erase(it);
+        else
+          ++it;
+      }
+    }
+  }
+  void _Clipped_Tessellation3D::calculate_(const std::vector<_Point3> &in_sites)
+  {
+    _sites = in_sites;
+    _num_sites = _sites.size();
+    _weights.assign(_num_sites, 0);
+    calculate_();
+  }
+  void _Clipped_Tessellation3D::calculate_(const std::vector<_Point3> &in_sites, const std::vector<double> &in_weights)
+  {
+    if (in_weights.size() != in_sites.size())
+      throw std::runtime_error("sizes of the sites and weights don't match!");
+    _sites = in_sites;
+    _num_sites = _sites.size();
+    _weights = in_weights;
+    calculate_();
+  }
+} // namespace BGAL
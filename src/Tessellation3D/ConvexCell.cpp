@@ -0,0 +1,304 @@
+#include "BGAL/Tessellation3D/ConvexCell.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace BGAL
+{
+  namespace
+  {
+    // Exact sums and products of doubles as nonoverlapping expansions ordered by increasing
+    // magnitude (Shewchuk 1997), for the sign of a determinant too close to zero for doubles.
+    void two_sum_(const double &a, const double &b, double &x, double &y)
+    {
+      x = a + b;
+      const double bv = x - a, av = x - bv;
+      y = (a - av) + (b - bv);
+    }
+    void two_product_(const double &a, const double &b, double &x, double &y)
+    {
+      x = a * b;
+      y = std::fma(a, b, -x);
+    }
+    // e += b
+    void grow_expansion_(std::vector<double> &e, const double &b)
+    {
+      std::vector<double> h;
+      h.reserve(e.size() + 1);
+      double q = b, sum, error;
+      for (const double &c : e)
+      {
+        two_sum_(q, c, sum, error);
+        q = sum;
+        if (error != 0)
+          h.push_back(error);
+      }
+      if (q != 0 || h.empty())
+        h.push_back(q);
+      e.swap(h);
+    }
+    // e *= b
+    void scale_expansion_(std::vector<double> &e, const double &b)
+    {
+      std::vector<double> h;
+      h.reserve(2 * e.size());
+      double q, error;
+      two_product_(e[0], b, q, error);
+      if (error != 0)
+        h.push_back(error);
+      for (int i = 1; i < e.size(); ++i)
+      {
+        double product, product_error, sum;
+        two_product_(e[i], b, product, product_error);
+        two_sum_(q, product_error, sum, error);
+        if (error != 0)
+          h.push_back(error);
+        two_sum_(product, sum, q, error);
+        if (error != 0)
+          h.push_back(error);
+      }
+      if (q != 0 || h.empty())
+        h.push_back(q);
+      e.swap(h);
+    }
+    // sign of the determinant of the rows p, q, r, s, filtered by a bound on the rounding
+    // error and computed exactly when the filter fails
+    int sign_det4_(const Eigen::Vector4d &p, const Eigen::Vector4d &q, const Eigen::Vector4d &r, const Eigen::Vector4d &s)
+    {
+      Eigen::Matrix4d m;
+      m << p.transpose(), q.transpose(), r.transpose(), s.transpose();
+      // Laplace expansion by the 2x2 minors of the first two and last two rows
+      static const int pairs[6][2] = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+      double det = 0, permanent = 0;
+      for (int k = 0; k < 6; ++k)
+      {
+        const int a = pairs[k][0], b = pairs[k][1], c = pairs[5 - k][0], d = pairs[5 - k][1];
+        const double sign = (k == 1 || k == 4) ? -1 : 1;
+        det += sign * (m(0, a) * m(1, b) - m(0, b) * m(1, a)) * (m(2, c) * m(3, d) - m(2, d) * m(3, c));
+        permanent += (fabs(m(0, a) * m(1, b)) + fabs(m(0, b) * m(1, a))) * (fabs(m(2, c) * m(3, d)) + fabs(m(2, d) * m(3, c)));
+      }
+      const double bound = 1e-14 * permanent;
+      if (det > bound)
+        return 1;
+      if (det < -bound)
+        return -1;
+      if (permanent == 0)
+        return 0;
+      std::vector<double> sum(1, 0.0);
+      int permutation[4] = {0, 1, 2, 3};
+      do
+      {
+        int inversions = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+          for (int j = i + 1; j < 4; ++j)
+            inversions += permutation[i] > permutation[j];
+        }
+        std::vector<double> term(1, inversions % 2 == 0 ? m(0, permutation[0]) : -m(0, permutation[0]));
+        for (int i = 1; i < 4; ++i)
+          scale_expansion_(term, m(i, permutation[i]));
+        for (const double &c : term)
+          grow_expansion_(sum, c);
+      } while (std::next_permutation(permutation, permutation + 4));
+      return sum.back() > 0 ? 1 : (sum.back() < 0 ? -1 : 0);
+    }
+  } // namespace
+
+  _Convex_Cell::_Convex_Cell()
+  {
+  }
+  _Convex_Cell::_Convex_Cell(const _Point3 &in_min, const _Point3 &in_max)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      Eigen::Vector4d lower = Eigen::Vector4d::Zero(), upper = Eigen::Vector4d::Zero();
+      lower[axis] = -1;
+      lower[3] = in_min[axis];
+      upper[axis] = 1;
+      upper[3] = -in_max[axis];
+      _planes.push_back(lower);
+      _planes.push_back(upper);
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+      std::array<int, 3> t = {i & 1, 2 + ((i >> 1) & 1), 4 + ((i >> 2) & 1)};
+      // the determinant of the normals is the product of their signs
+      if (((i & 1) + ((i >> 1) & 1) + ((i >> 2) & 1)) % 2 == 0)
+        std::swap(t[1], t[2]);
+      _triangles.push_back(t);
+      _vertices.push_back(intersection_(t));
+    }
+  }
+  Eigen::Vector3d _Convex_Cell::intersection_(const std::array<int, 3> &in_triangle) const
+  {
+    const Eigen::Vector4d &p = _planes[in_triangle[0]], &q = _planes[in_triangle[1]], &r = _planes[in_triangle[2]];
+    const Eigen::Vector3d np = p.head<3>(), nq = q.head<3>(), nr = r.head<3>();
+    const Eigen::Vector3d qr = nq.cross(nr);
+    return -(p[3] * qr + q[3] * nr.cross(np) + r[3] * np.cross(nq)) / np.dot(qr);
+  }
+  bool _Convex_Cell::clip_(const Eigen::Vector4d &in_plane)
+  {
+    const int num_triangles = _triangles.size();
+    // The vertex of the planes (p, q, r) is on the positive side of s when det(p, q, r, s) > 0,
+    // as the normals of p, q, r have a positive determinant. The sign is exact, so the copies
+    // of a vertex where more than three planes meet are classified alike and the removed
+    // vertices stay a disc; a vertex on the plane is kept, so a plane touching the cell
+    // without cutting into it is no clip.
+    std::vector<char> conflicts(num_triangles);
+    int num_conflicts = 0;
+    for (int t = 0; t < num_triangles; ++t)
+    {
+      const std::array<int, 3> &tri = _triangles[t];
+      conflicts[t] = sign_det4_(_planes[tri[0]], _planes[tri[1]], _planes[tri[2]], in_plane) > 0;
+      num_conflicts += conflicts[t];
+    }
+    if (num_conflicts == 0)
+      return false;
+    if (num_conflicts == num_triangles)
+    {
+      _triangles.clear();
+      _vertices.clear();
+      return true;
+    }
+    // the removed vertices are a disc of the dual triangulation, its boundary edges are
+    // those whose reverse is not removed
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(3 * num_conflicts);
+    for (int t = 0; t < num_triangles; ++t)
+    {
+      if (conflicts[t])
+      {
+        for (int k = 0; k < 3; ++k)
+          edges.push_back(std::make_pair(_triangles[t][k], _triangles[t][(k + 1) % 3]));
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+    int last = 0;
+    for (int t = 0; t < num_triangles; ++t)
+    {
+      if (!conflicts[t])
+      {
+        _triangles[last] = _triangles[t];
+        _vertices[last++] = _vertices[t];
+      }
+    }
+    _triangles.resize(last);
+    _vertices.resize(last);
+    const int pid = _planes.size();
+    _planes.push_back(in_plane);
+    for (auto &e : edges)
+    {
+      if (!std::binary_search(edges.begin(), edges.end(), std::make_pair(e.second, e.first)))
+      {
+        std::array<int, 3> t = {e.first, e.second, pid};
+        _triangles.push_back(t);
+        _vertices.push_back(intersection_(t));
+      }
+    }
+    return true;
+  }
+  void _Convex_Cell::clip_(const std::vector<Eigen::Vector4d> &in_planes)
+  {
+    for (auto &plane : in_planes)
+    {
+      if (empty_())
+        return;
+      clip_(plane);
+    }
+  }
+  void _Convex_Cell::clip_(std::vector<_Convex_Cell> &cells, const std::vector<std::vector<Eigen::Vector4d>> &in_planes)
+  {
+    if (cells.size() != in_planes.size())
+      throw std::runtime_error("The planes don't match the cells!");
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < cells.size(); ++i)
+      cells[i].clip_(in_planes[i]);
+  }
+  std::vector<std::pair<int, std::vector<int>>> _Convex_Cell::facets_() const
+  {
+    // (p, q, t): the triangle t is (p, q, r) up to rotation. Around the plane p the next
+    // vertex after (p, q, r) is (p, r, s).
+    std::vector<std::tuple<int, int, int>> corners;
+    corners.reserve(3 * _triangles.size());
+    for (int t = 0; t < _triangles.size(); ++t)
+    {
+      for (int k = 0; k < 3; ++k)
+        corners.push_back(std::make_tuple(_triangles[t][k], _triangles[t][(k + 1) % 3], t));
+    }
+    std::sort(corners.begin(), corners.end());
+    std::vector<std::pair<int, std::vector<int>>> facets;
+    for (int begin = 0, end; begin < corners.size(); begin = end)
+    {
+      const int p = std::get<0>(corners[begin]);
+      end = begin;
+      while (end < corners.size() && std::get<0>(corners[end]) == p)
+        ++end;
+      std::vector<int> polygon;
+      int c = begin;
+      do
+      {
+        const int t = std::get<2>(corners[c]);
+        polygon.push_back(t);
+        const std::array<int, 3> &tri = _triangles[t];
+        const int r = tri[0] == p ? tri[2] : (tri[1] == p ? tri[0] : tri[1]);
+        c = std::lower_bound(corners.begin() + begin, corners.begin() + end, std::make_tuple(p, r, -1)) - corners.begin();
+      } while (c != begin && polygon.size() <= end - begin);
+      facets.push_back(std::make_pair(p, polygon));
+    }
+    return facets;
+  }
+  double _Convex_Cell::volume_() const
+  {
+    if (empty_())
+      return 0;
+    double volume = 0;
+    const Eigen::Vector3d &o = _vertices[0];
+    for (auto &facet : facets_())
+    {
+      const std::vector<int> &polygon = facet.second;
+      for (int i = 1; i + 1 < polygon.size(); ++i)
+        volume += (_vertices[polygon[0]] - o).dot((_vertices[polygon[i]] - o).cross(_vertices[polygon[i + 1]] - o));
+    }
+    return volume / 6.0;
+  }
+  _Point3 _Convex_Cell::centroid_() const
+  {
+    if (empty_())
+      throw std::runtime_error("The cell is empty!");
+    double volume = 0;
+    Eigen::Vector3d moment = Eigen::Vector3d::Zero();
+    const Eigen::Vector3d &o = _vertices[0];
+    for (auto &facet : facets_())
+    {
+      const std::vector<int> &polygon = facet.second;
+      for (int i = 1; i + 1 < polygon.size(); ++i)
+      {
+        const Eigen::Vector3d &a = _vertices[polygon[0]], &b = _vertices[polygon[i]], &c = _vertices[polygon[i + 1]];
+        const double v = (a - o).dot((b - o).cross(c - o));
+        volume += v;
+        moment += v * (o + a + b + c) / 4.0;
+      }
+    }
+    moment /= volume;
+    return _Point3(moment.x(), moment.y(), moment.z());
+  }
+  _ManifoldModel _Convex_Cell::model_() const
+  {
+    std::vector<_Point3> vertices;
+    for (int i = 0; i < _vertices.size(); ++i)
+      vertices.push_back(vertex_(i));
+    std::vector<_Model::_MFace> faces;
+    for (auto &facet : facets_())
+    {
+      const std::vector<int> &polygon = facet.second;
+      for (int i = 1; i + 1 < polygon.size(); ++i)
+      {
+        _Model::_MFace face(polygon[0], polygon[i], polygon[i + 1], vertices[polygon[0]], vertices[polygon[i]], vertices[polygon[i + 1]]);
+        face.id = faces.size();
+        faces.push_back(face);
+      }
+    }
+    return _ManifoldModel(vertices, faces);
+  }
+} // namespace BGAL
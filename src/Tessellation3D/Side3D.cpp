@@ -1,7 +1,47 @@
 #include "BGAL/Tessellation3D/Side3D.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
 namespace BGAL
 {
+  // how many queries each level of the filter resolved, counted since the last reset
+  static std::atomic<long long> static_filter_count(0);
+  static std::atomic<long long> interval_filter_count(0);
+  static std::atomic<long long> exact_count(0);
+  static const int fe_flags = FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID;
+
+  static _BOC::_Sign to_sign_(const CGAL::Comparison_result &r)
+  {
+    return (r == CGAL::ZERO ? _BOC::_Sign::ZerO : (r == CGAL::POSITIVE ? _BOC::_Sign::PositivE : _BOC::_Sign::NegativE));
+  }
+
+  // the static filters end in bit arithmetic instead of branches so that a batch of rows
+  // vectorizes: a query is certain when its error bound minus |value| is negative, and the
+  // sign is FaileD (3) unless certain, NegativE (0) or PositivE (2) otherwise
+  static inline unsigned long long sign_bit_(const double x)
+  {
+    unsigned long long bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits >> 63;
+  }
+  static inline _BOC::_Sign filter_sign_(const unsigned long long certain, const unsigned long long negative)
+  {
+    return (_BOC::_Sign)(3 ^ ((1 ^ (negative << 1)) & (0 - certain)));
+  }
+  // the batches run on tiles of rows copied into columns, so that the static filter
+  // reads every argument with unit stride
+  static const int batch_tile = 64;
+  static void to_columns_(const double *in_rows, const int &width, const int &m, double *out_columns)
+  {
+    for (int t = 0; t < m; ++t)
+    {
+      for (int j = 0; j < width; ++j)
+      {
+        out_columns[j * batch_tile + t] = in_rows[t * width + j];
+      }
+    }
+  }
 
   _Side3D::K::Comparison_result _Side3D::mult(K::Comparison_result s1, K::Comparison_result s2)
   {
@@ -57,19 +97,10 @@ namespace BGAL
     double v2z;
     v2z_bound = ((2.00000000000000000000e+00 * qz_bound) + (p1z_bound + p2z_bound));
     v2z = ((2.00000000000000000000e+00 * qz) - (p1z + p2z));
-    _BOC::_Sign int_tmp_result;
-    if (((fabs((((v1x * v2x) + (v1y * v2y)) + (v1z * v2z) + w1 - w2)) > ((((v1x_bound * v2x_bound) + (v1y_bound * v2y_bound)) + (v1z_bound * v2z_bound) + fabs(w1) + fabs(w2)) * 1.33226762955018784851e-15)) && (fetestexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID) == 0)))
-    {
-      int_tmp_result =
-          (((((v1x * v2x) + (v1y * v2y)) + (v1z * v2z) + w1 - w2) < 0.00000000000000000000e+00) ? _BOC::_Sign::NegativE
-                                                                                                : _BOC::_Sign::PositivE);
-    }
-    else
-    {
-      feclearexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID);
-      return _BOC::_Sign::FaileD;
-    }
-    return int_tmp_result;
+    const double result = (((v1x * v2x) + (v1y * v2y)) + (v1z * v2z) + w1 - w2);
+    const double result_bound = (((v1x_bound * v2x_bound) + (v1y_bound * v2y_bound)) + (v1z_bound * v2z_bound) + fabs(w1) + fabs(w2));
+    const unsigned long long certain = sign_bit_(result_bound * 1.33226762955018784851e-15 - fabs(result));
+    return filter_sign_(certain, sign_bit_(result));
   }
 
   template <class RT>
@@ -106,9 +137,11 @@ namespace BGAL
               c2f(qx), c2f(qy), c2f(qz)));
       if (is_certain(res))
       {
+        interval_filter_count.fetch_add(1, std::memory_order_relaxed);
         return get_certain(res);
       }
     }
+    exact_count.fetch_add(1, std::memory_order_relaxed);
     C2E c2e;
     // Exact version (if filtered version failed)
     return sign(
@@ -178,16 +211,7 @@ namespace BGAL
     double denom;
     denom_bound = (((t19_bound * t22_bound) + (t18_bound * t21_bound)) + (t17_bound * t20_bound));
     denom = (((t19 * t22) + (t18 * t21)) + (t17 * t20));
-    _BOC::_Sign int_tmp_result;
-    if (((fabs(denom) > (denom_bound * 1.11022302462515654042e-15)) && (fetestexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID) == 0)))
-    {
-      int_tmp_result = ((denom < 0.00000000000000000000e+00) ? _BOC::_Sign::NegativE : _BOC::_Sign::PositivE);
-    }
-    else
-    {
-      feclearexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID);
-      return _BOC::_Sign::FaileD;
-    }
+    const unsigned long long denom_certain = sign_bit_(denom_bound * 1.11022302462515654042e-15 - fabs(denom));
     double p2x_bound = fabs(p2x);
     double t28_bound;
     double t28;
@@ -219,17 +243,8 @@ namespace BGAL
     double result;
     result_bound = (((((t28_bound * t19_bound) + (t26_bound * t18_bound)) + (t24_bound * t17_bound)) * ((((p3x_bound + t27_bound) * t22_bound) + ((p3y_bound + t25_bound) * t21_bound)) + ((p3z_bound + t23_bound) * t20_bound) + fabs(w1) + fabs(w3))) + ((((t28_bound * (p2x_bound + t27_bound)) + (t26_bound * (p2y_bound + t25_bound))) + (t24_bound * (p2z_bound + t23_bound)) + fabs(w1) + fabs(w2)) * denom_bound));
     result = (((((t28 * t19) + (t26 * t18)) + (t24 * t17)) * ((((p3x + t27) * t22) + ((p3y + t25) * t21)) + ((p3z + t23) * t20) - w1 + w3)) + ((((t28 * (-p2x - t27)) + (t26 * (-p2y - t25))) + (t24 * (-p2z - t23)) + w1 - w2) * denom));
-    _BOC::_Sign int_tmp_result_FFWKCAA;
-    if (((fabs(result) > (result_bound * 3.10862446895043831319e-15)) && (fetestexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID) == 0)))
-    {
-      int_tmp_result_FFWKCAA = ((result < 0.00000000000000000000e+00) ? _BOC::_Sign::NegativE : _BOC::_Sign::PositivE);
-    }
-    else
-    {
-      feclearexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID);
-      return _BOC::_Sign::FaileD;
-    }
-    return (int_tmp_result == int_tmp_result_FFWKCAA) ? _BOC::_Sign::PositivE : _BOC::_Sign::NegativE;
+    const unsigned long long result_certain = sign_bit_(result_bound * 3.10862446895043831319e-15 - fabs(result));
+    return filter_sign_(denom_certain & result_certain, sign_bit_(denom) ^ sign_bit_(result));
   }
 
   template <class RT>
@@ -310,10 +325,12 @@ namespace BGAL
 
       if (is_certain(s1) && is_certain(s2))
       {
+        interval_filter_count.fetch_add(1, std::memory_order_relaxed);
         return mult(get_certain(s1), get_certain(s2));
       }
     }
     // Exact version (if filtered version failed)
+    exact_count.fetch_add(1, std::memory_order_relaxed);
     C2E c2e;
     EK::FT result;
     EK::FT denom;
@@ -393,7 +410,7 @@ namespace BGAL
     t51 = (-p1x + p3x);
     double t54_bound;
     double t54;
-    t54_bound = (((t51_bound * (p1x_bound + p3x_bound)) + (t50_bound * (p1y_bound + p3y_bound))) + (t49_bound * (p1z_bound + p3z_bound))) + fabs(w1) + fabs(w4);
+    t54_bound = (((t51_bound * (p1x_bound + p3x_bound)) + (t50_bound * (p1y_bound + p3y_bound))) + (t49_bound * (p1z_bound + p3z_bound))) + fabs(w1) + fabs(w3);
     t54 = (((t51 * (p1x + p3x)) + (t50 * (p1y + p3y))) + (t49 * (p1z + p3z))) + w1 - w3;
     double q3z_bound = fabs(q3z);
     double q1z_bound = fabs(q1z);
@@ -460,16 +477,7 @@ namespace BGAL
     double denom;
     denom_bound = (((t51_bound * t33_bound) + (t50_bound * t32_bound)) + (t49_bound * t34_bound));
     denom = (((t51 * t33) + (t50 * t32)) + (t49 * t34));
-    _BOC::_Sign int_tmp_result;
-    if (((fabs(denom) > (denom_bound * 2.44249065417534438893e-15)) && (fetestexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID) == 0)))
-    {
-      int_tmp_result = ((denom < 0.00000000000000000000e+00) ? _BOC::_Sign::NegativE : _BOC::_Sign::PositivE);
-    }
-    else
-    {
-      feclearexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID);
-      return _BOC::_Sign::FaileD;
-    }
+    const unsigned long long denom_certain = sign_bit_(denom_bound * 2.44249065417534438893e-15 - fabs(denom));
     double p2x_bound = fabs(p2x);
     double p2y_bound = fabs(p2y);
     double p2z_bound = fabs(p2z);
@@ -477,17 +485,8 @@ namespace BGAL
     double result;
     result_bound = ((((p1x_bound + p2x_bound) * ((((t33_bound * t54_bound) + (((t49_bound * t37_bound) + (t50_bound * t39_bound)) * t55_bound)) + (((t50_bound * t46_bound) + (t49_bound * t47_bound)) * t53_bound)) + (denom_bound * (p1x_bound + p2x_bound)))) + ((p1y_bound + p2y_bound) * ((((t32_bound * t54_bound) + (((t51_bound * t39_bound) + (t49_bound * t38_bound)) * t55_bound)) + (((t49_bound * t48_bound) + (t51_bound * t46_bound)) * t53_bound)) + (denom_bound * (p1y_bound + p2y_bound))))) + ((p1z_bound + p2z_bound) * ((((t34_bound * t54_bound) + (((t50_bound * t38_bound) + (t51_bound * t37_bound)) * t55_bound)) + (((t51_bound * t47_bound) + (t50_bound * t48_bound)) * t53_bound)) + (denom_bound * (p1z_bound + p2z_bound))))) + (fabs(w1) + fabs(w2)) * denom_bound;
     result = ((((p1x - p2x) * ((((t33 * t54) + (((t49 * t37) - (t50 * t39)) * t55)) + (((t50 * t46) - (t49 * t47)) * t53)) - (denom * (p1x + p2x)))) + ((p1y - p2y) * ((((t32 * t54) + (((t51 * t39) - (t49 * t38)) * t55)) + (((t49 * t48) - (t51 * t46)) * t53)) - (denom * (p1y + p2y))))) + ((p1z - p2z) * ((((t34 * t54) + (((t50 * t38) - (t51 * t37)) * t55)) + (((t51 * t47) - (t50 * t48)) * t53)) - (denom * (p1z + p2z))))) + (w1 - w2) * denom;
-    _BOC::_Sign int_tmp_result_FFWKCAA;
-    if (((fabs(result) > (result_bound * 4.44089209850062616169e-15)) && (fetestexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID) == 0)))
-    {
-      int_tmp_result_FFWKCAA = ((result < 0.00000000000000000000e+00) ? _BOC::_Sign::NegativE : _BOC::_Sign::PositivE);
-    }
-    else
-    {
-      feclearexcept(FE_DIVBYZERO | FE_UNDERFLOW | FE_OVERFLOW | FE_INVALID);
-      return _BOC::_Sign::FaileD;
-    }
-    return (int_tmp_result == int_tmp_result_FFWKCAA) ? _BOC::_Sign::PositivE : _BOC::_Sign::NegativE;
+    const unsigned long long result_certain = sign_bit_(result_bound * 4.44089209850062616169e-15 - fabs(result));
+    return filter_sign_(denom_certain & result_certain, sign_bit_(denom) ^ sign_bit_(result));
   }
 
   template <class RT>
@@ -595,9 +594,11 @@ namespace BGAL
 
       if (is_certain(s1) && is_certain(s2))
       {
+        interval_filter_count.fetch_add(1, std::memory_order_relaxed);
         return mult(get_certain(s1), get_certain(s2));
       }
     }
+    exact_count.fetch_add(1, std::memory_order_relaxed);
     C2E c2e;
     // Exact version (if filtered version failed)
     EK::FT result;
@@ -633,6 +634,13 @@ namespace BGAL
         w1, w2,
         qx, qy, qz);
 
+    // the flags are cleared whatever the static filter returned, a flag left set would
+    // send the next query down the slow path too
+    if (fetestexcept(fe_flags) != 0)
+    {
+      feclearexcept(fe_flags);
+      result = _BOC::_Sign::FaileD;
+    }
     if (result == _BOC::_Sign::FaileD)
     {
       Comparison_result r = side1_filtered(
@@ -640,8 +648,11 @@ namespace BGAL
           p2x, p2y, p2z,
           w1, w2,
           qx, qy, qz);
-      result =
-          (r == Comparison_result::ZERO ? _BOC::_Sign::ZerO : (r == Comparison_result::POSITIVE ? _BOC::_Sign::PositivE : _BOC::_Sign::NegativE));
+      result = to_sign_(r);
+    }
+    else
+    {
+      static_filter_count.fetch_add(1, std::memory_order_relaxed);
     }
     return result;
   }
@@ -672,6 +683,11 @@ namespace BGAL
         w1, w2, w3,
         q1x, q1y, q1z,
         q2x, q2y, q2z);
+    if (fetestexcept(fe_flags) != 0)
+    {
+      feclearexcept(fe_flags);
+      result = _BOC::_Sign::FaileD;
+    }
     if (result == _BOC::_Sign::FaileD)
     {
       Comparison_result r = side2_filtered(
@@ -681,8 +697,11 @@ namespace BGAL
           w1, w2, w3,
           q1x, q1y, q1z,
           q2x, q2y, q2z);
-      result =
-          (r == Comparison_result::ZERO ? _BOC::_Sign::ZerO : (r == Comparison_result::POSITIVE ? _BOC::_Sign::PositivE : _BOC::_Sign::NegativE));
+      result = to_sign_(r);
+    }
+    else
+    {
+      static_filter_count.fetch_add(1, std::memory_order_relaxed);
     }
     return result;
   }
@@ -722,6 +741,11 @@ namespace BGAL
         q1x, q1y, q1z,
         q2x, q2y, q2z,
         q3x, q3y, q3z);
+    if (fetestexcept(fe_flags) != 0)
+    {
+      feclearexcept(fe_flags);
+      result = _BOC::_Sign::FaileD;
+    }
     if (result == _BOC::_Sign::FaileD)
     {
       Comparison_result r = side3_filtered(
@@ -733,10 +757,135 @@ namespace BGAL
           q1x, q1y, q1z,
           q2x, q2y, q2z,
           q3x, q3y, q3z);
-      result =
-          (r == Comparison_result::ZERO ? _BOC::_Sign::ZerO : (r == Comparison_result::POSITIVE ? _BOC::_Sign::PositivE : _BOC::_Sign::NegativE));
+      result = to_sign_(r);
+    }
+    else
+    {
+      static_filter_count.fetch_add(1, std::memory_order_relaxed);
     }
     return result;
   }
 
+  _Side3D::_Statistics _Side3D::statistics_()
+  {
+    _Statistics st;
+    st.static_filter = static_filter_count.load(std::memory_order_relaxed);
+    st.interval_filter = interval_filter_count.load(std::memory_order_relaxed);
+    st.exact = exact_count.load(std::memory_order_relaxed);
+    return st;
+  }
+
+  void _Side3D::reset_statistics_()
+  {
+    static_filter_count.store(0, std::memory_order_relaxed);
+    interval_filter_count.store(0, std::memory_order_relaxed);
+    exact_count.store(0, std::memory_order_relaxed);
+  }
+
+  // The batches run the static filter over every row first, without branching on the
+  // floating point flags, and test the flags once afterwards: if any row raised one,
+  // no static result of the batch is trusted. Only the rows the static filter could not
+  // decide go on to the interval and exact levels.
+  void _Side3D::side1_batch_(const int &n, const double *in_queries, _BOC::_Sign *out)
+  {
+    feclearexcept(fe_flags);
+    double c[11][batch_tile];
+    for (int i0 = 0; i0 < n; i0 += batch_tile)
+    {
+      const int m = std::min(batch_tile, n - i0);
+      to_columns_(in_queries + 11 * i0, 11, m, c[0]);
+#pragma omp simd
+      for (int t = 0; t < m; ++t)
+      {
+        out[i0 + t] = base_side1_(c[0][t], c[1][t], c[2][t], c[3][t], c[4][t], c[5][t], c[6][t], c[7][t],
+                                  c[8][t], c[9][t], c[10][t]);
+      }
+    }
+    const bool unsafe = fetestexcept(fe_flags) != 0;
+    if (unsafe)
+      feclearexcept(fe_flags);
+    long long resolved = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      if (!unsafe && out[i] != _BOC::_Sign::FaileD)
+      {
+        ++resolved;
+        continue;
+      }
+      const double *q = in_queries + 11 * i;
+      out[i] = to_sign_(side1_filtered(q[0], q[1], q[2], q[3], q[4], q[5], q[6], q[7], q[8], q[9], q[10]));
+    }
+    static_filter_count.fetch_add(resolved, std::memory_order_relaxed);
+  }
+
+  void _Side3D::side2_batch_(const int &n, const double *in_queries, _BOC::_Sign *out)
+  {
+    feclearexcept(fe_flags);
+    double c[18][batch_tile];
+    for (int i0 = 0; i0 < n; i0 += batch_tile)
+    {
+      const int m = std::min(batch_tile, n - i0);
+      to_columns_(in_queries + 18 * i0, 18, m, c[0]);
+#pragma omp simd
+      for (int t = 0; t < m; ++t)
+      {
+        out[i0 + t] = base_side2_(c[0][t], c[1][t], c[2][t], c[3][t], c[4][t], c[5][t], c[6][t], c[7][t],
+                                  c[8][t], c[9][t], c[10][t], c[11][t], c[12][t], c[13][t], c[14][t], c[15][t],
+                                  c[16][t], c[17][t]);
+      }
+    }
+    const bool unsafe = fetestexcept(fe_flags) != 0;
+    if (unsafe)
+      feclearexcept(fe_flags);
+    long long resolved = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      if (!unsafe && out[i] != _BOC::_Sign::FaileD)
+      {
+        ++resolved;
+        continue;
+      }
+      const double *q = in_queries + 18 * i;
+      out[i] = to_sign_(side2_filtered(q[0], q[1], q[2], q[3], q[4], q[5], q[6], q[7], q[8],
+                                       q[9], q[10], q[11], q[12], q[13], q[14], q[15], q[16], q[17]));
+    }
+    static_filter_count.fetch_add(resolved, std::memory_order_relaxed);
+  }
+
+  void _Side3D::side3_batch_(const int &n, const double *in_queries, _BOC::_Sign *out)
+  {
+    feclearexcept(fe_flags);
+    double c[25][batch_tile];
+    for (int i0 = 0; i0 < n; i0 += batch_tile)
+    {
+      const int m = std::min(batch_tile, n - i0);
+      to_columns_(in_queries + 25 * i0, 25, m, c[0]);
+#pragma omp simd
+      for (int t = 0; t < m; ++t)
+      {
+        out[i0 + t] = base_side3_(c[0][t], c[1][t], c[2][t], c[3][t], c[4][t], c[5][t], c[6][t], c[7][t],
+                                  c[8][t], c[9][t], c[10][t], c[11][t], c[12][t], c[13][t], c[14][t], c[15][t],
+                                  c[16][t], c[17][t], c[18][t], c[19][t], c[20][t], c[21][t], c[22][t], c[23][t],
+                                  c[24][t]);
+      }
+    }
+    const bool unsafe = fetestexcept(fe_flags) != 0;
+    if (unsafe)
+      feclearexcept(fe_flags);
+    long long resolved = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      if (!unsafe && out[i] != _BOC::_Sign::FaileD)
+      {
+        ++resolved;
+        continue;
+      }
+      const double *q = in_queries + 25 * i;
+      out[i] = to_sign_(side3_filtered(q[0], q[1], q[2], q[3], q[4], q[5], q[6], q[7], q[8], q[9], q[10], q[11],
+                                       q[12], q[13], q[14], q[15],
+                                       q[16], q[17], q[18], q[19], q[20], q[21], q[22], q[23], q[24]));
+    }
+    static_filter_count.fetch_add(resolved, std::memory_order_relaxed);
+  }
+
 } // namespace BGAL
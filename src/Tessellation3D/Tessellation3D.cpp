@@ -1,57 +1,87 @@
+#include "BGAL/Algorithm/Profiler/Profiler.h"
 #include "BGAL/Tessellation3D/Side3D.h"
 #include "BGAL/Tessellation3D/Tessellation3D.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <omp.h>
 namespace BGAL
 {
   _Tessellation3D_Skeleton::_Tessellation3D_Skeleton()
   {
+    _offsets.assign(1, 0);
     _neights.resize(0);
   }
   _Tessellation3D_Skeleton::_Tessellation3D_Skeleton(Rt &rt, const int &num_vertices)
   {
-    _neights.resize(num_vertices);
-    for (auto c_it = rt.finite_cells_begin(); c_it != rt.finite_cells_end(); c_it++)
+    // the edges of the triangulation are exactly the neighbouring pairs, each met once
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(rt.number_of_finite_edges());
+    for (auto e_it = rt.finite_edges_begin(); e_it != rt.finite_edges_end(); ++e_it)
     {
-      int i0, i1, i2, i3;
-      i0 = c_it->vertex(0)->info();
-      i1 = c_it->vertex(1)->info();
-      i2 = c_it->vertex(2)->info();
-      i3 = c_it->vertex(3)->info();
-      if (i0 != -1)
-      {
-        if (i1 != -1)
-        {
-          _neights[i0].insert(i1);
-          _neights[i1].insert(i0);
-        }
-        if (i2 != -1)
-        {
-          _neights[i0].insert(i2);
-          _neights[i2].insert(i0);
-        }
-        if (i3 != -1)
-        {
-          _neights[i0].insert(i3);
-          _neights[i3].insert(i0);
-        }
-      }
-      if (i1 != -1)
+      const int i0 = e_it->first->vertex(e_it->second)->info();
+      const int i1 = e_it->first->vertex(e_it->third)->info();
+      if (i0 != -1 && i1 != -1)
+        edges.push_back(std::make_pair(i0, i1));
+    }
+    const int num_edges = edges.size();
+    std::vector<int> degree(num_vertices, 0);
+#pragma omp parallel for schedule(static)
+    for (int e = 0; e < num_edges; ++e)
+    {
+#pragma omp atomic
+      ++degree[edges[e].first];
+#pragma omp atomic
+      ++degree[edges[e].second];
+    }
+    _offsets.resize(num_vertices + 1);
+    _offsets[0] = 0;
+    for (int i = 0; i < num_vertices; ++i)
+    {
+      _offsets[i + 1] = _offsets[i] + degree[i];
+    }
+    _neights.resize(_offsets[num_vertices]);
+    std::vector<int> cursor(_offsets.begin(), _offsets.end() - 1);
+#pragma omp parallel for schedule(static)
+    for (int e = 0; e < num_edges; ++e)
+    {
+      int k0, k1;
+#pragma omp atomic capture
+      k0 = cursor[edges[e].first]++;
+#pragma omp atomic capture
+      k1 = cursor[edges[e].second]++;
+      _neights[k0] = edges[e].second;
+      _neights[k1] = edges[e].first;
+    }
+    // the filling order depends on the threads, the sorted rows don't
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < num_vertices; ++i)
+    {
+      std::sort(_neights.begin() + _offsets[i], _neights.begin() + _offsets[i + 1]);
+    }
+  }
+  void _Tessellation3D_Skeleton::sort_by_distance_(const std::vector<_Point3> &in_sites)
+  {
+    const int num_vertices = _offsets.size() - 1;
+#pragma omp parallel
+    {
+      std::vector<std::pair<double, int>> order;
+#pragma omp for schedule(dynamic, 256)
+      for (int i = 0; i < num_vertices; ++i)
       {
-        if (i2 != -1)
+        const Eigen::Vector3d si(in_sites[i].x(), in_sites[i].y(), in_sites[i].z());
+        order.clear();
+        for (int k = _offsets[i]; k < _offsets[i + 1]; ++k)
         {
-          _neights[i1].insert(i2);
-          _neights[i2].insert(i1);
+          const _Point3 &sj = in_sites[_neights[k]];
+          order.push_back(std::make_pair((Eigen::Vector3d(sj.x(), sj.y(), sj.z()) - si).squaredNorm(), _neights[k]));
         }
-        if (i3 != -1)
+        std::sort(order.begin(), order.end());
+        for (int k = 0; k < order.size(); ++k)
         {
-          _neights[i3].insert(i1);
-          _neights[i1].insert(i3);
+          _neights[_offsets[i] + k] = order[k].second;
         }
       }
-      if (i2 != -1 && i3 != -1)
-      {
-        _neights[i3].insert(i2);
-        _neights[i2].insert(i3);
-      }
     }
   }
 
@@ -154,6 +184,98 @@ namespace BGAL
     return res;
   }
 
+  void _Restricted_Tessellation3D::side_batch_(const int &ip1,
+                                               const int &ip2,
+                                               const std::vector<_Symbolic_Point> &vs,
+                                               std::vector<_BOC::_Sign> &out)
+  {
+    const _Point3 &p1 = _sites[ip1];
+    const _Point3 &p2 = _sites[ip2];
+    for (int k = 0; k < 3; ++k)
+    {
+      _side_queries[k].clear();
+      _side_rows[k].clear();
+    }
+    for (int i = 0; i < vs.size(); ++i)
+    {
+      const _Symbolic_Point &v = vs[i];
+      if (v.flag < 1 || v.flag > 3)
+        throw std::runtime_error("flag error");
+      std::vector<double> &q = _side_queries[v.flag - 1];
+      _side_rows[v.flag - 1].push_back(i);
+      q.push_back(p1.x());
+      q.push_back(p1.y());
+      q.push_back(p1.z());
+      q.push_back(p2.x());
+      q.push_back(p2.y());
+      q.push_back(p2.z());
+      if (v.flag == 1)
+      {
+        _Point3 q1 = _model.vertex_(v.p[0]);
+        q.push_back(_weights[ip1]);
+        q.push_back(_weights[ip2]);
+        q.push_back(q1.x());
+        q.push_back(q1.y());
+        q.push_back(q1.z());
+        continue;
+      }
+      int ip3, ip4 = -1;
+      if (v.flag == 2)
+      {
+        ip3 = v.p[2];
+      }
+      else
+      {
+        auto it = v._sym.begin();
+        while (*it <= 0)
+          ++it;
+        ip3 = *it - 1;
+        ip4 = *(++it) - 1;
+      }
+      const _Point3 &p3 = _sites[ip3];
+      q.push_back(p3.x());
+      q.push_back(p3.y());
+      q.push_back(p3.z());
+      if (v.flag == 3)
+      {
+        const _Point3 &p4 = _sites[ip4];
+        q.push_back(p4.x());
+        q.push_back(p4.y());
+        q.push_back(p4.z());
+      }
+      q.push_back(_weights[ip1]);
+      q.push_back(_weights[ip2]);
+      q.push_back(_weights[ip3]);
+      if (v.flag == 3)
+        q.push_back(_weights[ip4]);
+      for (int j = 0; j < v.flag; ++j)
+      {
+        _Point3 qj = _model.vertex_(v.p[j]);
+        q.push_back(qj.x());
+        q.push_back(qj.y());
+        q.push_back(qj.z());
+      }
+    }
+    out.resize(vs.size());
+    for (int k = 0; k < 3; ++k)
+    {
+      const int n = _side_rows[k].size();
+      if (n == 0)
+        continue;
+      _side_signs.resize(n);
+      if (k == 0)
+        _Side3D::side1_batch_(n, _side_queries[k].data(), _side_signs.data());
+      else if (k == 1)
+        _Side3D::side2_batch_(n, _side_queries[k].data(), _side_signs.data());
+      else
+        _Side3D::side3_batch_(n, _side_queries[k].data(), _side_signs.data());
+      for (int i = 0; i < n; ++i)
+      {
+        out[_side_rows[k][i]] = _side_signs[i];
+      }
+    }
+  }
+
   _Restricted_Tessellation3D::_Symbolic_Point _Restricted_Tessellation3D::insec_bisector_(const _Symbolic_Point &p1,
                                                                                           const _Symbolic_Point &p2,
                                                                                           const int &neigh,
@@ -209,6 +331,7 @@ namespace BGAL
 
   void _Restricted_Tessellation3D::calculate_()
   {
+    BGAL_PROFILE_SCOPE("rvd");
     std::vector<std::pair<Weighted_point, int>> wps(_num_sites);
     double min_weight = *(std::min_element(_weights.begin(), _weights.end()));
     for (int i = 0; i < _num_sites; ++i)
@@ -258,8 +381,13 @@ namespace BGAL
                                                       3 * max_p.z() - 2 * min_p.z()),
                                                 min_weight),
                                  -1));
+    BGAL_PROFILE_BEGIN(triangulation, "triangulation");
     Rt rt(wps.begin(), wps.end());
+    BGAL_PROFILE_END(triangulation);
+    BGAL_PROFILE_BEGIN(skeleton, "skeleton");
     _skeleton = _Tessellation3D_Skeleton(rt, _num_sites);
+    BGAL_PROFILE_END(skeleton);
+    BGAL_PROFILE_BEGIN(clipping, "clipping");
     std::vector<bool> face_is_visited(_model.number_faces_(), false);
     std::vector<std::map<int, int>> from_idx_to_locations(_num_sites);
     std::map<int, int> from_locations_to_idx;
@@ -318,7 +446,8 @@ namespace BGAL
         current_face_vid.push_back(original_cliped[1].p[0]);
         current_face_vid.push_back(original_cliped[2].p[0]);
         std::vector<_Symbolic_Point> update_cliped(0);
-        const std::set<int> &planes = _skeleton.neight_(current_site);
+        std::vector<_BOC::_Sign> states;
+        const _Tessellation3D_Skeleton::_Neighbours planes = _skeleton.neight_(current_site);
         for (auto p = planes.begin(); p != planes.end(); ++p)
         {
           if (old_cliped.size() == 0)
@@ -326,8 +455,9 @@ namespace BGAL
           //std::cout << "old size  " << old_cliped.size() << std::endl;
           //std::cout << "adj site  " << *p << std::endl;
 
-          _BOC::_Sign pre_state = side_(current_site, *p, old_cliped[0]);
-          _BOC::_Sign cur_state = side_(current_site, *p, old_cliped[1]);
+          side_batch_(current_site, *p, old_cliped, states);
+          _BOC::_Sign pre_state = states[0];
+          _BOC::_Sign cur_state = states[1];
           //std::cout << "old cliped[0]:  ";
           //for (auto tit = old_cliped[0]._sym.begin(); tit != old_cliped[0]._sym.end(); ++tit)
           //{
@@ -378,7 +508,7 @@ namespace BGAL
             }
             else if (cur_state == _BOC::_Sign::ZerO)
             {
-              _BOC::_Sign sp2 = side_(current_site, *p, old_cliped[2]);
+              _BOC::_Sign sp2 = states[2];
               if (sp2 == _BOC::_Sign::PositivE)
               {
                 update_cliped.clear();
@@ -403,7 +533,7 @@ namespace BGAL
             //std::cout << *tit << " ";
             //}
             //std::cout << std::endl;
-            nex_state = side_(current_site, *p, old_cliped[i]);
+            nex_state = states[i];
             //std::cout << "nex cur: " << (nex_state == _BOC::_Sign::ZerO ? 0 : (nex_state == _BOC::_Sign::PositivE ? 1 : -1)) << std::endl;
             if (cur_state == _BOC::_Sign::PositivE)
             {
@@ -620,12 +750,17 @@ namespace BGAL
         face_is_visited[current_face] = true;
       }
     }
+    BGAL_PROFILE_END(clipping);
+    BGAL_PROFILE_SCOPE("vertex_dedup");
     _vertices.clear();
     _cells.clear();
     _cells.resize(_num_sites);
     _edges.clear();
     _edges.resize(_num_sites);
     std::map<std::set<int>, int> from_Sym_to_vertex;
+    // every vertex where three cells meet is dual to the triangle of the three sites:
+    // (i, site, site, face)
+    std::vector<std::tuple<int, int, int, int>> dual_faces;
 
     for (int i = 0; i < _num_sites; ++i)
     {
@@ -716,6 +851,7 @@ namespace BGAL
             from_Sym_to_vertex[psym] = _vertices.size();
             firest_p = _vertices.size();
             _vertices.push_back(cp3);
+            dual_faces.push_back(std::make_tuple(i, p12[0], p12[1], q));
           }
           else
           {
@@ -805,6 +941,7 @@ namespace BGAL
             from_Sym_to_vertex[psym] = _vertices.size();
             second_p = _vertices.size();
             _vertices.push_back(cp3);
+            dual_faces.push_back(std::make_tuple(i, p12[0], p12[1], q));
           }
           else
           {
@@ -921,6 +1058,7 @@ namespace BGAL
               from_Sym_to_vertex[psym] = _vertices.size();
               third_p = _vertices.size();
               _vertices.push_back(cp3);
+              dual_faces.push_back(std::make_tuple(i, p12[0], p12[1], q));
             }
             else
             {
@@ -982,6 +1120,79 @@ namespace BGAL
         }
       }
     }
+    extract_rdt_(dual_faces);
+  }
+  void _Restricted_Tessellation3D::extract_rdt_(const std::vector<std::tuple<int, int, int, int>> &in_dual_faces)
+  {
+    const int num = in_dual_faces.size();
+    // orient every triangle along the normal of the surface face it was found on and
+    // start it at its smallest site
+    std::vector<std::tuple<int, int, int>> oriented(num);
+    std::vector<std::tuple<int, int, int, int>> keys(num);
+#pragma omp parallel for schedule(static)
+    for (int f = 0; f < num; ++f)
+    {
+      int a = std::get<0>(in_dual_faces[f]);
+      int b = std::get<1>(in_dual_faces[f]);
+      int c = std::get<2>(in_dual_faces[f]);
+      const _Point3 n = (_sites[b] - _sites[a]).cross_(_sites[c] - _sites[a]);
+      if (n.dot_(_model.normal_face_(std::get<3>(in_dual_faces[f]))) < 0)
+        std::swap(b, c);
+      while (a > b || a > c)
+      {
+        const int t = a;
+        a = b;
+        b = c;
+        c = t;
+      }
+      oriented[f] = std::make_tuple(a, b, c);
+      keys[f] = std::make_tuple(a, std::min(b, c), std::max(b, c), f);
+    }
+    // the same three cells may meet more than once; keeping the first occurrence of
+    // each triangle makes the output independent of the number of threads
+    std::sort(keys.begin(), keys.end());
+    _rdt_faces.clear();
+    _rdt_faces.reserve(3 * num);
+    for (int k = 0; k < num; ++k)
+    {
+      if (k > 0 && std::get<0>(keys[k]) == std::get<0>(keys[k - 1]) &&
+          std::get<1>(keys[k]) == std::get<1>(keys[k - 1]) && std::get<2>(keys[k]) == std::get<2>(keys[k - 1]))
+        continue;
+      const std::tuple<int, int, int> &t = oriented[std::get<3>(keys[k])];
+      _rdt_faces.push_back(std::get<0>(t));
+      _rdt_faces.push_back(std::get<1>(t));
+      _rdt_faces.push_back(std::get<2>(t));
+    }
+  }
+  void _Restricted_Tessellation3D::save_rdt_(const std::string &in_file_name) const
+  {
+    std::ofstream out(in_file_name, std::ios::binary);
+    if (!out)
+      throw std::runtime_error("can't open " + in_file_name);
+    const int num_faces = number_rdt_faces_();
+    out << "ply\nformat binary_little_endian 1.0\n"
+        << "element vertex " << _num_sites << "\n"
+        << "property double x\nproperty double y\nproperty double z\n"
+        << "element face " << num_faces << "\n"
+        << "property list uchar int vertex_indices\n"
+        << "end_header\n";
+    std::vector<double> xyz(3 * _num_sites);
+    for (int i = 0; i < _num_sites; ++i)
+    {
+      xyz[3 * i] = _sites[i].x();
+      xyz[3 * i + 1] = _sites[i].y();
+      xyz[3 * i + 2] = _sites[i].z();
+    }
+    out.write(reinterpret_cast<const char *>(xyz.data()), xyz.size() * sizeof(double));
+    // one face record is a one byte count followed by three ints
+    std::vector<char> faces(num_faces * (1 + 3 * sizeof(int)));
+    for (int f = 0; f < num_faces; ++f)
+    {
+      char *rec = faces.data() + f * (1 + 3 * sizeof(int));
+      rec[0] = 3;
+      memcpy(rec + 1, _rdt_faces.data() + 3 * f, 3 * sizeof(int));
+    }
+    out.write(faces.data(), faces.size());
   }
   _Restricted_Tessellation3D::_Restricted_Tessellation3D(const _ManifoldModel& in_model)
       :_model(in_model)
@@ -4,24 +4,38 @@
 #include <io.h>
 #include <random>
 #include <omp.h>
+#include <BGAL/Algorithm/Profiler/Profiler.h>
 #include <BGAL/Optimization/LinearSystem/LinearSystem.h>
 #include <BGAL/Optimization/ALGLIB/optimization.h>
 #include <BGAL/Optimization/LBFGS/LBFGS.h>
 #include <BGAL/BaseShape/Point.h>
 #include <BGAL/BaseShape/Polygon.h>
+#include <BGAL/BaseShape/PreparedPolygon.h>
 #include <BGAL/Tessellation2D/Tessellation2D.h>
 #include <BGAL/Draw/DrawPS.h>
 #include <BGAL/Integral/Integral.h>
+#include <BGAL/Model/Contouring.h>
 #include <BGAL/Model/ManifoldModel.h>
 #include <BGAL/Model/Model_Iterator.h>
+#include <BGAL/Model/SDFGrid.h>
+#include <BGAL/Model/Simplification.h>
 #include <BGAL/Optimization/GradientDescent/GradientDescent.h>
+#include <BGAL/Tessellation3D/ConvexCell.h>
 #include <BGAL/Tessellation3D/Tessellation3D.h>
+#include <BGAL/Tessellation3D/Side3D.h>
 #include <BGAL/BaseShape/KDTree.h>
 #include <BGAL/PointCloudProcessing/Registration/ICP/ICP.h>
+#include <BGAL/PointCloudProcessing/FeatureDetection/FeatureDetection.h>
+#include <BGAL/PointCloudProcessing/FeatureProjection/FeatureProjection.h>
+#include <BGAL/PointCloudProcessing/Neighborhood/Neighborhood.h>
+#include <BGAL/PointCloudProcessing/Denoiser/Denoiser.h>
+#include <BGAL/PointCloudProcessing/IO/PointCloudIO.h>
 #include <BGAL/Reconstruction/MarchingTetrahedra/MarchingTetrahedra.h>
 #include <BGAL/Geodesic/Dijkstra/Dijkstra.h>
 #include <BGAL/CVTLike/CPD.h>
 #include <BGAL/CVTLike/CVT.h>
+#include <BGAL/CVTLike/SiteSampler.h>
+#include <BGAL/CVTLike/VolumeCVT.h>
 //Test BOC sign
 void BOCSignTest()
 {
@@ -54,6 +68,29 @@ void BOCSignTest()
 	}
 }
 
+//ProfilerTest
+void ProfilerTest()
+{
+	BGAL::_Profiler::reset_();
+	{
+		BGAL::_Profiler::_Scope outer("outer");
+		for (int i = 0; i < 3; ++i)
+		{
+			BGAL::_Profiler::_Scope inner("inner");
+		}
+	}
+	static BGAL::_Profiler::_Counter counter("test/events");
+#pragma omp parallel for
+	for (int i = 0; i < 1000; ++i)
+		counter.add_(1);
+	BGAL::_Profiler::write_report_("data\\ProfilerTest.json");
+	std::ifstream in("data\\ProfilerTest.json");
+	std::string report((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	std::cout << "nested: " << (report.find("\"path\": \"outer/inner\", \"calls\": 3") != std::string::npos)
+		<< "  events: " << counter.value_() << std::endl;
+}
+//***********************************
+
 //Test LinearSystem
 void LinearSystemTest()
 {
@@ -186,6 +223,136 @@ void LBFGSTest()
 }
 //***********************************
 
+//LBFGSCallbackTest
+void LBFGSCallbackTest()
+{
+	class rosenbrock
+	{
+	public:
+		double operator()(const Eigen::VectorXd& x, Eigen::VectorXd& g)
+		{
+			double fval = 0;
+			g.setZero();
+			for (int i = 0; i + 1 < x.size(); ++i)
+			{
+				double a = x(i + 1) - x(i) * x(i);
+				double b = 1 - x(i);
+				fval += 100 * a * a + b * b;
+				g(i) += -400 * a * x(i) - 2 * b;
+				g(i + 1) += 200 * a;
+			}
+			return fval;
+		}
+	};
+	rosenbrock fun;
+	std::vector<BGAL::_LBFGS::_Iteration_Info> infos;
+	BGAL::_LBFGS::_Parameter param;
+	param.epsilon = 1e-8;
+	param.callback = [&](const BGAL::_LBFGS::_Iteration_Info& info)
+	{
+		infos.push_back(info);
+		return true;
+	};
+	BGAL::_LBFGS lbfgs(param);
+	Eigen::VectorXd iterX = Eigen::VectorXd::Constant(10, -1.2);
+	int n = lbfgs.minimize(fun, iterX);
+	bool decreasing = true;
+	for (int i = 1; i < (int)infos.size(); ++i)
+	{
+		decreasing = decreasing && infos[i].energy <= infos[i - 1].energy && infos[i].time >= infos[i - 1].time;
+	}
+	std::cout << "converged: " << ((iterX - Eigen::VectorXd::Ones(10)).norm() < 1e-6)
+		<< "  reports: " << ((int)infos.size() == n + 1) << "  decreasing: " << decreasing << std::endl;
+	// the second run reuses the buffers and is cut off by the callback
+	lbfgs._parameter.callback = [](const BGAL::_LBFGS::_Iteration_Info& info)
+	{
+		return info.iteration < 5;
+	};
+	iterX.setConstant(-1.2);
+	std::cout << "stopped at: " << lbfgs.minimize(fun, iterX) << std::endl;
+}
+//***********************************
+
+//LineSearchTest
+void LineSearchTest()
+{
+	class problem
+	{
+	public:
+		double operator()(const Eigen::VectorXd& x, Eigen::VectorXd& g)
+		{
+			double fval = 0;
+			for (int i = 0; i < x.size(); ++i)
+			{
+				double c = 1 + i % 100;
+				g(i) = c * (x(i) - 1);
+				fval += 0.5 * c * (x(i) - 1) * (x(i) - 1);
+			}
+			return fval;
+		}
+	};
+	problem fun;
+	int evaluations[2];
+	bool converged[2];
+	for (int mt = 0; mt < 2; ++mt)
+	{
+		BGAL::_GradientDescent::_Parameter param;
+		param.more_thuente = mt == 1;
+		param.max_iteration = 2000;
+		BGAL::_GradientDescent gd(param);
+		Eigen::VectorXd iterX = Eigen::VectorXd::Zero(1000);
+		gd.minimize(fun, iterX);
+		evaluations[mt] = gd.number_evaluations_();
+		converged[mt] = (iterX - Eigen::VectorXd::Ones(1000)).norm() < 1e-5;
+	}
+	std::cout << "converged: " << converged[0] << " " << converged[1]
+		<< "  fewer evaluations: " << (evaluations[1] < evaluations[0]) << std::endl;
+}
+//***********************************
+
+//LBFGSCheckpointTest
+void LBFGSCheckpointTest()
+{
+	const int n = 10;
+	std::function<double(const Eigen::VectorXd& X, Eigen::VectorXd& g)> fg
+		= [&](const Eigen::VectorXd& X, Eigen::VectorXd& g)
+	{
+		double f = 0;
+		g.setZero();
+		for (int i = 0; i + 1 < n; ++i)
+		{
+			double a = X(i + 1) - X(i) * X(i);
+			double b = 1 - X(i);
+			f += 100 * a * a + b * b;
+			g(i) += -400 * a * X(i) - 2 * b;
+			g(i + 1) += 200 * a;
+		}
+		return f;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.epsilon = 1e-10;
+	BGAL::_LBFGS full(para);
+	Eigen::VectorXd fullX = Eigen::VectorXd::Constant(n, -1.2);
+	full.minimize(fg, fullX);
+	// the run is interrupted at iteration 12, the last checkpoint is from iteration 10
+	para.checkpoint_file = "data\\LBFGSCheckpointTest.bin";
+	para.checkpoint_interval = 5;
+	para.callback = [](const BGAL::_LBFGS::_Iteration_Info& info)
+	{
+		return info.iteration < 12;
+	};
+	BGAL::_LBFGS interrupted(para);
+	Eigen::VectorXd iterX = Eigen::VectorXd::Constant(n, -1.2);
+	interrupted.minimize(fg, iterX);
+	BGAL::_LBFGS::_Checkpoint checkpoint;
+	BGAL::_LBFGS::load_checkpoint_(para.checkpoint_file, checkpoint);
+	para.callback = nullptr;
+	BGAL::_LBFGS resumed(para);
+	resumed.resume(fg, iterX, para.checkpoint_file);
+	std::cout << "resumed at: " << checkpoint.iteration << "  same result: " << ((iterX - fullX).norm() < 1e-12) << std::endl;
+}
+//***********************************
+
 //BaseShapeTest
 void BaseShapeTest()
 {
@@ -207,6 +374,57 @@ void BaseShapeTest()
 }
 //***********************************
 
+//PreparedPolygonTest
+void PreparedPolygonTest()
+{
+	// a star shaped polygon with many edges
+	BGAL::_Polygon boundary;
+	boundary.start_();
+	for (int i = 0; i < 1000; ++i)
+	{
+		const double t = 2 * BGAL::_BOC::PI() * i / 1000, r = 0.5 + 0.4 * BGAL::_BOC::rand_();
+		boundary.insert_(r * cos(t), r * sin(t));
+	}
+	boundary.end_();
+	BGAL::_Prepared_Polygon prepared(boundary);
+	std::vector<BGAL::_Point2> points;
+	for (int i = 0; i < 2000; ++i)
+	{
+		points.push_back(BGAL::_Point2(2.4 * BGAL::_BOC::rand_() - 1.2, 2.4 * BGAL::_BOC::rand_() - 1.2));
+	}
+	for (int i = 0; i < boundary.num_(); i += 10)
+	{
+		points.push_back(boundary[i]);
+	}
+	std::vector<char> in = prepared.is_in_(points);
+	std::vector<double> distances = prepared.distances_to_boundary_(points);
+	std::vector<std::pair<BGAL::_Point2, BGAL::_Point2>> segments;
+	for (int i = 0; i + 1 < points.size(); i += 2)
+	{
+		segments.push_back(std::make_pair(points[i], points[i + 1]));
+	}
+	std::vector<std::vector<std::pair<int, BGAL::_Point2>>> intersections;
+	std::vector<int> num = prepared.intersections_with_linesegments_(segments, intersections);
+	int wrong_in = 0, wrong_distance = 0, wrong_segment = 0;
+	for (int i = 0; i < points.size(); ++i)
+	{
+		wrong_in += boundary.is_in_(points[i]) != bool(in[i]);
+		wrong_distance += fabs(boundary.distance_to_boundary_(points[i]) - distances[i]) > 1e-12;
+	}
+	for (int i = 0; i < segments.size(); ++i)
+	{
+		std::vector<std::pair<int, BGAL::_Point2>> res;
+		bool same = boundary.intersection_with_linesegment_(segments[i].first, segments[i].second, res) == num[i] && res.size() == intersections[i].size();
+		for (int k = 0; same && k < res.size(); ++k)
+		{
+			same = res[k].first == intersections[i][k].first && res[k].second == intersections[i][k].second;
+		}
+		wrong_segment += !same;
+	}
+	std::cout << "wrong: " << wrong_in << " " << wrong_distance << " " << wrong_segment << std::endl;
+}
+//***********************************
+
 //TessellationTest2D
 void Tessellation2DTest()
 {
@@ -380,6 +598,92 @@ void IntegralTest()
 }
 //***********************************
 
+//PolygonIntegralTest
+void PolygonIntegralTest()
+{
+	// an L shaped boundary, so the cells at its reflex corner are not convex
+	BGAL::_Polygon boundary;
+	boundary.start_();
+	boundary.insert_(BGAL::_Point2(0, 0));
+	boundary.insert_(BGAL::_Point2(2, 0));
+	boundary.insert_(BGAL::_Point2(2, 1));
+	boundary.insert_(BGAL::_Point2(1, 1));
+	boundary.insert_(BGAL::_Point2(1, 2));
+	boundary.insert_(BGAL::_Point2(0, 2));
+	boundary.end_();
+	std::vector<BGAL::_Point2> sites;
+	while (sites.size() < 200)
+	{
+		BGAL::_Point2 p(2 * BGAL::_BOC::rand_(), 2 * BGAL::_BOC::rand_());
+		if (boundary.is_in_(p))
+			sites.push_back(p);
+	}
+	BGAL::_Tessellation2D voronoi(boundary, sites);
+	const std::vector<BGAL::_Polygon>& cells = voronoi.get_cell_polygons_();
+	std::vector<Eigen::Vector3d> inte;
+	BGAL::_Integral::integral_cells(
+		[&](const int& i, const Eigen::Vector2d& p)
+		{
+			const Eigen::Vector2d d(sites[i].x() - p.x(), sites[i].y() - p.y());
+			return Eigen::Vector3d(d.squaredNorm(), 2 * d.x(), 2 * d.y());
+		}, cells, inte);
+	// the same CVT energy and gradient from the moments
+	std::vector<Eigen::Matrix<double, 6, 1>> moments;
+	BGAL::_Integral::polygon_moments(cells, moments);
+	double area = 0, error = 0;
+	for (int i = 0; i < cells.size(); ++i)
+	{
+		const Eigen::Matrix<double, 6, 1>& m = moments[i];
+		const double x = sites[i].x(), y = sites[i].y();
+		const Eigen::Vector3d r((x * x + y * y) * m(0) - 2 * (x * m(1) + y * m(2)) + m(3) + m(5),
+			2 * (x * m(0) - m(1)), 2 * (y * m(0) - m(2)));
+		error = std::max(error, (r - inte[i]).norm());
+		area += m(0);
+	}
+	std::cout << "area: " << area << "  agree: " << (error < 1e-12) << "  convex boundary: " << boundary.is_convex_() << std::endl;
+}
+//***********************************
+
+//QuadratureTest
+void QuadratureTest()
+{
+	// x^k over the reference tetrahedron is k! / (k + 3)!
+	int wrong = 0;
+	for (int k = 0; k <= 8; ++k)
+	{
+		const BGAL::_Quadrature_Rule& rule = BGAL::_Integral::tetrahedron_rule(k);
+		Eigen::VectorXd r = BGAL::_Integral::integral_tetrahedron(
+			[&](BGAL::_Point3 p)
+			{
+				Eigen::VectorXd res(1);
+				res(0) = pow(p.x(), k);
+				return res;
+			}, BGAL::_Point3(0, 0, 0), BGAL::_Point3(1, 0, 0), BGAL::_Point3(0, 1, 0), BGAL::_Point3(0, 0, 1), rule);
+		if (fabs(r(0) * (k + 1) * (k + 2) * (k + 3) - 1) > 1e-12)
+			++wrong;
+	}
+	// unit cube split into six tetrahedra
+	std::vector<Eigen::Vector3d> vertices;
+	for (int i = 0; i < 8; ++i)
+	{
+		vertices.push_back(Eigen::Vector3d(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+	}
+	std::vector<std::array<int, 4>> tets = { { 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 }, { 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 } };
+	std::vector<Eigen::Vector2d> out;
+	BGAL::_Integral::integral_tetrahedra(
+		[](const Eigen::Vector3d& p)
+		{
+			return Eigen::Vector2d(1, p.x() * p.x());
+		}, vertices, tets, out);
+	Eigen::Vector2d sum(0, 0);
+	for (int i = 0; i < out.size(); ++i)
+	{
+		sum += out[i];
+	}
+	std::cout << "wrong rules: " << wrong << "  cube: " << sum(0) << " " << sum(1) << std::endl;
+}
+//***********************************
+
 //ModelTest
 void ModelTest()
 {
@@ -394,6 +698,210 @@ void ModelTest()
 }
 //***********************************
 
+//SimplificationTest
+void SimplificationTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	BGAL::_ManifoldModel coarse = BGAL::_Mesh_Simplification::simplify_(model, 320);
+	// every edge of a closed manifold has its reverse
+	int open = 0;
+	for (BGAL::_Edge_Iterator e_it = coarse.edge_begin(); e_it != coarse.edge_end(); ++e_it)
+	{
+		if ((*e_it)._id_reverse_edge < 0)
+			++open;
+	}
+	std::cout << "F number: " << coarse.number_faces_() << "  Euler: " << coarse.number_vertices_() - coarse.number_edges_() / 2 + coarse.number_faces_()
+		<< "  open edges: " << open << std::endl;
+}
+//***********************************
+
+//ContouringTest
+void ContouringTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	std::vector<double> field(model.number_vertices_());
+	for (int i = 0; i < model.number_vertices_(); ++i)
+		field[i] = model.vertex_(i).z();
+	BGAL::_Mesh_Contouring contouring(model);
+	std::vector<std::vector<BGAL::_Point3>> loops = contouring.isolines_(field, 0.1);
+	std::vector<double> values;
+	for (int i = 1; i < 10; ++i)
+		values.push_back(i * 0.2 - 1);
+	std::vector<std::vector<std::vector<BGAL::_Point3>>> levels = contouring.isolines_(field, values);
+	int single = 0;
+	for (auto& level : levels)
+		single += level.size() == 1 && level[0].front() == level[0].back();
+	std::pair<BGAL::_ManifoldModel, BGAL::_ManifoldModel> sides = contouring.split_(field, 0.1);
+	int open = 0;
+	for (int i = 0; i < sides.second.number_edges_(); ++i)
+	{
+		if (sides.second.edge_(i)._id_face == -1)
+			++open;
+	}
+	std::cout << "loops: " << loops.size() << "  closed: " << (loops[0].front() == loops[0].back())
+		<< "  one loop per level: " << (single == values.size())
+		<< "  boundary: " << (open == loops[0].size() - 1) << std::endl;
+}
+//***********************************
+
+//ConvexCellTest
+void ConvexCellTest()
+{
+	std::vector<Eigen::Vector3d> sites;
+	for (int i = 0; i < 200; ++i)
+		sites.push_back(Eigen::Vector3d(BGAL::_BOC::rand_(), BGAL::_BOC::rand_(), BGAL::_BOC::rand_()));
+	std::vector<std::vector<Eigen::Vector4d>> planes(sites.size());
+	for (int i = 0; i < sites.size(); ++i)
+	{
+		for (int j = 0; j < sites.size(); ++j)
+		{
+			if (i == j)
+				continue;
+			Eigen::Vector3d normal = sites[j] - sites[i];
+			planes[i].push_back(Eigen::Vector4d(normal.x(), normal.y(), normal.z(), -normal.dot(sites[i] + sites[j]) / 2));
+		}
+	}
+	std::vector<BGAL::_Convex_Cell> cells(sites.size(), BGAL::_Convex_Cell(BGAL::_Point3(0, 0, 0), BGAL::_Point3(1, 1, 1)));
+	BGAL::_Convex_Cell::clip_(cells, planes);
+	double volume = 0;
+	int closed = 0;
+	for (auto& cell : cells)
+	{
+		volume += cell.volume_();
+		BGAL::_ManifoldModel model = cell.model_();
+		if (model.number_vertices_() - model.number_edges_() / 2 + model.number_faces_() == 2)
+			++closed;
+	}
+	std::cout << "volume: " << volume << "  closed cells: " << closed << std::endl;
+}
+//***********************************
+
+//ConvexCellLatticeTest
+void ConvexCellLatticeTest()
+{
+	// sites of a lattice: more than three planes meet at every vertex, and every plane is
+	// given twice
+	std::vector<Eigen::Vector3d> sites;
+	for (int i = 0; i < 5; ++i)
+		for (int j = 0; j < 5; ++j)
+			for (int k = 0; k < 5; ++k)
+				sites.push_back(Eigen::Vector3d(i + 0.5, j + 0.5, k + 0.5) / 5);
+	std::vector<std::vector<Eigen::Vector4d>> planes(sites.size());
+	for (int i = 0; i < sites.size(); ++i)
+	{
+		for (int j = 0; j < sites.size(); ++j)
+		{
+			if (i == j)
+				continue;
+			Eigen::Vector3d normal = sites[j] - sites[i];
+			planes[i].push_back(Eigen::Vector4d(normal.x(), normal.y(), normal.z(), -normal.dot(sites[i] + sites[j]) / 2));
+			planes[i].push_back(planes[i].back());
+		}
+	}
+	std::vector<BGAL::_Convex_Cell> cells(sites.size(), BGAL::_Convex_Cell(BGAL::_Point3(0, 0, 0), BGAL::_Point3(1, 1, 1)));
+	BGAL::_Convex_Cell::clip_(cells, planes);
+	double volume = 0;
+	int closed = 0;
+	for (auto& cell : cells)
+	{
+		volume += cell.volume_();
+		BGAL::_ManifoldModel model = cell.model_();
+		if (model.number_vertices_() - model.number_edges_() / 2 + model.number_faces_() == 2)
+			++closed;
+	}
+	std::cout << "volume: " << volume << "  closed cells: " << closed << std::endl;
+}
+//***********************************
+
+//SDFGridTest
+void SDFGridTest()
+{
+	// sampled against exact queries: right signs away from the surface and within half a
+	// step of the exact distance in the band
+	const char* names[2] = { "data\\sphere.obj", "data\\bunny.obj" };
+	const double steps[2] = { 0.02, 2.4 / 128 };
+	for (int m = 0; m < 2; ++m)
+	{
+		BGAL::_ManifoldModel model(names[m]);
+		model.initialization_PQP_();
+		const double step = steps[m];
+		BGAL::_Signed_Distance_Grid grid(model, step);
+		int wrong = 0;
+		double band_error = 0;
+		for (int i = 0; i < 1000; ++i)
+		{
+			BGAL::_Point3 p(BGAL::_BOC::rand_() * 2.4 - 1.2, BGAL::_BOC::rand_() * 2.4 - 1.2, BGAL::_BOC::rand_() * 2.4 - 1.2);
+			double exact = model.signed_distance_(p);
+			double value = grid.sample_(p);
+			if (fabs(exact) > 2 * step && (exact < 0) != (value < 0))
+				++wrong;
+			if (fabs(exact) < 2 * step)
+				band_error = std::max(band_error, fabs(exact - value));
+		}
+		std::cout << "wrong sign: " << wrong << "  band error < step / 2: " << (band_error < 0.5 * step)
+			<< "  sparse: " << (grid.number_dense_blocks_() * 512 < grid.size_(0) * grid.size_(1) * grid.size_(2)) << std::endl;
+		if (m == 0)
+			continue;
+		// the grid drives the reconstruction of a closed genus 0 mesh
+		std::pair<BGAL::_Point3, BGAL::_Point3> bbox(BGAL::_Point3(-1.2, -1.2, -1.2), BGAL::_Point3(1.2, 1.2, 1.2));
+		BGAL::_Marching_Tetrahedra MT(bbox, 6);
+		MT.set_method_(1);
+		std::function<std::pair<double, BGAL::_Point3>(BGAL::_Point3 p)> field = [&](BGAL::_Point3 p)
+		{
+			return grid.field_(p);
+		};
+		BGAL::_ManifoldModel mesh = MT.adaptive_reconstruction_(field);
+		int open = 0;
+		for (BGAL::_Edge_Iterator e_it = mesh.edge_begin(); e_it != mesh.edge_end(); ++e_it)
+		{
+			if ((*e_it)._id_reverse_edge < 0 || mesh.edge_((*e_it)._id_reverse_edge)._id_face < 0)
+				++open;
+		}
+		std::cout << "Euler: " << mesh.number_vertices_() - mesh.number_edges_() / 2 + mesh.number_faces_()
+			<< "  open edges: " << open << std::endl;
+	}
+}
+//***********************************
+
+//SiteSamplerTest
+void SiteSamplerTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return p.z() > 0 ? 3.0 : 1.0;
+	};
+	BGAL::_Site_Sampler sampler(model, rho);
+	std::vector<BGAL::_Point3> sites = sampler.sample_(20000, 7);
+	std::vector<BGAL::_Point3> again = sampler.sample_(20000, 7);
+	int up = 0, same = 0;
+	for (int i = 0; i < sites.size(); ++i)
+	{
+		if (sites[i].z() > 0)
+			++up;
+		if ((sites[i] - again[i]).length_() == 0)
+			++same;
+	}
+	std::cout << "upper half ~ 3/4: " << (fabs(up / 20000.0 - 0.75) < 0.02) << "  reproducible: " << (same == 20000) << std::endl;
+	BGAL::_Site_Sampler uniform(model);
+	std::vector<BGAL::_Point3> white = uniform.sample_(500, 3);
+	std::vector<BGAL::_Point3> blue = uniform.sample_blue_noise_(500, 3);
+	auto min_distance = [](const std::vector<BGAL::_Point3>& pts)
+	{
+		double d = std::numeric_limits<double>::max();
+		for (int i = 0; i < pts.size(); ++i)
+		{
+			for (int j = i + 1; j < pts.size(); ++j)
+			{
+				d = std::min(d, (pts[i] - pts[j]).length_());
+			}
+		}
+		return d;
+	};
+	std::cout << "blue noise: " << blue.size() << "  spacing x10: " << (min_distance(blue) > 10 * min_distance(white)) << std::endl;
+}
+//***********************************
+
 //Tessellation3DTest
 void Tessellation3DTest()
 {
@@ -441,6 +949,164 @@ void Tessellation3DTest()
 }
 //***********************************
 
+//Side3DBatchTest
+void Side3DBatchTest()
+{
+	const int n = 2000;
+	const double sphere[6][3] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+	// the first half is random; in the second the sites lie on the unit sphere and the
+	// queries pass through its center, so every predicate there is exactly zero
+	std::vector<double> q1(11 * n), q2(18 * n), q3(25 * n);
+	for (int i = 0; i < n; ++i)
+	{
+		double* a = &q1[11 * i];
+		double* b = &q2[18 * i];
+		double* c = &q3[25 * i];
+		if (i < n / 2)
+		{
+			for (int j = 0; j < 11; ++j)
+				a[j] = BGAL::_BOC::rand_();
+			for (int j = 0; j < 18; ++j)
+				b[j] = BGAL::_BOC::rand_();
+			for (int j = 0; j < 25; ++j)
+				c[j] = BGAL::_BOC::rand_();
+			continue;
+		}
+		const double* s[4];
+		double u[3], v[3];
+		for (int j = 0; j < 4; ++j)
+			s[j] = sphere[(int)(6 * BGAL::_BOC::rand_()) % 6];
+		for (int j = 0; j < 3; ++j)
+		{
+			u[j] = (int)(3 * BGAL::_BOC::rand_()) % 3 - 1;
+			v[j] = (int)(3 * BGAL::_BOC::rand_()) % 3 - 1;
+		}
+		const double t = (int)(3 * BGAL::_BOC::rand_()) % 3 - 1;
+		std::fill(a, a + 11, 0.0);
+		std::fill(b, b + 18, 0.0);
+		std::fill(c, c + 25, 0.0);
+		for (int j = 0; j < 3; ++j)
+		{
+			a[j] = s[0][j];
+			a[3 + j] = s[1][j];
+			a[8 + j] = t * (s[0][j] + s[1][j]);
+			b[j] = s[0][j];
+			b[3 + j] = s[1][j];
+			b[6 + j] = s[2][j];
+			b[12 + j] = u[j];
+			b[15 + j] = -u[j];
+			c[j] = s[0][j];
+			c[3 + j] = s[1][j];
+			c[6 + j] = s[2][j];
+			c[9 + j] = s[3][j];
+			c[16 + j] = u[j];
+			c[19 + j] = v[j];
+			c[22 + j] = -u[j] - v[j];
+		}
+	}
+	std::vector<BGAL::_BOC::_Sign> r1(n), r2(n), r3(n);
+	BGAL::_Side3D::side1_batch_(n, q1.data(), r1.data());
+	BGAL::_Side3D::side2_batch_(n, q2.data(), r2.data());
+	BGAL::_Side3D::side3_batch_(n, q3.data(), r3.data());
+	int mismatches = 0;
+	int zeros[3] = { 0, 0, 0 };
+	for (int i = 0; i < n; ++i)
+	{
+		const double* a = &q1[11 * i];
+		const double* b = &q2[18 * i];
+		const double* c = &q3[25 * i];
+		BGAL::_BOC::_Sign s1 = BGAL::_Side3D::side1_(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], a[10]);
+		BGAL::_BOC::_Sign s2 = BGAL::_Side3D::side2_(b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7], b[8],
+			b[9], b[10], b[11], b[12], b[13], b[14], b[15], b[16], b[17]);
+		BGAL::_BOC::_Sign s3 = BGAL::_Side3D::side3_(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8], c[9], c[10], c[11],
+			c[12], c[13], c[14], c[15], c[16], c[17], c[18], c[19], c[20], c[21], c[22], c[23], c[24]);
+		mismatches += (s1 != r1[i]) + (s2 != r2[i]) + (s3 != r3[i]);
+		zeros[0] += s1 == BGAL::_BOC::_Sign::ZerO;
+		zeros[1] += s2 == BGAL::_BOC::_Sign::ZerO;
+		zeros[2] += s3 == BGAL::_BOC::_Sign::ZerO;
+	}
+	std::cout << "mismatches: " << mismatches << "  degenerate: " << (zeros[0] > 0 && zeros[1] > 0 && zeros[2] > 0) << std::endl;
+}
+//***********************************
+
+//RDTTest
+void RDTTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	int num = 20;
+	std::vector<BGAL::_Point3> sites;
+	for (int i = 0; i < num; ++i)
+	{
+		double phi = BGAL::_BOC::PI() * 2.0 * BGAL::_BOC::rand_();
+		double theta = BGAL::_BOC::PI() * BGAL::_BOC::rand_();
+		sites.push_back(BGAL::_Point3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)));
+	}
+	std::vector<double> weights(num, 0);
+	BGAL::_Restricted_Tessellation3D RVD(model, sites, weights);
+	const std::vector<int>& faces = RVD.get_rdt_faces_();
+	const int num_faces = RVD.number_rdt_faces_();
+	// the RDT of a sphere is a closed triangulation: 2 * num - 4 triangles and every
+	// directed edge once, its reverse in the neighbouring triangle
+	std::map<std::pair<int, int>, int> edges;
+	for (int f = 0; f < num_faces; ++f)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			++edges[std::make_pair(faces[3 * f + j], faces[3 * f + (j + 1) % 3])];
+		}
+	}
+	bool manifold = true;
+	for (auto& e : edges)
+	{
+		auto r = edges.find(std::make_pair(e.first.second, e.first.first));
+		manifold = manifold && e.second == 1 && r != edges.end() && r->second == 1;
+	}
+	RVD.save_rdt_("data\\RDTTest.ply");
+	std::ifstream in("data\\RDTTest.ply", std::ios::binary);
+	std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	const size_t body = content.find("end_header\n") + 11;
+	const bool ply = content.size() - body == num * 3 * sizeof(double) + num_faces * (1 + 3 * sizeof(int));
+	std::cout << "faces: " << (num_faces == 2 * num - 4) << "  manifold: " << manifold << "  ply: " << ply << std::endl;
+}
+//***********************************
+
+//SkeletonTest
+void SkeletonTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	int num = 100;
+	std::vector<BGAL::_Point3> sites;
+	for (int i = 0; i < num; ++i)
+	{
+		double phi = BGAL::_BOC::PI() * 2.0 * BGAL::_BOC::rand_();
+		double theta = BGAL::_BOC::PI() * BGAL::_BOC::rand_();
+		sites.push_back(BGAL::_Point3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)));
+	}
+	std::vector<double> weights(num, 0);
+	BGAL::_Restricted_Tessellation3D RVD(model, sites, weights);
+	const BGAL::_Tessellation3D_Skeleton& skeleton = RVD.get_skeleton_();
+	const std::vector<std::map<int, std::vector<std::pair<int, int>>>>& edges = RVD.get_edges_();
+	// rows sorted by index without the site itself, j in row i exactly when i is in row j,
+	// and every pair of cells sharing an edge on the surface among them
+	bool sorted = true, symmetric = true, restricted = true;
+	for (int i = 0; i < num; ++i)
+	{
+		BGAL::_Tessellation3D_Skeleton::_Neighbours row = skeleton.neight_(i);
+		for (const int* it = row.begin(); it != row.end(); ++it)
+		{
+			sorted = sorted && *it != i && (it == row.begin() || *(it - 1) < *it);
+			BGAL::_Tessellation3D_Skeleton::_Neighbours back = skeleton.neight_(*it);
+			symmetric = symmetric && std::binary_search(back.begin(), back.end(), i);
+		}
+		for (auto& e : edges[i])
+		{
+			restricted = restricted && std::binary_search(row.begin(), row.end(), e.first);
+		}
+	}
+	std::cout << "sorted: " << sorted << "  symmetric: " << symmetric << "  restricted: " << restricted << std::endl;
+}
+//***********************************
+
 ////ReadFileTest
 //void ReadFileTest()
 //{
@@ -524,6 +1190,225 @@ void ICPTest()
 }
 //***********************************
 
+//FeatureDetectionTest
+void FeatureDetectionTest()
+{
+	// two planes meeting at a crease along x = 0
+	std::vector<Eigen::Vector3d> pts, nors;
+	for (int i = -20; i <= 20; ++i)
+	{
+		for (int j = -20; j <= 20; ++j)
+		{
+			double x = i * 0.05, y = j * 0.05;
+			pts.push_back(Eigen::Vector3d(x, y, -fabs(x)));
+			nors.push_back(Eigen::Vector3d(x > 0 ? 1 : (x < 0 ? -1 : 0), 0, 1).normalized());
+		}
+	}
+	std::vector<int> offsets(1, 0), indices;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		for (int j = 0; j < pts.size(); ++j)
+		{
+			if ((pts[i] - pts[j]).norm() < 0.16)
+				indices.push_back(j);
+		}
+		offsets.push_back(indices.size());
+	}
+	BGAL::_Feature_Detection detector;
+	detector.detect_(nors, offsets, indices);
+	int num_feature = 0, num_wrong = 0;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		if (detector.get_is_valid_()[i] && !detector.get_is_smooth_()[i])
+		{
+			++num_feature;
+			if (fabs(pts[i].x()) > 0.16)
+				++num_wrong;
+		}
+	}
+	std::cout << "feature points: " << num_feature << "  far from the crease: " << num_wrong << std::endl;
+}
+//***********************************
+
+//FeatureProjectionTest
+void FeatureProjectionTest()
+{
+	// points near the crease x = 0 of z = -|x| move onto the crease line
+	std::vector<Eigen::Vector3d> pts, nors;
+	std::vector<int> is_candidate;
+	for (int i = -20; i <= 20; ++i)
+	{
+		for (int j = -20; j <= 20; ++j)
+		{
+			double x = i * 0.05 + 0.013, y = j * 0.05;
+			pts.push_back(Eigen::Vector3d(x, y, -fabs(x)));
+			nors.push_back(Eigen::Vector3d(x > 0 ? 1 : -1, 0, 1).normalized());
+			is_candidate.push_back(fabs(x) < 0.06 ? 1 : 0);
+		}
+	}
+	std::vector<int> offsets(1, 0), indices;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		for (int j = 0; j < pts.size(); ++j)
+		{
+			if ((pts[i] - pts[j]).norm() < 0.16)
+				indices.push_back(j);
+		}
+		offsets.push_back(indices.size());
+	}
+	BGAL::_Feature_Projection projector;
+	projector._parameter.mu = 1e-6;
+	projector.project_(pts, nors, offsets, indices, is_candidate);
+	int num_wrong = 0;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		if (projector.get_is_projected_()[i])
+		{
+			const Eigen::Vector3d& p = projector.get_points_()[i];
+			if (fabs(p.x()) > 1e-6 || fabs(p.z()) > 1e-6 || fabs(p.y() - pts[i].y()) > 1e-6)
+				++num_wrong;
+		}
+	}
+	std::cout << "projected points: " << projector.number_projected_() << "  off the crease: " << num_wrong
+		<< "  degenerate: " << projector.number_degenerate_() << std::endl;
+}
+//***********************************
+
+//NeighborhoodTest
+void NeighborhoodTest()
+{
+	std::vector<Eigen::Vector3d> pts;
+	for (int i = 0; i < 500; ++i)
+	{
+		double t = i * 0.37;
+		pts.push_back(Eigen::Vector3d(sin(t) * (1 + 0.3 * cos(3.1 * t)), cos(1.3 * t), 0.5 * sin(0.7 * t) * (i % 7) / 7.0));
+	}
+	BGAL::_Neighborhood nbh;
+	nbh._parameter.k = 8;
+	nbh._parameter.radius = 0.25;
+	nbh.build_(pts);
+	int num_wrong = 0;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		std::vector<double> d;
+		for (int j = 0; j < pts.size(); ++j)
+		{
+			d.push_back((pts[i] - pts[j]).squaredNorm());
+		}
+		std::vector<double> sd = d;
+		std::sort(sd.begin(), sd.end());
+		double r2 = std::max(0.25 * 0.25, sd[7]);
+		std::vector<int> expect, got(nbh.neighbors_(i), nbh.neighbors_(i) + nbh.number_neighbors_(i));
+		for (int j = 0; j < pts.size(); ++j)
+		{
+			if (d[j] <= r2)
+				expect.push_back(j);
+		}
+		std::sort(got.begin(), got.end());
+		if (got != expect)
+			++num_wrong;
+	}
+	std::cout << "min: " << nbh.min_neighbors_() << "  max: " << nbh.max_neighbors_()
+		<< "  mean: " << nbh.mean_neighbors_() << "  wrong: " << num_wrong << std::endl;
+	// the same radius picked by a rule from the 8-NN distances, in one build
+	std::vector<double> knn_radii;
+	BGAL::_Neighborhood ruled;
+	ruled._parameter.k = 8;
+	ruled._parameter.radius_rule = [&](const std::vector<double>& radii)
+	{
+		knn_radii = radii;
+		return 0.25;
+	};
+	ruled.build_(pts);
+	bool same_radii = knn_radii.size() == pts.size();
+	for (int i = 0; same_radii && i < pts.size(); ++i)
+	{
+		std::vector<double> d;
+		for (int j = 0; j < pts.size(); ++j)
+		{
+			d.push_back((pts[i] - pts[j]).squaredNorm());
+		}
+		std::nth_element(d.begin(), d.begin() + 7, d.end());
+		same_radii = fabs(knn_radii[i] - sqrt(d[7])) < 1e-12;
+	}
+	std::cout << "rule: " << (ruled.get_offsets_() == nbh.get_offsets_() && ruled.get_indices_() == nbh.get_indices_())
+		<< "  k-NN radii: " << same_radii << std::endl;
+}
+//***********************************
+
+//PointCloudDenoiserTest
+void PointCloudDenoiserTest()
+{
+	// noisy samples of the crease z = -|x| with perturbed normals
+	std::vector<Eigen::Vector3d> pts, nors;
+	for (int i = 0; i < 60; ++i)
+	{
+		for (int j = 0; j < 60; ++j)
+		{
+			double x = -1 + 2.0 * i / 59 + 0.003 * sin(7.0 * j), y = -1 + 2.0 * j / 59;
+			double noise = 0.01 * sin(12.9898 * i + 78.233 * j) * cos(4.1 * i * j);
+			pts.push_back(Eigen::Vector3d(x, y, -fabs(x) + noise));
+			nors.push_back(Eigen::Vector3d(x > 0 ? 1 : -1, 0.2 * sin(3.0 * i + j), 1).normalized());
+		}
+	}
+	BGAL::_PointCloudDenoiser denoiser;
+	denoiser.denoise_(pts, nors);
+	double err0 = 0, err1 = 0, nerr = 0;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		const Eigen::Vector3d& p = denoiser.get_points_()[i];
+		err0 += pow(pts[i].z() + fabs(pts[i].x()), 2);
+		err1 += pow(p.z() + fabs(p.x()), 2);
+		nerr = std::max(nerr, (denoiser.get_normals_()[i]
+			- Eigen::Vector3d(pts[i].x() > 0 ? 1 : -1, 0, 1).normalized()).norm());
+	}
+	std::cout << "rms error reduced 5x: " << (sqrt(err1) * 5 < sqrt(err0))
+		<< "  max normal error < 0.1: " << (nerr < 0.1) << std::endl;
+}
+//***********************************
+
+//PointCloudIOTest
+void PointCloudIOTest()
+{
+	std::vector<Eigen::Vector3d> pts, nors;
+	for (int i = 0; i < 1000; ++i)
+	{
+		pts.push_back(Eigen::Vector3d(sin(0.1 * i), cos(0.3 * i) * i, 1e-3 * i));
+		nors.push_back(pts.back().normalized());
+	}
+	std::vector<Eigen::Vector3d> rpts, rnors;
+	BGAL::_PointCloud_IO::write_("PointCloudIOTest.xyz", pts, nors);
+	BGAL::_PointCloud_IO::read_("PointCloudIOTest.xyz", rpts, rnors);
+	double err = 0;
+	for (int i = 0; i < pts.size(); ++i)
+	{
+		err = std::max(err, (rpts[i] - pts[i]).norm() + (rnors[i] - nors[i]).norm());
+	}
+	std::cout << "xyz: " << rpts.size() << " " << rnors.size() << "  error < 1e-8: " << (err < 1e-8) << std::endl;
+	BGAL::_PointCloud_Writer writer("PointCloudIOTest.ply", true);
+	for (int i = 0; i < pts.size(); i += 300)
+	{
+		std::vector<Eigen::Vector3d> cp(pts.begin() + i, pts.begin() + std::min<int>(i + 300, pts.size()));
+		std::vector<Eigen::Vector3d> cn(nors.begin() + i, nors.begin() + std::min<int>(i + 300, nors.size()));
+		writer.write_(cp, cn);
+	}
+	writer.close_();
+	BGAL::_PointCloud_Reader reader("PointCloudIOTest.ply", 4096);
+	int num = 0, chunks = 0, wrong = 0;
+	while (int k = reader.read_(rpts, rnors))
+	{
+		for (int i = 0; i < k; ++i)
+		{
+			if (rpts[i] != pts[num + i] || rnors[i] != nors[num + i])
+				++wrong;
+		}
+		num += k;
+		++chunks;
+	}
+	std::cout << "ply: " << num << "  chunks: " << chunks << "  wrong: " << wrong << std::endl;
+}
+//***********************************
+
 //MarchingTetrahedraTest
 void MarchingTetrahedraTest()
 {
@@ -561,6 +1446,28 @@ void MarchingTetrahedraTest()
 }
 //***********************************
 
+//AdaptiveMarchingTetrahedraTest
+void AdaptiveMarchingTetrahedraTest()
+{
+	std::pair<BGAL::_Point3, BGAL::_Point3> bbox(BGAL::_Point3(-1.2, -1.2, -1.2), BGAL::_Point3(1.2, 1.2, 1.2));
+	BGAL::_Marching_Tetrahedra MT(bbox, 6);
+	MT.set_method_(1);
+	std::function<std::pair<double, BGAL::_Point3>(BGAL::_Point3 p)> sphere = [](BGAL::_Point3 p)
+	{
+		return std::pair<double, BGAL::_Point3>(p.length_() - 1, p);
+	};
+	BGAL::_ManifoldModel model = MT.adaptive_reconstruction_(sphere);
+	int open = 0;
+	for (BGAL::_Edge_Iterator e_it = model.edge_begin(); e_it != model.edge_end(); ++e_it)
+	{
+		if ((*e_it)._id_reverse_edge < 0 || model.edge_((*e_it)._id_reverse_edge)._id_face < 0)
+			++open;
+	}
+	std::cout << "Euler: " << model.number_vertices_() - model.number_edges_() / 2 + model.number_faces_()
+		<< "  open edges: " << open << "  evaluations < 40%: " << (MT.number_evaluations_() < 0.4 * 65 * 65 * 65) << std::endl;
+}
+//***********************************
+
 void GeodesicDijkstraTest()
 {
 	BGAL::_ManifoldModel model("data\\sphere.obj");
@@ -634,6 +1541,43 @@ void CPDTest()
 	out.close();
 }
 
+//CPDWeightsTest
+void CPDWeightsTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	BGAL::_CPD3D cpd(model, rho, para);
+	cpd._omt_eps = 1e-6;
+	int num = 200;
+	BGAL::_Site_Sampler sampler(model);
+	std::vector<BGAL::_Point3> sites = sampler.sample_(num);
+	// every other cell twice as large
+	std::vector<double> capacity(num);
+	for (int i = 0; i < num; ++i)
+		capacity[i] = sampler.area_() / (1.5 * num) * (i % 2 == 0 ? 2 : 1);
+	cpd.calculate_weights_(capacity, sites);
+	const BGAL::_Restricted_Tessellation3D& RPD = cpd.get_RPD();
+	const std::vector<std::vector<std::tuple<int, int, int>>>& cells = RPD.get_cells_();
+	double error = 0;
+	for (int i = 0; i < num; ++i)
+	{
+		double cal_mass = 0;
+		for (int j = 0; j < cells[i].size(); ++j)
+		{
+			BGAL::_Triangle3 tri(RPD.vertex_(std::get<0>(cells[i][j])), RPD.vertex_(std::get<1>(cells[i][j])), RPD.vertex_(std::get<2>(cells[i][j])));
+			cal_mass += tri.area_();
+		}
+		error = std::max(error, fabs(cal_mass - capacity[i]) / capacity[i]);
+	}
+	std::cout << "hidden: " << RPD.number_hidden_point_() << "  capacities met: " << (error < 1e-3) << std::endl;
+}
+//***********************************
+
 void CVT3DTest()
 {
 	BGAL::_ManifoldModel model("data\\bunny.obj");
@@ -670,12 +1614,74 @@ void CVT3DTest()
 	out.close();
 }
 
+//VolumeCVTTest
+void VolumeCVTTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 1e-6;
+	para.max_iteration = 30;
+	BGAL::_Volume_CVT3D cvt(model, rho, para);
+	cvt.calculate_(100);
+	const std::vector<BGAL::_Point3>& sites = cvt.get_sites();
+	const BGAL::_Clipped_Tessellation3D& CVD = cvt.get_CVD();
+	double volume = 0;
+	bool inside = true;
+	for (int i = 0; i < sites.size(); ++i)
+	{
+		volume += CVD.volume_(i);
+		inside = inside && CVD.is_inside_(sites[i]);
+	}
+	std::cout << "volume: " << (fabs(volume - CVD.domain_volume_()) < 1e-6 * CVD.domain_volume_()) << "  inside: " << inside << std::endl;
+}
+//***********************************
+
+//CapVTTest
+void CapVTTest()
+{
+	BGAL::_ManifoldModel model("data\\sphere.obj");
+	model.initialization_PQP_();
+	std::function<double(BGAL::_Point3& p)> rho = [](BGAL::_Point3& p)
+	{
+		return 1;
+	};
+	BGAL::_LBFGS::_Parameter para;
+	para.is_show = false;
+	para.epsilon = 1e-6;
+	para.max_iteration = 50;
+	BGAL::_CVT3D cvt(model, rho, para);
+	std::vector<BGAL::_Point3> sites = BGAL::_Site_Sampler(model).sample_(200);
+	std::vector<double> before, after;
+	cvt._RVD.calculate_(sites);
+	cvt.cell_areas_(before);
+	cvt.calculate_CapVT(sites);
+	cvt.cell_areas_(after);
+	auto spread = [](const std::vector<double>& areas)
+	{
+		double mean = 0, res = 0;
+		for (auto a : areas)
+			mean += a / areas.size();
+		for (auto a : areas)
+			res = std::max(res, fabs(a - mean) / mean);
+		return res;
+	};
+	std::cout << "spread reduced: " << (spread(after) < 0.5 * spread(before)) << std::endl;
+}
+//***********************************
+
 /*************************************
 
 Expect:
 ====================BOCSignTest
 1
 0
+====================ProfilerTest
+nested: 1  events: 1000
 ====================LinearSystemTest
 2
 2
@@ -687,15 +1693,24 @@ false
 false
 ====================LBFGSTest
 0       0       0.001   172.8   7465
-1       5       0.002   140.8   4956.19
-2       6       0.003   3.17764e-14     2.52435e-28
+1       3       0.002   130.8   4277.19
+2       4       0.003   0       0
 reach the gradient tolerance
 1
 1
 n: 2
+====================LBFGSCallbackTest
+converged: 1  reports: 1  decreasing: 1
+stopped at: 5
+====================LineSearchTest
+converged: 1 1  fewer evaluations: 1
+====================LBFGSCheckpointTest
+resumed at: 10  same result: 1
 ====================BaseShapeTest
 yes!
 20
+====================PreparedPolygonTest
+wrong: 0 0 0
 ====================Tessellation2DTest
 ====================CVTLBFGSTest
 0       0       0.007   0.00829834      0.00377827
@@ -725,10 +1740,35 @@ reach the gradient tolerance
 ====================DrawTest
 ====================IntegralTest
 0.5
+====================PolygonIntegralTest
+area: 3  agree: 1  convex boundary: 0
+====================QuadratureTest
+wrong rules: 0  cube: 1 0.333333
 ====================ModelTest
 V number: 642
 F number: 1280
+====================SimplificationTest
+F number: 320  Euler: 2  open edges: 0
+====================ContouringTest
+loops: 1  closed: 1  one loop per level: 1  boundary: 1
+====================ConvexCellTest
+volume: 1  closed cells: 200
+====================ConvexCellLatticeTest
+volume: 1  closed cells: 125
+====================SDFGridTest
+wrong sign: 0  band error < step / 2: 1  sparse: 1
+wrong sign: 0  band error < step / 2: 1  sparse: 1
+Euler: 2  open edges: 0
+====================SiteSamplerTest
+upper half ~ 3/4: 1  reproducible: 1
+blue noise: 500  spacing x10: 1
 ====================Tessellation3DTest
+====================Side3DBatchTest
+mismatches: 0  degenerate: 1
+====================RDTTest
+faces: 1  manifold: 1  ply: 1
+====================SkeletonTest
+sorted: 1  symmetric: 1  restricted: 1
 ====================KDTreeTest
 61 0.0051334350000000004283 -0.95469340000000002533 0.18068470000000000364
 0.16776960319175260317    0.16776960319175260317
@@ -742,7 +1782,21 @@ my:  61 0.16776960319175260317
  5.5511151231257827021e-16     0.99999999999999933387  2.0949350896789406863e-16 -4.7184478546569152968e-16
  1.3444106938820254982e-15  1.0451708942760262744e-16      1.0000000000000013323 -9.7144514654701197287e-16
                          0                          0                          0                          1
+====================FeatureDetectionTest
+feature points: 135  far from the crease: 0
+====================FeatureProjectionTest
+projected points: 82  off the crease: 0  degenerate: 0
+====================NeighborhoodTest
+min: 8  max: 24  mean: 10.732  wrong: 0
+rule: 1  k-NN radii: 1
+====================PointCloudDenoiserTest
+rms error reduced 5x: 1  max normal error < 0.1: 1
+====================PointCloudIOTest
+xyz: 1000 1000  error < 1e-8: 1
+ply: 1000  chunks: 12  wrong: 0
 ====================MarchingTetrahedraTest
+====================AdaptiveMarchingTetrahedraTest
+Euler: 2  open edges: 0  evaluations < 40%: 1
 ====================GeodesicDijkstraTest
 ====================CPDTest
 0       0       2.8559999999999998721   0.97077838761131618472  1.5745422097489745195
@@ -863,6 +1917,12 @@ mass - capacity
 0.25013060746784665511  0.25012984804989535359  7.5941795130152200954e-07
 0.25013048499741385999  0.25012984804989535359  6.3694751850640329849e-07
 0.25013061963995819603  0.25012984804989535359  7.7159006284244213703e-07
+====================CPDWeightsTest
+hidden: 0  capacities met: 1
+====================VolumeCVTTest
+volume: 1  inside: 1
+====================CapVTTest
+spread reduced: 1
 successful!
 
 *******************************************/
@@ -874,14 +1934,24 @@ int alltest()
 	//GraphCutsTest();
 	std::cout << "====================BOCSignTest" << std::endl;
 	BOCSignTest();	
+	std::cout << "====================ProfilerTest" << std::endl;
+	ProfilerTest();
 	std::cout << "====================LinearSystemTest" << std::endl;
 	LinearSystemTest();
 	std::cout << "====================ALGLIBTest" << std::endl;
 	ALGLIBTest();
 	std::cout << "====================LBFGSTest" << std::endl;
 	LBFGSTest();
+	std::cout << "====================LBFGSCallbackTest" << std::endl;
+	LBFGSCallbackTest();
+	std::cout << "====================LineSearchTest" << std::endl;
+	LineSearchTest();
+	std::cout << "====================LBFGSCheckpointTest" << std::endl;
+	LBFGSCheckpointTest();
 	std::cout << "====================BaseShapeTest" << std::endl;
 	BaseShapeTest();
+	std::cout << "====================PreparedPolygonTest" << std::endl;
+	PreparedPolygonTest();
 	std::cout << "====================Tessellation2DTest" << std::endl;
 	Tessellation2DTest();
 	std::cout << "====================CVTLBFGSTest" << std::endl;
@@ -890,24 +1960,64 @@ int alltest()
 	DrawTest();
 	std::cout << "====================IntegralTest" << std::endl;
 	IntegralTest();
+	std::cout << "====================PolygonIntegralTest" << std::endl;
+	PolygonIntegralTest();
+	std::cout << "====================QuadratureTest" << std::endl;
+	QuadratureTest();
 	std::cout << "====================ModelTest" << std::endl;
 	ModelTest();
+	std::cout << "====================SimplificationTest" << std::endl;
+	SimplificationTest();
+	std::cout << "====================ContouringTest" << std::endl;
+	ContouringTest();
+	std::cout << "====================ConvexCellTest" << std::endl;
+	ConvexCellTest();
+	std::cout << "====================ConvexCellLatticeTest" << std::endl;
+	ConvexCellLatticeTest();
+	std::cout << "====================SDFGridTest" << std::endl;
+	SDFGridTest();
+	std::cout << "====================SiteSamplerTest" << std::endl;
+	SiteSamplerTest();
 	std::cout << "====================Tessellation3DTest" << std::endl;
 	Tessellation3DTest();
+	std::cout << "====================Side3DBatchTest" << std::endl;
+	Side3DBatchTest();
+	std::cout << "====================RDTTest" << std::endl;
+	RDTTest();
+	std::cout << "====================SkeletonTest" << std::endl;
+	SkeletonTest();
 	//std::cout << "====================ReadFileTest" << std::endl;
 	//ReadFileTest();
 	std::cout << "====================KDTreeTest" << std::endl;
 	KDTreeTest();
 	std::cout << "====================ICPTest" << std::endl;
 	ICPTest();
+	std::cout << "====================FeatureDetectionTest" << std::endl;
+	FeatureDetectionTest();
+	std::cout << "====================FeatureProjectionTest" << std::endl;
+	FeatureProjectionTest();
+	std::cout << "====================NeighborhoodTest" << std::endl;
+	NeighborhoodTest();
+	std::cout << "====================PointCloudDenoiserTest" << std::endl;
+	PointCloudDenoiserTest();
+	std::cout << "====================PointCloudIOTest" << std::endl;
+	PointCloudIOTest();
 	std::cout << "====================MarchingTetrahedraTest" << std::endl;
 	MarchingTetrahedraTest();
+	std::cout << "====================AdaptiveMarchingTetrahedraTest" << std::endl;
+	AdaptiveMarchingTetrahedraTest();
 	std::cout << "====================GeodesicDijkstraTest" << std::endl;
 	GeodesicDijkstraTest();
 	std::cout << "====================CPDTest" << std::endl;
 	CPDTest();
+	std::cout << "====================CPDWeightsTest" << std::endl;
+	CPDWeightsTest();
 	std::cout << "====================CVT3DTest" << std::endl;
 	CVT3DTest();
+	std::cout << "====================VolumeCVTTest" << std::endl;
+	VolumeCVTTest();
+	std::cout << "====================CapVTTest" << std::endl;
+	CapVTTest();
 	std::cout << "successful!" << std::endl;
 	return 0;
 }